@@ -0,0 +1,402 @@
+#include "bench.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <new>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+// ============================================================================
+// CONTAGEM DE ALOCAÇÕES
+// ============================================================================
+// Substitui o operator new global: cada alocação incrementa um contador.
+// Os kernels medidos rodam em ISR/tasks de tempo real e não devem alocar.
+
+namespace {
+std::atomic<uint64_t> gAllocations{0};
+}  // namespace
+
+void* operator new(size_t size) {
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (p == nullptr) abort();
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace bench {
+namespace {
+
+constexpr size_t kMaxBenchmarks = 48;
+
+struct Entry {
+  const char* name;
+  BenchFn fn;
+};
+
+Entry gEntries[kMaxBenchmarks];
+size_t gEntryCount = 0;
+
+constexpr size_t kMaxChecks = 32;
+
+struct CheckEntry {
+  const char* name;
+  CheckFn fn;
+};
+
+CheckEntry gChecks[kMaxChecks];
+size_t gCheckCount = 0;
+uint32_t gCheckFailures = 0;  // Falhas da verificação em execução
+
+void printLine(const char* line) {
+#ifdef ARDUINO
+  Serial.println(line);
+#else
+  printf("%s\n", line);
+  fflush(stdout);
+#endif
+}
+
+volatile uint32_t gSinkU32 = 0;
+volatile float gSinkF32 = 0.0f;
+
+// Nunca passa de 2^30 iterações por rodada
+constexpr uint32_t kMaxIterations = 1u << 30;
+
+}  // namespace
+
+Registration::Registration(const char* name, BenchFn fn) {
+  if (gEntryCount < kMaxBenchmarks) {
+    gEntries[gEntryCount++] = Entry{name, fn};
+  }
+}
+
+CheckRegistration::CheckRegistration(const char* name, CheckFn fn) {
+  if (gCheckCount < kMaxChecks) {
+    gChecks[gCheckCount++] = CheckEntry{name, fn};
+  }
+}
+
+void consume(uint32_t value) { gSinkU32 = value; }
+void consume(float value) { gSinkF32 = value; }
+
+uint64_t nowNs() {
+#ifdef ARDUINO
+  return static_cast<uint64_t>(esp_timer_get_time()) * 1000u;
+#else
+  using namespace std::chrono;
+  return static_cast<uint64_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+uint64_t allocationCount() {
+  return gAllocations.load(std::memory_order_relaxed);
+}
+
+uint32_t runAll(const char* filter, uint64_t minTimeNs, uint32_t repetitions,
+                void (*report)(const Result&)) {
+  uint32_t executed = 0;
+  for (size_t i = 0; i < gEntryCount; ++i) {
+    const Entry& entry = gEntries[i];
+    if (filter != nullptr && strstr(entry.name, filter) == nullptr) continue;
+
+    // Aquecimento (caches, estado estático)
+    entry.fn(16);
+
+    // Calibração: dobra as iterações até a rodada durar pelo menos minTimeNs
+    uint32_t iterations = 1;
+    uint64_t elapsed = 0;
+    uint64_t allocs = 0;
+    for (;;) {
+      const uint64_t allocsBefore = allocationCount();
+      const uint64_t start = nowNs();
+      entry.fn(iterations);
+      elapsed = nowNs() - start;
+      allocs = allocationCount() - allocsBefore;
+      if (elapsed >= minTimeNs || iterations >= kMaxIterations) break;
+
+      // Estima o próximo tamanho; no mínimo dobra, no máximo x10
+      uint64_t next = static_cast<uint64_t>(iterations) * 2;
+      if (elapsed > 0) {
+        const uint64_t projected = static_cast<uint64_t>(iterations) * minTimeNs * 12 / 10 / elapsed;
+        if (projected > next) next = projected;
+      }
+      if (next > static_cast<uint64_t>(iterations) * 10) next = static_cast<uint64_t>(iterations) * 10;
+      iterations = (next > kMaxIterations) ? kMaxIterations : static_cast<uint32_t>(next);
+    }
+
+    // Repetições com o mesmo nº de iterações: fica a mais rápida (menos ruído
+    // de escalonamento do SO); alocações devem ser iguais em todas
+    for (uint32_t r = 1; r < repetitions; ++r) {
+      const uint64_t start = nowNs();
+      entry.fn(iterations);
+      const uint64_t again = nowNs() - start;
+      if (again < elapsed) elapsed = again;
+    }
+
+    Result result{};
+    result.name = entry.name;
+    result.iterations = iterations;
+    result.nsPerOp = static_cast<double>(elapsed) / iterations;
+    result.allocsPerOp = static_cast<double>(allocs) / iterations;
+    report(result);
+    ++executed;
+  }
+  return executed;
+}
+
+bool expect(bool ok, const char* format, ...) {
+  if (ok) return true;
+  ++gCheckFailures;
+  char message[160];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(message, sizeof(message), format, args);
+  va_end(args);
+  char line[176];
+  snprintf(line, sizeof(line), "# %s", message);
+  printLine(line);
+  return false;
+}
+
+uint32_t runChecks(const char* filter) {
+  uint32_t failed = 0;
+  for (size_t i = 0; i < gCheckCount; ++i) {
+    const CheckEntry& entry = gChecks[i];
+    if (filter != nullptr && strstr(entry.name, filter) == nullptr) continue;
+    gCheckFailures = 0;
+    entry.fn();
+    char line[96];
+    snprintf(line, sizeof(line), "check,%s,%s", entry.name, gCheckFailures == 0 ? "ok" : "FAIL");
+    printLine(line);
+    if (gCheckFailures > 0) ++failed;
+  }
+  return failed;
+}
+
+}  // namespace bench
+
+
+// ============================================================================
+// PONTO DE ENTRADA
+// ============================================================================
+
+namespace {
+
+void printCsvHeader() {
+#ifdef ARDUINO
+  Serial.println("benchmark,ns_per_op,allocs_per_op,iterations");
+#else
+  printf("benchmark,ns_per_op,allocs_per_op,iterations\n");
+#endif
+}
+
+void printCsvRow(const bench::Result& r) {
+  char line[128];
+  snprintf(line, sizeof(line), "%s,%.3f,%.4f,%lu", r.name, r.nsPerOp, r.allocsPerOp,
+           static_cast<unsigned long>(r.iterations));
+#ifdef ARDUINO
+  Serial.println(line);
+#else
+  printf("%s\n", line);
+  fflush(stdout);
+#endif
+}
+
+}  // namespace
+
+#ifdef ARDUINO
+
+void benchTargetExtras();  // bench_target.cpp
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+  printCsvHeader();
+  bench::runAll(nullptr, 100000000ull, 3, printCsvRow);  // 100 ms por benchmark
+  benchTargetExtras();
+  bench::runChecks(nullptr);
+  Serial.println("# done");
+}
+
+void loop() {
+  delay(1000);
+}
+
+#else
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Modo de comparação com a linha de base
+// ----------------------------------------------------------------------------
+
+struct BaselineRow {
+  char name[64];
+  double nsPerOp;
+  double allocsPerOp;
+};
+
+constexpr size_t kMaxRows = 64;
+
+struct Table {
+  BaselineRow rows[kMaxRows];
+  size_t count = 0;
+
+  void add(const char* name, double ns, double allocs) {
+    if (count >= kMaxRows) return;
+    BaselineRow& row = rows[count++];
+    snprintf(row.name, sizeof(row.name), "%s", name);
+    row.nsPerOp = ns;
+    row.allocsPerOp = allocs;
+  }
+
+  const BaselineRow* find(const char* name) const {
+    for (size_t i = 0; i < count; ++i) {
+      if (strcmp(rows[i].name, name) == 0) return &rows[i];
+    }
+    return nullptr;
+  }
+};
+
+// Lê um CSV no formato de saída (cabeçalho e linhas com '#' são ignorados)
+bool loadCsv(const char* path, Table& table) {
+  FILE* f = fopen(path, "r");
+  if (f == nullptr) {
+    fprintf(stderr, "bench: cannot open %s\n", path);
+    return false;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), f) != nullptr) {
+    if (line[0] == '#' || strncmp(line, "benchmark,", 10) == 0) continue;
+    char name[64];
+    double ns = 0.0;
+    double allocs = 0.0;
+    if (sscanf(line, "%63[^,],%lf,%lf", name, &ns, &allocs) == 3) {
+      table.add(name, ns, allocs);
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+Table gBaseline;
+Table gCurrent;
+
+void recordRow(const bench::Result& r) {
+  printCsvRow(r);
+  gCurrent.add(r.name, r.nsPerOp, r.allocsPerOp);
+}
+
+// Compara atual x linha de base. Regressão: tempo acima do limiar
+// percentual ou qualquer aumento de alocações. Retorna o nº de regressões.
+int compareTables(const Table& baseline, const Table& current, double thresholdPct) {
+  int regressions = 0;
+  fprintf(stderr, "%-36s %12s %12s %8s\n", "benchmark", "base ns/op", "ns/op", "delta");
+  for (size_t i = 0; i < current.count; ++i) {
+    const BaselineRow& now = current.rows[i];
+    const BaselineRow* base = baseline.find(now.name);
+    if (base == nullptr) {
+      fprintf(stderr, "%-36s %12s %12.3f %8s  (new)\n", now.name, "-", now.nsPerOp, "-");
+      continue;
+    }
+    const double deltaPct =
+        (base->nsPerOp > 0.0) ? (now.nsPerOp - base->nsPerOp) * 100.0 / base->nsPerOp : 0.0;
+    const bool slower = deltaPct > thresholdPct;
+    const bool allocates = now.allocsPerOp > base->allocsPerOp + 1e-9;
+    const char* flag = slower ? "  REGRESSION" : (allocates ? "  REGRESSION (allocs)" : "");
+    fprintf(stderr, "%-36s %12.3f %12.3f %+7.1f%%%s\n", now.name, base->nsPerOp, now.nsPerOp,
+            deltaPct, flag);
+    if (slower || allocates) ++regressions;
+  }
+  return regressions;
+}
+
+void usage() {
+  fprintf(stderr,
+          "usage: bench [--filter NAME] [--min-time-ms N] [--repetitions N]\n"
+          "             [--compare BASELINE.csv [--threshold PCT]]\n"
+          "       bench --check [--filter NAME]\n"
+          "       bench --diff BASELINE.csv CURRENT.csv [--threshold PCT]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* filter = nullptr;
+  const char* baselinePath = nullptr;
+  const char* diffPath = nullptr;
+  double thresholdPct = 20.0;
+  uint64_t minTimeNs = 100000000ull;  // 100 ms por rodada
+  uint32_t repetitions = 5;
+  bool checks = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const bool hasValue = (i + 1) < argc;
+    if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+      filter = argv[++i];
+    } else if (strcmp(argv[i], "--min-time-ms") == 0 && hasValue) {
+      minTimeNs = strtoull(argv[++i], nullptr, 10) * 1000000ull;
+    } else if (strcmp(argv[i], "--repetitions") == 0 && hasValue) {
+      repetitions = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+    } else if (strcmp(argv[i], "--compare") == 0 && hasValue) {
+      baselinePath = argv[++i];
+    } else if (strcmp(argv[i], "--diff") == 0 && (i + 2) < argc) {
+      baselinePath = argv[++i];
+      diffPath = argv[++i];
+    } else if (strcmp(argv[i], "--threshold") == 0 && hasValue) {
+      thresholdPct = strtod(argv[++i], nullptr);
+    } else if (strcmp(argv[i], "--check") == 0) {
+      checks = true;
+    } else {
+      usage();
+      return 2;
+    }
+  }
+
+  // --check: só as verificações de resultado, sem medir tempo
+  if (checks) {
+    const uint32_t failed = bench::runChecks(filter);
+    if (failed > 0) fprintf(stderr, "bench: %lu check(s) failed\n", static_cast<unsigned long>(failed));
+    return failed > 0 ? 1 : 0;
+  }
+
+  if (baselinePath != nullptr && !loadCsv(baselinePath, gBaseline)) return 2;
+
+  // --diff: compara dois arquivos (ex.: CSV capturado da serial do ESP32)
+  if (diffPath != nullptr) {
+    if (!loadCsv(diffPath, gCurrent)) return 2;
+    return compareTables(gBaseline, gCurrent, thresholdPct) > 0 ? 1 : 0;
+  }
+
+  printCsvHeader();
+  bench::runAll(filter, minTimeNs, repetitions, recordRow);
+
+  if (baselinePath == nullptr) return 0;
+  const int regressions = compareTables(gBaseline, gCurrent, thresholdPct);
+  if (regressions > 0) {
+    fprintf(stderr, "bench: %d regression(s) above %.1f%%\n", regressions, thresholdPct);
+    return 1;
+  }
+  return 0;
+}
+
+#endif  // ARDUINO
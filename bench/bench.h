@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace bench {
+
+// ============================================================================
+// MICRO-BENCHMARKS DOS KERNELS QUENTES
+// ============================================================================
+//
+// Cada benchmark é uma função que executa a operação medida `iterations`
+// vezes. O executor calibra o número de iterações até o tempo medido passar
+// de um mínimo e reporta ns/op e alocações/op (operator new contado).
+//
+// Saída CSV (uma linha por benchmark):
+//   benchmark,ns_per_op,allocs_per_op,iterations
+//
+// Relógio: std::chrono::steady_clock no host, esp_timer no ESP32.
+// ============================================================================
+
+using BenchFn = void (*)(uint32_t iterations);
+
+// Registro estático (ver BENCHMARK abaixo)
+struct Registration {
+  Registration(const char* name, BenchFn fn);
+};
+
+// Resultado de um benchmark
+struct Result {
+  const char* name;
+  double nsPerOp;
+  double allocsPerOp;
+  uint32_t iterations;
+};
+
+// Impede que o compilador descarte um valor calculado no laço medido
+void consume(uint32_t value);
+void consume(float value);
+
+// Relógio monotônico em nanossegundos
+uint64_t nowNs();
+
+// Alocações feitas desde o início do programa (operator new)
+uint64_t allocationCount();
+
+// Executa os benchmarks cujo nome contém `filter` (nullptr = todos) e
+// chama `report` para cada resultado. Cada um é calibrado para durar
+// minTimeNs e repetido `repetitions` vezes (vale a mais rápida).
+// Retorna o número executado.
+uint32_t runAll(const char* filter, uint64_t minTimeNs, uint32_t repetitions,
+                void (*report)(const Result&));
+
+// ============================================================================
+// VERIFICAÇÕES DE RESULTADO (--check)
+// ============================================================================
+//
+// Comportamento dos kernels que não cabe em static_assert (depende de
+// float ou de executar o gerador): cada verificação roda uma vez e chama
+// expect() para cada condição. Saída CSV: check,<nome>,ok|FAIL
+
+using CheckFn = void (*)();
+
+struct CheckRegistration {
+  CheckRegistration(const char* name, CheckFn fn);
+};
+
+// Registra uma falha (com a mensagem formatada) se `ok` for falso
+bool expect(bool ok, const char* format, ...);
+
+// Executa as verificações cujo nome contém `filter`; retorna o nº que falhou
+uint32_t runChecks(const char* filter);
+
+}  // namespace bench
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+
+// Declara e registra um benchmark:
+//   BENCHMARK(nome) { for (uint32_t i = 0; i < iterations; ++i) { ... } }
+#define BENCHMARK(name)                                                        \
+  static void BENCH_CONCAT(bench_, name)(uint32_t iterations);                 \
+  static const ::bench::Registration BENCH_CONCAT(benchReg_, name)(            \
+      #name, &BENCH_CONCAT(bench_, name));                                     \
+  static void BENCH_CONCAT(bench_, name)(uint32_t iterations)
+
+// Declara e registra uma verificação:
+//   BENCH_CHECK(nome) { bench::expect(x == 1, "x = %d", x); }
+#define BENCH_CHECK(name)                                                      \
+  static void BENCH_CONCAT(check_, name)();                                    \
+  static const ::bench::CheckRegistration BENCH_CONCAT(checkReg_, name)(       \
+      #name, &BENCH_CONCAT(check_, name));                                     \
+  static void BENCH_CONCAT(check_, name)()
@@ -0,0 +1,315 @@
+#include "bench.h"
+
+#include <type_traits>
+
+#include "control/analog_setpoint.h"
+#include "control/cascade.h"
+#include "control/explicit_mpc.h"
+#include "control/frequency_response.h"
+#include "control/gain_schedule.h"
+#include "control/mpc_table.h"
+#include "control/pd_lut_law.h"
+#include "control/pipeline.h"
+#include "control/touch_classifier.h"
+#include "control/touch_slider.h"
+
+namespace {
+
+// Entradas pseudo-aleatórias fixas (LCG), iguais em toda execução
+constexpr uint32_t kInputCount = 256;
+
+struct Inputs {
+  long touchValues[kInputCount];
+  uint8_t zones[kInputCount];
+  uint32_t intervals[kInputCount];
+  uint16_t intensities[kInputCount];
+
+  Inputs() {
+    uint32_t seed = 12345u;
+    for (uint32_t i = 0; i < kInputCount; ++i) {
+      seed = seed * 1664525u + 1013904223u;
+      touchValues[i] = static_cast<long>((seed >> 8) % 101);  // 0..100
+      zones[i] = static_cast<uint8_t>((seed >> 20) % 4);
+      intervals[i] = 200 + (seed >> 16) % 1800;              // 200..2000 us
+      intensities[i] = static_cast<uint16_t>((seed >> 4) % 257);  // 0..256
+    }
+  }
+};
+
+const Inputs& inputs() {
+  static const Inputs table;
+  return table;
+}
+
+// Estágios do pipeline sensor → lei → atuador, com o sensor lendo a tabela
+struct BenchTouch {
+  uint8_t zone;
+};
+
+struct TableSensor {
+  using Input = void;
+  using Output = BenchTouch;
+  uint32_t index = 0;
+  bool poll(BenchTouch& out) {
+    out.zone = control::classifyTouchZone(inputs().touchValues[index++ & (kInputCount - 1)]);
+    return true;
+  }
+};
+
+struct LawStage {
+  using Input = BenchTouch;
+  using Output = control::MotorCommand;
+  control::PdLutLaw law;
+  bool process(const BenchTouch& in, control::MotorCommand& out) {
+    out = law.update(in.zone);
+    return out.steps != 0;
+  }
+};
+
+struct SumActuator {
+  using Input = control::MotorCommand;
+  using Output = void;
+  int32_t total = 0;
+  void process(const control::MotorCommand& command) { total += command.steps; }
+};
+
+// Canal de host: anel sem travas (só o custo de cópia, não o de uma fila FreeRTOS)
+template <typename T>
+struct RingChannel {
+  T slots[8];
+  uint32_t head = 0;
+  uint32_t tail = 0;
+  void init() {}
+  bool send(const T& msg) {
+    if (head - tail >= 8) return false;
+    slots[head++ & 7] = msg;
+    return true;
+  }
+  bool receive(T& msg, uint32_t /*waitTicks*/) {
+    if (head == tail) return false;
+    msg = slots[tail++ & 7];
+    return true;
+  }
+};
+
+struct SensorTask {};
+struct ControlTask {};
+
+template <typename SensorContext>
+using BenchPipeline = control::Pipeline<RingChannel, control::Stage<TableSensor, SensorContext>,
+                                        control::Stage<LawStage, ControlTask>,
+                                        control::Stage<SumActuator, ControlTask>>;
+
+template <typename SensorContext>
+int32_t runPipeline(uint32_t iterations) {
+  BenchPipeline<SensorContext> pipeline;
+  pipeline.init();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    pipeline.template run<SensorContext>(0);
+    if (!std::is_same<SensorContext, ControlTask>::value) pipeline.template run<ControlTask>(0);
+  }
+  return pipeline.template stage<2>().total;
+}
+
+}  // namespace
+
+// Quantização do valor bruto do sensor em zonas (touch_task)
+BENCHMARK(classify_touch_zone) {
+  const Inputs& in = inputs();
+  uint32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    acc += control::classifyTouchZone(in.touchValues[i & (kInputCount - 1)]);
+  }
+  bench::consume(acc);
+}
+
+// Setpoint analógico: um bloco de 2000 amostras do DMA (100 ms a 20 kHz)
+// por operação — média, filtro, escala e histerese; custo por período
+BENCHMARK(analog_setpoint_update) {
+  const Inputs& in = inputs();
+  constexpr uint32_t kBlockSamples = 2000;
+  control::AnalogSetpointFilter filter;
+  control::AnalogSetpoint setpoint;
+  uint32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const uint32_t raw = static_cast<uint32_t>(in.touchValues[i & (kInputCount - 1)]) * 40u;
+    acc += filter.update(raw * kBlockSamples, kBlockSamples, setpoint) ? setpoint.intensity : 0u;
+  }
+  bench::consume(acc);
+}
+
+// Slider de 5 pads: uma varredura por operação (força, máquina de toque,
+// centroide e velocidade), com um dedo indo e voltando; custo a 250 Hz
+BENCHMARK(touch_slider_update) {
+  constexpr uint8_t kPads = 5;
+  constexpr uint32_t kScanUs = 4000;
+  constexpr uint32_t kSweepScans = 64;
+  control::SliderTracker tracker(kPads, kScanUs);
+  control::SliderReading reading;
+  uint16_t idle[kPads] = {1000, 1000, 1000, 1000, 1000};
+  tracker.update(idle, 0, reading);  // Linha de base
+
+  // Varreduras com o dedo em cada ponto da ida, pré-calculadas
+  uint16_t scans[kSweepScans][kPads];
+  for (uint32_t k = 0; k < kSweepScans; ++k) {
+    const int32_t finger = static_cast<int32_t>(k * (kPads - 1) * 256 / kSweepScans);
+    for (uint8_t i = 0; i < kPads; ++i) {
+      int32_t distance = finger - i * 256;
+      if (distance < 0) distance = -distance;
+      const int32_t drop = (distance < 384) ? 400 - distance : 0;
+      scans[k][i] = static_cast<uint16_t>(1000 - drop);
+    }
+  }
+
+  uint32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const uint32_t k = i % (2 * kSweepScans);
+    const uint32_t index = (k < kSweepScans) ? k : 2 * kSweepScans - 1 - k;
+    tracker.update(scans[index], static_cast<int64_t>(i + 1) * kScanUs, reading);
+    acc += static_cast<uint32_t>(reading.position);
+  }
+  bench::consume(acc);
+}
+
+// Lei de controle completa por amostra (processControlLaw sem o envio)
+BENCHMARK(pd_lut_law_update) {
+  const Inputs& in = inputs();
+  control::PdLutLaw law;
+  int32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    acc += law.update(in.zones[i & (kInputCount - 1)]).steps;
+  }
+  bench::consume(static_cast<uint32_t>(acc));
+}
+
+// Lei escalonada: tabela interpolada + PD em inteiros (substitui a anterior)
+BENCHMARK(scheduled_pd_law_update) {
+  const Inputs& in = inputs();
+  control::ScheduledPdLaw law;
+  int32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    acc += law.update(in.intensities[i & (kInputCount - 1)]).steps;
+  }
+  bench::consume(static_cast<uint32_t>(acc));
+}
+
+// Só a interpolação da tabela (comparar com zone_lut_map_to_speed)
+BENCHMARK(gain_schedule_lookup) {
+  const Inputs& in = inputs();
+  const control::GainSchedule& table = control::defaultGainSchedule();
+  int32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const control::ScheduledGains g = table.at(in.intensities[i & (kInputCount - 1)]);
+    acc += g.baseSteps + g.stepsPerSec;
+  }
+  bench::consume(static_cast<uint32_t>(acc));
+}
+
+// Apenas a LUT zona → passos/intervalo
+BENCHMARK(zone_lut_map) {
+  const Inputs& in = inputs();
+  uint32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const control::ZoneMapping m = control::mapZone(in.zones[i & (kInputCount - 1)]);
+    acc += m.baseSteps + m.speedInterval;
+  }
+  bench::consume(acc);
+}
+
+// LUT + conversão intervalo → passos/s (divisão 1e6 / intervalo)
+BENCHMARK(zone_lut_map_to_speed) {
+  const Inputs& in = inputs();
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const control::ZoneMapping m = control::mapZone(in.zones[i & (kInputCount - 1)]);
+    acc += control::intervalToStepsPerSec(m.speedInterval);
+  }
+  bench::consume(acc);
+}
+
+// Só a divisão, com divisores variados (sem constant folding)
+BENCHMARK(interval_to_steps_per_sec) {
+  const Inputs& in = inputs();
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    acc += control::intervalToStepsPerSec(in.intervals[i & (kInputCount - 1)]);
+  }
+  bench::consume(acc);
+}
+
+// Troca de setpoint entre as malhas (seqlock): uma escrita + uma leitura
+BENCHMARK(latest_value_write_read) {
+  control::LatestValue<control::PositionSetpoint> handoff;
+  control::PositionSetpoint sp = {0, 100.0f, 0};
+  int32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    sp.positionSteps = static_cast<int32_t>(i);
+    handoff.write(sp);
+    acc += handoff.read().positionSteps;
+  }
+  bench::consume(static_cast<uint32_t>(acc));
+}
+
+// MPC explícito: busca da região + lei, estados espalhados pela tabela
+BENCHMARK(explicit_mpc_update) {
+  const Inputs& in = inputs();
+  control::ExplicitMpcLoop loop(control::kMpcTable, 0.001f);
+  control::PositionSetpoint sp = {0, 2000.0f, 0};
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const uint32_t k = i & (kInputCount - 1);
+    sp.positionSteps = (static_cast<int32_t>(in.touchValues[k]) - 50) * 40;  // ±2000 passos
+    loop.reset(static_cast<float>(in.intensities[k]) * 15.0f - 1920.0f);   // ±1920 passos/s
+    acc += loop.update(sp, 0);
+  }
+  bench::consume(acc);
+}
+
+// Pior caso da busca: estado que cai na última região da tabela
+BENCHMARK(explicit_mpc_locate_last) {
+  const control::MpcTable& table = control::kMpcTable;
+  int32_t xe = 0;
+  int32_t xv = 0;
+  size_t last = 0;
+  for (int32_t e = -32767; e <= 32767; e += 512) {
+    for (int32_t v = -32767; v <= 32767; v += 512) {
+      const size_t region = control::locateMpcRegion(table, e, v);
+      if (region >= last) {
+        last = region;
+        xe = e;
+        xv = v;
+      }
+    }
+  }
+  uint32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const int32_t jitter = static_cast<int32_t>(i & 1);
+    acc += static_cast<uint32_t>(control::locateMpcRegion(table, xe, xv + jitter));
+  }
+  bench::consume(acc);
+}
+
+// Custo por amostra da varredura de Bode na malha interna
+BENCHMARK(frequency_sweep_record) {
+  const control::SweepConfig config = {0.5f, 10.0f, 6, 100.0f, 3, 8, 1000};
+  control::FrequencySweep sweep;
+  sweep.start(config);
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    if (!sweep.running()) sweep.start(config);
+    const float u = sweep.excitation();
+    sweep.record(u, acc);
+    acc = u * 0.01f;
+  }
+  bench::consume(acc);
+}
+
+// Pipeline com sensor, lei e atuador na mesma task: chamadas diretas
+BENCHMARK(pipeline_fused_touch_law) {
+  bench::consume(static_cast<uint32_t>(runPipeline<ControlTask>(iterations)));
+}
+
+// Mesmo pipeline com o sensor em outra task: uma passagem pelo canal por amostra
+BENCHMARK(pipeline_split_touch_law) {
+  bench::consume(static_cast<uint32_t>(runPipeline<SensorTask>(iterations)));
+}
@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include "motion/speed_profile.h"
+#include "motion/step_generator.h"
+
+namespace {
+
+constexpr uint32_t kTickHz = 40000;  // Mesma base do stepper_task
+
+// Movimento diagonal longo; as razões entre eixos exercitam o Bresenham
+motion::LinearMove makeMove(uint8_t axisCount, float speed) {
+  motion::LinearMove move{};
+  for (uint8_t i = 0; i < axisCount; ++i) {
+    move.deltas[i] = 1000000 / (i + 1) * ((i & 1) ? -1 : 1);
+  }
+  move.cruiseVelocityQ32 = motion::stepsPerSecToQ32(speed, kTickHz);
+  move.accelQ32 = motion::stepsPerSecSecToQ32(50000.0f, kTickHz);
+  move.minVelocityQ32 = motion::stepsPerSecToQ32(50.0f, kTickHz);
+  return move;
+}
+
+// Faixas de ressonância do stepper_task (verificação extra por tick)
+const motion::SpeedProfileConfig kBandProfile = {
+    200, 1, motion::k17HS4401SResonanceBands, motion::k17HS4401SResonanceBandCount, 2, kTickHz / 2};
+
+// Custo por tick (o que o ISR executa a 40 kHz) no modo coordenado
+void linearTicks(uint8_t axisCount, uint32_t iterations, bool bands = false) {
+  motion::StepGenerator gen;
+  gen.configure(axisCount);
+  if (bands) motion::SpeedPlanner(kBandProfile).applyTo(gen, kTickHz);
+  const motion::LinearMove move = makeMove(axisCount, 15000.0f);
+  gen.start(move);
+  uint32_t pulses = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    pulses += gen.tick();
+    if (!gen.busy()) gen.start(move);
+  }
+  bench::consume(pulses);
+}
+
+// Custo por tick no modo de velocidade (streaming)
+void velocityTicks(uint8_t axisCount, uint32_t iterations) {
+  motion::StepGenerator gen;
+  gen.configure(axisCount);
+  gen.startVelocity(motion::stepsPerSecSecToQ32(50000.0f, kTickHz), 0);
+  for (uint8_t a = 0; a < axisCount; ++a) {
+    gen.setTargetVelocity(a, motion::signedStepsPerSecToQ32((a & 1) ? -9000.0f : 12000.0f, kTickHz));
+  }
+  uint32_t pulses = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    pulses += gen.tick();
+  }
+  bench::consume(pulses);
+}
+
+}  // namespace
+
+BENCHMARK(step_gen_linear_tick_1ax) { linearTicks(1, iterations); }
+BENCHMARK(step_gen_linear_tick_2ax) { linearTicks(2, iterations); }
+BENCHMARK(step_gen_linear_tick_3ax) { linearTicks(3, iterations); }
+BENCHMARK(step_gen_linear_tick_4ax) { linearTicks(4, iterations); }
+BENCHMARK(step_gen_linear_tick_bands) { linearTicks(1, iterations, true); }
+
+BENCHMARK(step_gen_velocity_tick_1ax) { velocityTicks(1, iterations); }
+BENCHMARK(step_gen_velocity_tick_4ax) { velocityTicks(4, iterations); }
+
+// Velocidade de cruzeiro fora das faixas (por movimento, no stepper_task)
+BENCHMARK(speed_plan_cruise) {
+  const motion::SpeedPlanner planner(kBandProfile);
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    acc += planner.planCruise(static_cast<float>(i & 2047));
+  }
+  bench::consume(acc);
+}
+
+// Planejamento de um movimento: conversões de unidade + start()
+BENCHMARK(step_gen_plan_move) {
+  motion::StepGenerator gen;
+  gen.configure(2);
+  uint32_t acc = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const motion::LinearMove move = makeMove(2, 500.0f + static_cast<float>(i & 1023));
+    gen.start(move);
+    acc += gen.velocityQ32();
+    gen.stop();
+  }
+  bench::consume(acc);
+}
@@ -0,0 +1,45 @@
+// Benchmarks que dependem do FreeRTOS/ESP32 (env esp32dev_bench)
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include "bench.h"
+#include "tasks/control_task.h"
+#include "tasks/stepper_task.h"
+
+namespace {
+
+template <typename T>
+void queueRoundTrip(uint32_t iterations) {
+  static QueueHandle_t queue = xQueueCreate(4, sizeof(T));
+  T msg{};
+  T out{};
+  for (uint32_t i = 0; i < iterations; ++i) {
+    xQueueSend(queue, &msg, 0);
+    xQueueReceive(queue, &out, 0);
+  }
+  bench::consume(static_cast<uint32_t>(sizeof(out)));
+}
+
+}  // namespace
+
+// Envio + recebimento sem bloqueio, mesma task (custo mínimo da fila)
+BENCHMARK(queue_touch_msg_send_receive) { queueRoundTrip<tasks::TouchInputMessage>(iterations); }
+BENCHMARK(queue_stepper_msg_send_receive) { queueRoundTrip<tasks::StepperMessage>(iterations); }
+
+// Custo do tick do gerador executado no próprio ESP32 (fora do ISR),
+// no mesmo formato CSV: ns_per_op = ns por tick
+void benchTargetExtras() {
+  constexpr uint32_t kTicks = 100000;
+  for (uint8_t axes = 1; axes <= tasks::kMaxStepperAxes; ++axes) {
+    const tasks::StepRateReport r = tasks::measureAggregateStepRate(axes, kTicks);
+    char line[96];
+    snprintf(line, sizeof(line), "isr_step_tick_%uax,%.3f,0.0000,%lu", axes, r.nsPerTick,
+             static_cast<unsigned long>(kTicks));
+    Serial.println(line);
+  }
+}
+
+#endif  // ARDUINO
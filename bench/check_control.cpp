@@ -0,0 +1,151 @@
+#include "bench.h"
+
+#include <math.h>
+
+#include "control/gain_schedule.h"
+#include "control/pd_lut_law.h"
+#include "control/touch_classifier.h"
+#include "control/touch_slider.h"
+#include "control/trace_codec.h"
+
+namespace {
+
+// Diferença relativa entre a lei escalonada e a LUT antiga
+float relativeError(float value, float reference) {
+  return fabsf(value - reference) / reference;
+}
+
+}  // namespace
+
+// Toque a partir do repouso no centro de cada zona: a intensidade que a
+// TouchSensorStage manda no evento deve dar o comando da antiga LUT
+// (passos base + Kp/Kd do degrau de zona e velocidade da zona), a 5%
+BENCH_CHECK(scheduled_law_matches_zone_lut) {
+  constexpr long kZoneCenters[] = {40, 22, 6};  // leve, médio, forte
+  constexpr float kTolerance = 0.05f;
+
+  for (const long raw : kZoneCenters) {
+    control::PdLutLaw lut;
+    control::ScheduledPdLaw law;
+    const control::MotorCommand expected = lut.update(control::classifyTouchZone(raw));
+    const control::MotorCommand actual = law.update(control::touchIntensity(raw));
+
+    bench::expect(relativeError(static_cast<float>(actual.steps), static_cast<float>(expected.steps)) <=
+                      kTolerance,
+                  "raw %ld: %ld steps, LUT %ld", raw, static_cast<long>(actual.steps),
+                  static_cast<long>(expected.steps));
+    bench::expect(relativeError(actual.speedInStepsPerSec, expected.speedInStepsPerSec) <= kTolerance,
+                  "raw %ld: %.0f steps/s, LUT %.0f", raw, actual.speedInStepsPerSec,
+                  expected.speedInStepsPerSec);
+  }
+}
+
+// Sentido pedido pela fonte (gesto do slider) vale sobre a alternância
+BENCH_CHECK(scheduled_law_follows_direction) {
+  control::ScheduledPdLaw law;
+  const int32_t back1 = law.update(200, -1).steps;
+  const int32_t back2 = law.update(200, -1).steps;
+  const int32_t ahead = law.update(200, 1).steps;
+  bench::expect(back1 < 0 && back2 < 0, "direction -1: %ld, %ld", static_cast<long>(back1),
+                static_cast<long>(back2));
+  bench::expect(ahead > 0, "direction +1: %ld", static_cast<long>(ahead));
+
+  const int32_t free1 = law.update(200).steps;
+  const int32_t free2 = law.update(200).steps;
+  bench::expect((free1 > 0) != (free2 > 0), "direction 0 should alternate: %ld, %ld",
+                static_cast<long>(free1), static_cast<long>(free2));
+}
+
+// O sentido sobrevive à gravação (e logs sem ele leem 0)
+BENCH_CHECK(trace_codec_keeps_direction) {
+  uint8_t buffer[control::kTraceHeaderBytes + 3 * control::kTraceMaxRecordBytes];
+  control::TraceEncoder encoder;
+  size_t size = encoder.begin(buffer, 1000000);
+  const int8_t directions[] = {-1, 0, 1};
+  for (const int8_t direction : directions) {
+    control::TraceRecord record = {};
+    record.kind = control::TraceRecordKind::Input;
+    record.input = {1000u, -3072, 3, 256, direction};
+    size += encoder.write(record, buffer + size);
+  }
+
+  control::TraceDecoder decoder(buffer, size);
+  control::TraceRecord record;
+  for (const int8_t direction : directions) {
+    const bool read = decoder.next(record);
+    bench::expect(read && record.input.direction == direction && record.input.touchZone == 3,
+                  "direction %d read back as %d (zone %u)", direction, record.input.direction,
+                  record.input.touchZone);
+  }
+}
+
+namespace {
+
+constexpr uint8_t kCheckPads = 5;
+constexpr uint32_t kCheckScanUs = 4000;
+constexpr uint16_t kIdleRaw = 1000;
+
+// Varredura com o dedo sobre o pad `pad` (ou nenhum, pad < 0)
+void fingerScan(int8_t pad, uint16_t* raw) {
+  for (uint8_t i = 0; i < kCheckPads; ++i) raw[i] = (i == pad) ? 600 : kIdleRaw;
+}
+
+// Varreduras de `from` a `to` (exclusivo); retorna se algum evento foi `wanted`
+bool scanUntil(control::SliderTracker& tracker, int8_t pad, uint32_t from, uint32_t to,
+               control::SliderEvent wanted) {
+  uint16_t raw[kCheckPads];
+  control::SliderReading reading;
+  fingerScan(pad, raw);
+  bool seen = false;
+  for (uint32_t k = from; k < to; ++k) {
+    seen = tracker.update(raw, static_cast<int64_t>(k) * kCheckScanUs, reading) == wanted || seen;
+  }
+  return seen;
+}
+
+}  // namespace
+
+// Dedo sobre o slider na calibração: ao sair, a base se corrige e o
+// próximo toque é reconhecido
+BENCH_CHECK(slider_recovers_from_touch_at_init) {
+  control::SliderTracker tracker(kCheckPads, kCheckScanUs);
+  scanUntil(tracker, 2, 0, 50, control::SliderEvent::Press);  // Base tomada com o dedo
+  scanUntil(tracker, -1, 50, 60, control::SliderEvent::Press);
+  bench::expect(scanUntil(tracker, 2, 60, 70, control::SliderEvent::Press),
+                "no press after the finger left the pad");
+}
+
+// Toque que não solta (base errada) vira soltura em kSliderMaxTouchUs e recalibra
+BENCH_CHECK(slider_reprimes_stuck_touch) {
+  control::SliderTracker tracker(kCheckPads, kCheckScanUs);
+  const uint32_t stuckScans = static_cast<uint32_t>(control::kSliderMaxTouchUs / kCheckScanUs);
+  scanUntil(tracker, -1, 0, 10, control::SliderEvent::Press);
+  bench::expect(scanUntil(tracker, 2, 10, 20, control::SliderEvent::Press), "no press");
+  bench::expect(!scanUntil(tracker, 2, 20, stuckScans, control::SliderEvent::Release),
+                "released before the timeout");
+  bench::expect(scanUntil(tracker, 2, stuckScans, stuckScans + 20, control::SliderEvent::Release),
+                "stuck touch not released");
+  scanUntil(tracker, -1, stuckScans + 20, stuckScans + 40, control::SliderEvent::Press);
+  bench::expect(scanUntil(tracker, 2, stuckScans + 40, stuckScans + 50, control::SliderEvent::Press),
+                "no press after re-priming");
+}
+
+// Ids guardados na partida a quente: cada um dá a sua tabela, e um id
+// desconhecido (registro de outra versão) não troca nada
+BENCH_CHECK(gain_schedule_ids) {
+  const control::GainSchedule* touch =
+      control::gainScheduleFor(static_cast<uint8_t>(control::GainScheduleId::Touch));
+  const control::GainSchedule* heavy =
+      control::gainScheduleFor(static_cast<uint8_t>(control::GainScheduleId::HeavyLoad));
+  bench::expect(touch == &control::defaultGainSchedule(), "Touch is not the default table");
+  bench::expect(heavy != nullptr && heavy != touch, "HeavyLoad has no table of its own");
+  bench::expect(control::gainScheduleFor(control::kGainScheduleCount) == nullptr,
+                "unknown id returned a table");
+  if (heavy == nullptr) return;
+  const uint16_t kStrong = 224;
+  bench::expect(heavy->at(kStrong).stepsPerSec < touch->at(kStrong).stepsPerSec &&
+                    heavy->at(kStrong).baseSteps == touch->at(kStrong).baseSteps,
+                "HeavyLoad at s=%u: %ld steps at %ld steps/s", kStrong,
+                static_cast<long>(heavy->at(kStrong).baseSteps),
+                static_cast<long>(heavy->at(kStrong).stepsPerSec));
+}
@@ -0,0 +1,174 @@
+#include "bench.h"
+
+#include "motion/speed_profile.h"
+#include "motion/step_generator.h"
+
+namespace {
+
+constexpr uint32_t kTickHz = 40000;     // Mesma base do stepper_task
+constexpr uint32_t kCeiling = 900;      // Teto dentro da faixa {700, 1000}
+constexpr float kRampAccel = 200.0f;    // Movimentos enfileirados (passos/s²)
+constexpr float kRampMinSpeed = 20.0f;  // Início e fim das rampas (passos/s)
+constexpr float kBandCruise = 1200.0f;  // Rampa atravessa as duas faixas
+
+const motion::SpeedProfileConfig kProfile = {
+    200, 1, motion::k17HS4401SResonanceBands, motion::k17HS4401SResonanceBandCount, 2, kCeiling};
+
+// Rampa registrada passo a passo no eixo dominante
+struct RampTrace {
+  uint32_t steps;
+  uint32_t accelSteps;    // Passos até chegar ao cruzeiro
+  uint32_t decelSteps;    // Passos depois que a velocidade começa a cair
+  uint32_t bandTicks;     // Ticks da rampa de subida dentro de alguma faixa
+  uint32_t firstStepQ32;  // Velocidade no primeiro passo
+  uint32_t lastStepQ32;   // Velocidade no último passo
+  bool idle;              // Terminou sozinho (sem estourar o limite de ticks)
+};
+
+float toStepsPerSec(uint32_t velocityQ32) {
+  return static_cast<float>(velocityQ32) * kTickHz / 4294967296.0f;
+}
+
+bool insideBand(float stepsPerSec) {
+  for (uint8_t i = 0; i < motion::k17HS4401SResonanceBandCount; ++i) {
+    if (stepsPerSec > motion::k17HS4401SResonanceBands[i].lowFullStepsPerSec &&
+        stepsPerSec < motion::k17HS4401SResonanceBands[i].highFullStepsPerSec) {
+      return true;
+    }
+  }
+  return false;
+}
+
+motion::LinearMove rampMove(const int32_t* deltas, uint8_t axisCount, float cruise) {
+  motion::LinearMove move{};
+  for (uint8_t i = 0; i < axisCount; ++i) move.deltas[i] = deltas[i];
+  move.cruiseVelocityQ32 = motion::stepsPerSecToQ32(cruise, kTickHz);
+  move.accelQ32 = motion::stepsPerSecSecToQ32(kRampAccel, kTickHz);
+  move.minVelocityQ32 = motion::stepsPerSecToQ32(kRampMinSpeed, kTickHz);
+  return move;
+}
+
+// Executa o movimento até o fim; `bands` carrega as faixas do perfil no gerador
+RampTrace runRamp(motion::StepGenerator& gen, const motion::LinearMove& move, bool bands) {
+  if (bands) motion::SpeedPlanner(kProfile).applyTo(gen, kTickHz);
+  RampTrace trace = {};
+  if (!gen.start(move)) return trace;
+
+  const uint64_t maxTicks = 60ull * kTickHz;
+  uint32_t peak = 0;
+  bool cruising = false;
+  for (uint64_t t = 0; t < maxTicks && gen.busy(); ++t) {
+    const bool stepped = gen.tick() != 0;
+    const uint32_t velocity = gen.velocityQ32();
+    if (!cruising && insideBand(toStepsPerSec(velocity))) ++trace.bandTicks;
+    if (!stepped) continue;
+
+    if (trace.steps++ == 0) trace.firstStepQ32 = velocity;
+    trace.lastStepQ32 = velocity;
+    if (velocity > peak) {
+      peak = velocity;
+      trace.accelSteps = trace.steps;
+    } else if (velocity < peak) {
+      cruising = true;
+      ++trace.decelSteps;
+    }
+    if (velocity >= move.cruiseVelocityQ32) cruising = true;
+  }
+  trace.idle = !gen.busy();
+  return trace;
+}
+
+}  // namespace
+
+// Cruzeiro com fração perto de uma borda: o arredondamento não deixa a
+// velocidade dentro da faixa
+BENCH_CHECK(speed_planner_rounding) {
+  const motion::SpeedPlanner planner(kProfile);
+  const struct {
+    float in;
+    float out;
+  } kCases[] = {
+      {50.3f, 50.3f},    // Fora das faixas: intacta
+      {99.6f, 99.6f},    // Abaixo da borda
+      {100.0f, 100.0f},  // Borda
+      {100.4f, 100.0f},  // Acima da borda, arredonda para ela
+      {120.4f, 100.0f},  // Dentro, mais perto da borda de baixo
+      {159.6f, 160.0f},  // Dentro, arredonda para a borda de cima
+      {160.3f, 160.3f},  // Acima da faixa
+  };
+  for (const auto& c : kCases) {
+    const float out = planner.planCruise(c.in);
+    bench::expect(out == c.out, "planCruise(%.1f) = %.2f, expected %.1f", c.in, out, c.out);
+  }
+}
+
+// O sinal sobrevive ao desvio das faixas (alvos do modo velocidade)
+BENCH_CHECK(speed_planner_keeps_sign) {
+  const motion::SpeedPlanner planner(kProfile);
+  bench::expect(planner.planCruise(-140.0f) == -160.0f, "planCruise(-140) = %.1f",
+                planner.planCruise(-140.0f));
+  bench::expect(planner.planCruise(-50.0f) == -50.0f, "planCruise(-50) = %.1f",
+                planner.planCruise(-50.0f));
+  bench::expect(planner.planCruise(0.0f) == 0.0f, "planCruise(0) = %.1f", planner.planCruise(0.0f));
+}
+
+// Acima do teto: limita ao teto, e o teto dentro de uma faixa cai na borda de baixo
+BENCH_CHECK(speed_planner_ceiling) {
+  const motion::SpeedPlanner planner(kProfile);
+  bench::expect(planner.planCruise(5000.0f) == 700.0f, "planCruise(5000) = %.1f",
+                planner.planCruise(5000.0f));
+  bench::expect(planner.planCruise(-5000.0f) == -700.0f, "planCruise(-5000) = %.1f",
+                planner.planCruise(-5000.0f));
+  bench::expect(planner.planCruise(950.0f) == 700.0f, "planCruise(950) = %.1f",
+                planner.planCruise(950.0f));
+}
+
+// Rampa que atravessa as faixas: a descida espelha a subida, o reforço
+// encurta o tempo na faixa e o movimento termina no passo exato
+BENCH_CHECK(step_gen_band_ramp_mirrors) {
+  const int32_t deltas[] = {12000};
+  const motion::LinearMove move = rampMove(deltas, 1, kBandCruise);
+
+  motion::StepGenerator plain;
+  plain.configure(1);
+  const RampTrace reference = runRamp(plain, move, false);
+
+  motion::StepGenerator gen;
+  gen.configure(1);
+  const RampTrace trace = runRamp(gen, move, true);
+
+  bench::expect(trace.idle && gen.position(0) == deltas[0], "ended at %ld of %ld",
+                static_cast<long>(gen.position(0)), static_cast<long>(deltas[0]));
+  const long mismatch = static_cast<long>(trace.accelSteps) - static_cast<long>(trace.decelSteps);
+  bench::expect(mismatch >= -1 && mismatch <= 1, "accel %lu steps, decel %lu steps",
+                static_cast<unsigned long>(trace.accelSteps),
+                static_cast<unsigned long>(trace.decelSteps));
+  // Sem parada brusca: o último passo sai no máximo à velocidade do primeiro
+  bench::expect(trace.lastStepQ32 >= move.minVelocityQ32 && trace.lastStepQ32 <= trace.firstStepQ32,
+                "first step at %.1f steps/s, last at %.1f", toStepsPerSec(trace.firstStepQ32),
+                toStepsPerSec(trace.lastStepQ32));
+  bench::expect(trace.bandTicks * 3 < reference.bandTicks, "band ticks %lu boosted, %lu plain",
+                static_cast<unsigned long>(trace.bandTicks),
+                static_cast<unsigned long>(reference.bandTicks));
+}
+
+// Vários eixos, deltas negativos, e um triângulo que vira dentro da faixa:
+// todos os eixos chegam exatamente ao destino
+BENCH_CHECK(step_gen_band_ramp_exact_steps) {
+  const int32_t kMoves[][3] = {
+      {5000, -3001, 1234},
+      {-4321, 0, 4321},
+      {70, -35, 1},  // Pico ~120 passos/s: dentro de {100, 160}
+  };
+  for (const auto& deltas : kMoves) {
+    motion::StepGenerator gen;
+    gen.configure(3);
+    const RampTrace trace = runRamp(gen, rampMove(deltas, 3, kBandCruise), true);
+    bench::expect(trace.idle, "move {%ld, %ld, %ld} did not finish", static_cast<long>(deltas[0]),
+                  static_cast<long>(deltas[1]), static_cast<long>(deltas[2]));
+    for (uint8_t i = 0; i < 3; ++i) {
+      bench::expect(gen.position(i) == deltas[i], "axis %u ended at %ld of %ld", i,
+                    static_cast<long>(gen.position(i)), static_cast<long>(deltas[i]));
+    }
+  }
+}
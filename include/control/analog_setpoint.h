@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "control/touch_classifier.h"
+
+namespace control {
+
+// ============================================================================
+// SETPOINT ANALÓGICO (ADC contínuo com DMA, hal/analog_input.h)
+// ============================================================================
+//
+// O ADC amostra a 20 kHz e o driver acumula as conversões; a cada período
+// da malha externa o bloco inteiro vira uma média (decimação) e passa por
+// uma média exponencial. O resultado é a mesma intensidade 0..256 da
+// TouchSensorStage, com 257 níveis em vez de 4 zonas.
+//
+// Calibração (valores brutos de 12 bits): abaixo de kAnalogRawMin = 0,
+// acima de kAnalogRawMax = 256. As pontas ficam fora da faixa não linear
+// do ADC do ESP32 (perto de 0 e de 4095).
+constexpr uint16_t kAnalogRawMin = 128;
+constexpr uint16_t kAnalogRawMax = 3968;
+
+// Escala média (Q4) → intensidade por multiplicação em Q16, sem divisão
+constexpr uint32_t kAnalogIntensityScaleQ16 =
+    ((static_cast<uint32_t>(kTouchIntensityMax) << 16) + (kAnalogRawMax - kAnalogRawMin) / 2) /
+    (kAnalogRawMax - kAnalogRawMin);
+
+static_assert(kAnalogRawMax > kAnalogRawMin, "Calibração analógica invertida");
+static_assert((static_cast<uint32_t>(4095) << 4) <= 0xFFFFFFFFu / kAnalogIntensityScaleQ16,
+              "Escala analógica estoura 32 bits");
+
+// Intensidade (0..256) de uma média em Q4 (valor bruto × 16)
+uint16_t analogIntensity(uint32_t meanQ4);
+
+// Zona equivalente às do toque, só para o display
+uint8_t intensityZone(uint16_t intensity);
+
+struct AnalogSetpoint {
+  uint16_t raw;        // Média filtrada, em unidades do ADC (0..4095)
+  uint16_t intensity;  // 0..256
+  uint8_t zone;        // 0..3 (display)
+};
+
+// Decimação + média exponencial (α = 1/2^kShift entre blocos) + histerese.
+// update() recebe a soma e a contagem de um bloco do DMA: uma divisão por
+// bloco, nenhuma por amostra.
+class AnalogSetpointFilter {
+ public:
+  static constexpr uint8_t kShift = 1;
+  static constexpr uint16_t kHysteresis = 2;  // Em unidades de intensidade
+
+  // true quando a intensidade filtrada se afastou mais que kHysteresis da
+  // última publicada (out é preenchido sempre)
+  bool update(uint32_t sum, uint32_t samples, AnalogSetpoint& out);
+
+  void reset();
+
+ private:
+  int32_t stateQ4_ = 0;
+  bool primed_ = false;
+  uint16_t published_ = 0;
+};
+
+}  // namespace control
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace control {
+
+// ============================================================================
+// CONTROLE EM CASCATA MULTI-TAXA
+// ============================================================================
+//
+//   [malha externa]  --setpoint-->  [malha interna]  --velocidade-->  [motor]
+//    10..100 Hz       (lock-free)    1..2 kHz                          (stepper_task)
+//
+// A malha externa (referência, toque) roda devagar; a malha interna de
+// posição/velocidade roda rápido. As duas taxas vêm de uma única
+// configuração: a externa é a interna dividida por um inteiro, de modo que
+// os instantes de amostragem coincidem.
+// ============================================================================
+
+struct ControlRates {
+  uint32_t innerHz;       // Taxa da malha interna
+  uint32_t outerDivider;  // Malha externa roda a cada N amostras da interna
+
+  constexpr uint32_t innerPeriodUs() const { return 1000000u / innerHz; }
+  constexpr uint32_t outerPeriodUs() const { return innerPeriodUs() * outerDivider; }
+  constexpr uint32_t outerHz() const { return innerHz / outerDivider; }
+};
+
+// Configuração única das duas taxas: interna 1 kHz, externa 10 Hz
+constexpr ControlRates kControlRates = {1000, 100};
+
+static_assert(kControlRates.innerHz >= 1000 && kControlRates.innerHz <= 2000,
+              "Malha interna deve rodar entre 1 e 2 kHz");
+static_assert(kControlRates.outerHz() >= 10 && kControlRates.outerHz() <= 100,
+              "Malha externa deve rodar entre 10 e 100 Hz");
+static_assert(1000000u % kControlRates.innerHz == 0, "Período interno deve ser inteiro em us");
+
+// Referência entregue pela malha externa à malha interna
+struct PositionSetpoint {
+  int32_t positionSteps;  // Posição desejada (passos absolutos)
+  float velocityLimit;    // Velocidade máxima permitida (passos/s)
+  int64_t timestampUs;    // Instante da escrita (µs, hal/clock.h)
+};
+
+// ----------------------------------------------------------------------------
+// Troca lock-free "último valor vale" (seqlock, um escritor, leitores à vontade)
+// ----------------------------------------------------------------------------
+// O escritor nunca bloqueia; o leitor repete a cópia se pegar uma escrita
+// pela metade. Nenhuma fila: um setpoint velho nunca fica atrás de um novo.
+template <typename T>
+class LatestValue {
+ public:
+  void write(const T& value) {
+    const uint32_t seq = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(seq + 1, std::memory_order_relaxed);  // Ímpar: escrita em curso
+    std::atomic_thread_fence(std::memory_order_release);
+    value_ = value;
+    std::atomic_thread_fence(std::memory_order_release);
+    sequence_.store(seq + 2, std::memory_order_relaxed);
+  }
+
+  T read() const {
+    T copy;
+    uint32_t before = 0;
+    uint32_t after = 0;
+    do {
+      before = sequence_.load(std::memory_order_acquire);
+      copy = value_;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence_.load(std::memory_order_relaxed);
+    } while ((before & 1u) != 0 || before != after);
+    return copy;
+  }
+
+ private:
+  T value_{};
+  std::atomic<uint32_t> sequence_{0};
+};
+
+// ----------------------------------------------------------------------------
+// Limite de frenagem: maior velocidade da qual ainda se para no alvo
+// ----------------------------------------------------------------------------
+//   v_freio = sqrt(2 * a * |e|)
+// O atuador limita a aceleração; sem este limite a malha pede mais
+// velocidade do que consegue frear e oscila em ciclo-limite em torno do alvo.
+// decelLimit <= 0 desativa.
+inline float clampVelocity(float velocity, float error, float velocityLimit, float decelLimit) {
+  float limit = velocityLimit;
+  if (decelLimit > 0.0f) {
+    const float brake = sqrtf(2.0f * decelLimit * ((error < 0.0f) ? -error : error));
+    if (brake < limit) limit = brake;
+  }
+  if (velocity > limit) return limit;
+  if (velocity < -limit) return -limit;
+  return velocity;
+}
+
+// ----------------------------------------------------------------------------
+// Lei da malha interna: P de posição -> comando de velocidade saturado
+// ----------------------------------------------------------------------------
+//   v[k] = sat( Kp_pos * (r[k] - y[k]), ±min(v_max, v_freio) )
+// Velocidade em passos/s; o gerador de passos limita a aceleração, e
+// decelLimit deve ser essa mesma aceleração (passos/s²).
+class PositionLoop {
+ public:
+  explicit PositionLoop(float positionGain, float decelLimit = 0.0f)
+      : positionGain_(positionGain), decelLimit_(decelLimit) {}
+
+  float update(const PositionSetpoint& setpoint, int32_t measuredSteps) const {
+    const float error = static_cast<float>(setpoint.positionSteps - measuredSteps);
+    return clampVelocity(positionGain_ * error, error, setpoint.velocityLimit, decelLimit_);
+  }
+
+ private:
+  float positionGain_;  // 1/s
+  float decelLimit_;    // passos/s²
+};
+
+// ----------------------------------------------------------------------------
+// Repouso da malha interna: parar de escrever velocidades no alvo
+// ----------------------------------------------------------------------------
+// Escrever velocidade a cada amostra mantém o gerador de passos no modo
+// velocidade, e um movimento enfileirado só entra quando esse modo acaba.
+// Depois de idleSamples amostras seguidas com erro nulo e comando abaixo de
+// kStreamIdleVelocity, a malha pede uma vez a parada do streaming (Stop) e
+// segura (Hold) até o erro ou o comando voltarem (Write).
+constexpr float kStreamIdleVelocity = 1.0f;  // Passos/s
+
+enum class StreamAction : uint8_t { Write, Stop, Hold };
+
+class StreamGate {
+ public:
+  explicit StreamGate(uint32_t idleSamples) : idleSamples_(idleSamples) {}
+
+  StreamAction update(int32_t errorSteps, float velocity) {
+    const bool still = errorSteps == 0 && velocity < kStreamIdleVelocity &&
+                       velocity > -kStreamIdleVelocity;
+    if (!still) {
+      idle_ = 0;
+      return StreamAction::Write;
+    }
+    if (idle_ > idleSamples_) return StreamAction::Hold;
+    ++idle_;
+    return (idle_ > idleSamples_) ? StreamAction::Stop : StreamAction::Write;
+  }
+
+ private:
+  uint32_t idleSamples_;
+  uint32_t idle_ = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Contadores de execução e de perda de prazo (deadline overrun) por malha
+// ----------------------------------------------------------------------------
+struct LoopStats {
+  uint32_t runs;
+  uint32_t overruns;    // Execuções que passaram do período ou amostras perdidas
+  uint32_t lastUs;      // Duração da última execução
+  uint32_t maxUs;       // Pior duração observada
+  uint64_t totalUs;     // Soma das durações (CPU = totalUs / tempo decorrido)
+
+  void record(uint32_t elapsedUs, uint32_t periodUs, uint32_t missedSamples) {
+    ++runs;
+    lastUs = elapsedUs;
+    totalUs += elapsedUs;
+    if (elapsedUs > maxUs) maxUs = elapsedUs;
+    if (elapsedUs > periodUs || missedSamples > 0) {
+      overruns += (missedSamples > 0) ? missedSamples : 1;
+    }
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Latência entrada → processamento (carimbo da mensagem até a lei de controle)
+// ----------------------------------------------------------------------------
+struct LatencyStats {
+  uint32_t samples;
+  uint32_t lastUs;
+  uint32_t maxUs;
+  uint64_t totalUs;
+
+  void record(uint32_t latencyUs) {
+    ++samples;
+    lastUs = latencyUs;
+    totalUs += latencyUs;
+    if (latencyUs > maxUs) maxUs = latencyUs;
+  }
+
+  uint32_t meanUs() const { return (samples > 0) ? static_cast<uint32_t>(totalUs / samples) : 0; }
+};
+
+}  // namespace control
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "control/cascade.h"
+
+namespace control {
+
+// ============================================================================
+// MPC EXPLÍCITO (malha interna): lei por regiões pré-calculadas
+// ============================================================================
+//
+// O MPC da malha de posição minimiza, sobre um horizonte de 1,25 s, o erro
+// de posição e o esforço, respeitando |a| ≤ accelLimit e |v| ≤ velocityLimit
+// em cada bloco do horizonte. Resolver esse QP a 1 kHz no ESP32 não cabe;
+// mas a solução é afim por partes no estado x = (y − r, v), então
+// tools/mpc_generate.py resolve o QP paramétrico offline e grava as regiões
+// (polígonos H·x ≤ k) e a lei afim de cada uma em control/mpc_table.h.
+//
+// No dispositivo sobra uma busca em ponto fixo:
+//   x normalizado em Q15 (erro saturado em ±positionRange)
+//   região: h1·xe + h2·xv ≤ k  (h em Q14, k em Q29, soma em int32)
+//   lei:    a/accelLimit = (gE·xe + gV·xv) >> 16 + offset  (Q15)
+//   v[k+1] = v[k] + a·Ts, saturada em ±min(velocityLimit, setpoint)
+// A busca percorre as regiões em ordem (maiores primeiro) e para na
+// primeira que contém x; o pior caso é avaliar todos os semiplanos uma vez
+// (kMpcCheckBudget, verificado em tempo de compilação). Se o arredondamento
+// deixar x numa fresta entre regiões, vale a de menor violação: a lei do
+// MPC é contínua, então a vizinha dá o mesmo comando.
+//
+// O estado de velocidade é o próprio comando anterior: como o MPC nunca
+// pede mais que accelLimit (< aceleração do stepper), o motor acompanha.
+
+// Semiplano h1·xe + h2·xv ≤ k (h em Q14, x em Q15, k em Q29)
+struct MpcHalfspace {
+  int16_t h1;
+  int16_t h2;
+  int32_t k;
+};
+
+// Região: semiplanos [first, first + count) e a lei afim da aceleração
+struct MpcRegion {
+  uint16_t first;
+  uint16_t count;
+  int32_t gainE;   // Q16 (aceleração normalizada por erro normalizado)
+  int32_t gainV;   // Q16
+  int32_t offset;  // Q15
+};
+
+struct MpcTable {
+  const MpcHalfspace* halfspaces;
+  size_t halfspaceCount;
+  const MpcRegion* regions;
+  size_t regionCount;
+  float positionRange;  // Erro coberto pela tabela (passos); além disso satura
+  float velocityLimit;  // Passos/s
+  float accelLimit;     // Passos/s²
+};
+
+// Pior caso da busca: semiplanos avaliados por amostra. ~10 ciclos cada no
+// Xtensa a 240 MHz → ~12 µs, pouco mais de 1% do período de 1 ms.
+constexpr size_t kMpcCheckBudget = 288;
+
+// ---------------------------------------------------------------------------
+// Verificação da tabela em tempo de compilação (C++11: recursão constexpr)
+// ---------------------------------------------------------------------------
+
+// As verificações dividem o intervalo ao meio: profundidade log2(n), longe do
+// limite de recursão constexpr do compilador mesmo com centenas de semiplanos.
+
+// Região i não vazia e encostada na seguinte (a última fecha a lista)
+constexpr bool mpcRegionLinked(const MpcTable& table, size_t i) {
+  return table.regions[i].count > 0 &&
+         table.regions[i].first + table.regions[i].count ==
+             ((i + 1 < table.regionCount) ? table.regions[i + 1].first : table.halfspaceCount);
+}
+
+constexpr bool mpcRegionsLinked(const MpcTable& table, size_t begin, size_t end) {
+  return (end - begin == 1) ? mpcRegionLinked(table, begin)
+                            : mpcRegionsLinked(table, begin, begin + (end - begin) / 2) &&
+                                  mpcRegionsLinked(table, begin + (end - begin) / 2, end);
+}
+
+// Semiplano normalizado (max |h| = 1 em Q14) e k dentro de ±2^30: h·x − k cabe em int32
+constexpr bool mpcHalfspaceInRange(const MpcHalfspace& plane) {
+  return plane.h1 >= -16384 && plane.h1 <= 16384 && plane.h2 >= -16384 && plane.h2 <= 16384 &&
+         plane.k >= -(1 << 30) && plane.k <= (1 << 30);
+}
+
+constexpr bool mpcHalfspacesInRange(const MpcTable& table, size_t begin, size_t end) {
+  return (end - begin == 1) ? mpcHalfspaceInRange(table.halfspaces[begin])
+                            : mpcHalfspacesInRange(table, begin, begin + (end - begin) / 2) &&
+                                  mpcHalfspacesInRange(table, begin + (end - begin) / 2, end);
+}
+
+// Regiões contíguas a partir do semiplano 0, sem buraco nem sobra
+constexpr bool mpcTableValid(const MpcTable& table) {
+  return table.regionCount > 0 && table.halfspaceCount > 0 && table.regions[0].first == 0 &&
+         table.positionRange > 0.0f && table.velocityLimit > 0.0f && table.accelLimit > 0.0f &&
+         mpcRegionsLinked(table, 0, table.regionCount) &&
+         mpcHalfspacesInRange(table, 0, table.halfspaceCount);
+}
+
+// ---------------------------------------------------------------------------
+// Busca e lei
+// ---------------------------------------------------------------------------
+
+// Índice da região que contém (xe, xv) em Q15; fora de todas, a de menor violação
+size_t locateMpcRegion(const MpcTable& table, int32_t xe, int32_t xv);
+
+// Aceleração normalizada (Q15, ±32768 = ±accelLimit) da região
+int32_t evaluateMpcLaw(const MpcRegion& region, int32_t xe, int32_t xv);
+
+class ExplicitMpcLoop {
+ public:
+  ExplicitMpcLoop(const MpcTable& table, float samplePeriodS);
+
+  // Velocidade atual do comando (0 na partida; o comando vigente numa troca de lei)
+  void reset(float velocity) { velocity_ = velocity; }
+
+  // Comando de velocidade (passos/s) para a próxima amostra
+  float update(const PositionSetpoint& setpoint, int32_t measuredSteps) {
+    return update(setpoint, measuredSteps, samplePeriodS_);
+  }
+
+  // Idem, com o intervalo medido na integração v + a·dt (a lei da tabela
+  // continua a do Ts nominal; dt só corrige a velocidade acumulada)
+  float update(const PositionSetpoint& setpoint, int32_t measuredSteps, float dtS);
+
+  // Região usada na última amostra (diagnóstico)
+  size_t lastRegion() const { return lastRegion_; }
+
+ private:
+  const MpcTable& table_;
+  float samplePeriodS_;
+  int32_t positionRange_;  // Passos (inteiro)
+  int64_t errorScale_;     // Q16: passos → Q15
+  float velocityScale_;    // Passos/s → Q15
+  float velocity_ = 0.0f;
+  size_t lastRegion_ = 0;
+};
+
+}  // namespace control
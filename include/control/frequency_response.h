@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace control {
+
+// ============================================================================
+// RESPOSTA EM FREQUÊNCIA (BODE) POR SENO EM DEGRAUS
+// ============================================================================
+//
+// Uma senoide d[k] é somada à saída do controlador, em uma frequência por
+// vez (espaçamento logarítmico). Para cada frequência:
+//   1. descarta settleCycles períodos (transitório)
+//   2. correlaciona measureCycles períodos inteiros de d, u e y com
+//      cos/sen da mesma frequência (um único bin de DFT, como o Goertzel,
+//      mas com fase exata)
+//
+//   u = saída do controlador + d  (entrada da planta)
+//   y = saída medida
+//   Planta:        P(jw) = Y / U
+//   Malha aberta:  L(jw) = (D − U) / U   (c = u − d = −L·u)
+//
+// Custo por amostra: rotação do oscilador + 6 multiplica-acumula. Sem
+// buffers: o estado é O(1), independente do número de amostras.
+
+struct SweepConfig {
+  float startHz;
+  float stopHz;
+  uint8_t pointsPerDecade;
+  float amplitude;        // Amplitude de d (mesma unidade da saída do controlador)
+  uint8_t settleCycles;   // Períodos descartados em cada frequência
+  uint8_t measureCycles;  // Períodos integrados em cada frequência
+  uint32_t sampleHz;      // Taxa da malha em que a excitação é injetada
+};
+
+struct FrequencyPoint {
+  uint8_t index;
+  float hz;             // Frequência efetivamente medida
+  float plantGainDb;
+  float plantPhaseDeg;
+  float loopGainDb;
+  float loopPhaseDeg;
+  int64_t timestampUs;  // Instante da publicação (µs, hal/clock.h; quem publica carimba)
+};
+
+class FrequencySweep {
+ public:
+  // Inicia a varredura. Retorna false se a configuração é inválida
+  // (frequência acima de sampleHz/4, faixa vazia, etc.).
+  bool start(const SweepConfig& config);
+  void abort() { running_ = false; }
+
+  bool running() const { return running_; }
+  uint8_t pointCount() const { return pointCount_; }
+
+  // Excitação a somar à saída do controlador nesta amostra (0 se parado)
+  float excitation() const { return running_ ? config_.amplitude * sin_ : 0.0f; }
+
+  // Registra a amostra atual e avança o oscilador. Retorna true quando um
+  // ponto foi concluído; o resultado fica em lastPoint().
+  bool record(float plantInput, float plantOutput);
+
+  const FrequencyPoint& lastPoint() const { return lastPoint_; }
+
+ private:
+  struct Bin {
+    float re;
+    float im;
+  };
+
+  void beginPoint();
+  void finishPoint();
+
+  SweepConfig config_ = {};
+  bool running_ = false;
+  uint8_t pointCount_ = 0;
+  uint8_t pointIndex_ = 0;
+
+  // Oscilador recursivo: (cos, sin) girado de w a cada amostra
+  float cos_ = 1.0f;
+  float sin_ = 0.0f;
+  float stepCos_ = 1.0f;
+  float stepSin_ = 0.0f;
+  float hz_ = 0.0f;
+
+  uint32_t samplesPerCycle_ = 0;
+  uint32_t settleSamples_ = 0;
+  uint32_t measureSamples_ = 0;
+  uint32_t sample_ = 0;
+
+  Bin d_ = {};
+  Bin u_ = {};
+  Bin y_ = {};
+
+  FrequencyPoint lastPoint_ = {};
+};
+
+}  // namespace control
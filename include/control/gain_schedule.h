@@ -0,0 +1,145 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace control {
+
+// ============================================================================
+// ESCALONAMENTO DE GANHOS POR TABELAS INTERPOLADAS
+// ============================================================================
+//
+// Passos base, velocidade e ganhos Kp/Kd variam continuamente com uma
+// variável de escalonamento s (ex.: intensidade do toque, 0..256),
+// em vez de saltar entre quatro zonas.
+//
+// A tabela tem pontos igualmente espaçados de 2^kScheduleStepLog2 em s:
+//   i = s >> shift, f = s & (2^shift − 1)
+//   y = y[i] + ((y[i+1] − y[i]) · f) >> shift
+// Sem divisão em tempo de execução: custo de uma LUT mais 4 multiplicações.
+//
+// As tabelas são geradas em tempo de compilação (makeGainSchedule) a partir
+// de âncoras arbitrárias, ficam em flash e podem ser trocadas em execução
+// (GainScheduler::setTable) sem travas.
+
+// Valores interpolados em um ponto da tabela
+struct ScheduledGains {
+  int32_t baseSteps;    // Passos base do comando
+  int32_t stepsPerSec;  // Velocidade do movimento
+  int32_t kpQ8;         // Kp em Q8 (passos por unidade de s)
+  int32_t kdQ8;         // Kd em Q8
+};
+
+constexpr uint8_t kScheduleStepLog2 = 4;  // 16 unidades de s por segmento
+constexpr size_t kScheduleSegments = 16;
+constexpr size_t kSchedulePoints = kScheduleSegments + 1;
+constexpr uint16_t kScheduleSpan = kScheduleSegments << kScheduleStepLog2;  // s em 0..256
+
+struct GainSchedule {
+  ScheduledGains points[kSchedulePoints];
+
+  ScheduledGains at(uint16_t s) const {
+    if (s >= kScheduleSpan) return points[kSchedulePoints - 1];
+    const ScheduledGains& a = points[s >> kScheduleStepLog2];
+    const ScheduledGains& b = points[(s >> kScheduleStepLog2) + 1];
+    const int32_t f = s & ((1 << kScheduleStepLog2) - 1);
+    return ScheduledGains{lerp(a.baseSteps, b.baseSteps, f), lerp(a.stepsPerSec, b.stepsPerSec, f),
+                          lerp(a.kpQ8, b.kpQ8, f), lerp(a.kdQ8, b.kdQ8, f)};
+  }
+
+ private:
+  static int32_t lerp(int32_t a, int32_t b, int32_t f) {
+    return a + (((b - a) * f) >> kScheduleStepLog2);
+  }
+};
+
+// Ponto de definição da tabela: valores em s = x (x crescente)
+struct ScheduleAnchor {
+  uint16_t x;
+  ScheduledGains gains;
+};
+
+namespace detail {
+
+template <size_t... I>
+struct IndexList {};
+template <size_t N, size_t... I>
+struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...> {};
+template <size_t... I>
+struct MakeIndexList<0, I...> {
+  using type = IndexList<I...>;
+};
+
+constexpr int32_t lerpAnchor(int32_t a, int32_t b, int32_t num, int32_t den) {
+  return a + static_cast<int32_t>((static_cast<int64_t>(b) - a) * num / den);
+}
+
+constexpr ScheduledGains lerpGains(const ScheduleAnchor& a, const ScheduleAnchor& b, int32_t x) {
+  return ScheduledGains{lerpAnchor(a.gains.baseSteps, b.gains.baseSteps, x - a.x, b.x - a.x),
+                        lerpAnchor(a.gains.stepsPerSec, b.gains.stepsPerSec, x - a.x, b.x - a.x),
+                        lerpAnchor(a.gains.kpQ8, b.gains.kpQ8, x - a.x, b.x - a.x),
+                        lerpAnchor(a.gains.kdQ8, b.gains.kdQ8, x - a.x, b.x - a.x)};
+}
+
+// Curva linear por partes das âncoras avaliada em x (constante fora da faixa)
+template <size_t N>
+constexpr ScheduledGains sampleAnchors(const ScheduleAnchor (&a)[N], int32_t x, size_t k) {
+  return (x <= a[0].x)           ? a[0].gains
+         : (x >= a[N - 1].x)     ? a[N - 1].gains
+         : (x < a[k + 1].x)      ? lerpGains(a[k], a[k + 1], x)
+                                 : sampleAnchors(a, x, k + 1);
+}
+
+template <size_t N, size_t... I>
+constexpr GainSchedule buildSchedule(const ScheduleAnchor (&a)[N], IndexList<I...>) {
+  return GainSchedule{{sampleAnchors(a, static_cast<int32_t>(I << kScheduleStepLog2), 0)...}};
+}
+
+}  // namespace detail
+
+// Âncoras em ordem estritamente crescente de x (use em static_assert)
+template <size_t N>
+constexpr bool anchorsAscending(const ScheduleAnchor (&a)[N], size_t k = 1) {
+  return (k >= N) ? true : (a[k - 1].x < a[k].x && anchorsAscending(a, k + 1));
+}
+
+// Amostra as âncoras na grade uniforme da tabela (tempo de compilação).
+// Âncoras sobre múltiplos de 2^kScheduleStepLog2 são reproduzidas exatamente.
+template <size_t N>
+constexpr GainSchedule makeGainSchedule(const ScheduleAnchor (&anchors)[N]) {
+  static_assert(N >= 2, "a tabela precisa de pelo menos duas âncoras");
+  return detail::buildSchedule(anchors, typename detail::MakeIndexList<kSchedulePoints>::type());
+}
+
+// Tabela ativa, trocável em execução por outra task (troca de ponteiro
+// atômica; a tabela nova deve continuar existindo enquanto estiver ativa)
+class GainScheduler {
+ public:
+  explicit GainScheduler(const GainSchedule& table) : table_(&table) {}
+
+  void setTable(const GainSchedule& table) { table_.store(&table, std::memory_order_release); }
+  const GainSchedule& table() const { return *table_.load(std::memory_order_acquire); }
+
+  ScheduledGains lookup(uint16_t s) const { return table().at(s); }
+
+ private:
+  std::atomic<const GainSchedule*> table_;
+};
+
+// Tabela padrão: curva suave passando pelos valores da antiga LUT de zonas
+const GainSchedule& defaultGainSchedule();
+
+// Tabelas selecionáveis em execução. O id (e não o ponteiro) é o que a
+// partida a quente guarda (hal/warm_state.h).
+enum class GainScheduleId : uint8_t {
+  Touch = 0,      // defaultGainSchedule()
+  HeavyLoad = 1,  // Mesmos passos, velocidades ~60% (carga com mais inércia)
+};
+constexpr uint8_t kGainScheduleCount = 2;
+
+// Tabela de um id; nullptr se o id não existir (ex.: registro antigo)
+const GainSchedule* gainScheduleFor(uint8_t id);
+
+}  // namespace control
@@ -0,0 +1,380 @@
+#pragma once
+
+// Gerado por tools/mpc_generate.py -- não editar.
+// python3 tools/mpc_generate.py
+//
+// Horizonte 0.04,0.08,0.16,0.32,0.65 s; pesos qe=1 qv=0.002 r=3e-06 terminal=2; grade 81x81.
+// 75 regiões, 276 semiplanos.
+
+#include "control/explicit_mpc.h"
+
+namespace control {
+
+constexpr MpcHalfspace kMpcHalfspaces[] = {
+    {-3107, -16384, 505051153},
+    {3107, 16384, 4318031},
+    {16384, 7291, -76209028},
+    {16384, 7489, -79133716},
+    {-3107, -16384, 4318031},
+    {3107, 16384, 505051153},
+    {-16384, -7291, -76209028},
+    {-16384, -7489, -79133716},
+    {-6717, -16384, 15245157},
+    {6717, 16384, 234842849},
+    {0, 16384, 416611828},
+    {16384, 3604, -84150911},
+    {-6717, -16384, 234842849},
+    {6717, 16384, 15245157},
+    {0, -16384, 416611828},
+    {-16384, -3604, -84150911},
+    {9382, 16384, -442925446},
+    {3107, 16384, -505051153},
+    {-9382, -16384, -442925446},
+    {-3107, -16384, -505051153},
+    {-8281, -16384, -221184024},
+    {8281, 16384, 351677777},
+    {0, 16384, 485331304},
+    {-16384, -1638, 345002779},
+    {16384, 1638, -117836074},
+    {-8281, -16384, 351677777},
+    {8281, 16384, -221184024},
+    {0, -16384, 485331304},
+    {16384, 1638, 345002779},
+    {-16384, -1638, -117836074},
+    {6717, 16384, -15245157},
+    {-3107, -16384, -4318031},
+    {-6717, -16384, -15245157},
+    {3107, 16384, -4318031},
+    {-16384, -7489, 79133716},
+    {16384, 7489, -13962966},
+    {-16384, -3604, 84150911},
+    {16384, 3093, -14217469},
+    {16384, 3493, -17298745},
+    {-16384, -7489, -13962966},
+    {16384, 7489, 79133716},
+    {16384, 3604, 84150911},
+    {-16384, -3093, -14217469},
+    {-16384, -3493, -17298745},
+    {-16384, -7389, 34197242},
+    {16384, 7389, 14046121},
+    {16384, 1638, 117836074},
+    {-16384, -1610, -18870313},
+    {-16384, -7389, 14046121},
+    {16384, 7389, 34197242},
+    {-16384, -1638, 117836074},
+    {16384, 1610, -18870313},
+    {-16384, -7326, -33685270},
+    {16384, 7326, 61665298},
+    {-16384, -654, 142568660},
+    {16384, 621, -24966776},
+    {-16384, -7326, 61665298},
+    {16384, 7326, -33685270},
+    {16384, 654, 142568660},
+    {-16384, -621, -24966776},
+    {0, 16384, -416611828},
+    {-16384, -1638, -401723992},
+    {0, -16384, 485331304},
+    {0, -16384, -416611828},
+    {16384, 1638, -401723992},
+    {0, 16384, 485331304},
+    {-9021, -16384, 412066199},
+    {9021, 16384, -344858865},
+    {0, -16384, 519691043},
+    {16384, 655, 235728760},
+    {-16384, -654, -142568660},
+    {-9021, -16384, -344858865},
+    {9021, 16384, 412066199},
+    {0, 16384, 519691043},
+    {-16384, -655, 235728760},
+    {16384, 654, -142568660},
+    {0, -16384, -485331304},
+    {16384, 655, -245021416},
+    {0, 16384, 519691043},
+    {-16384, -655, 374112929},
+    {0, 16384, -485331304},
+    {-16384, -655, -245021416},
+    {0, -16384, 519691043},
+    {16384, 655, 374112929},
+    {-16384, -7291, 76209028},
+    {16384, 7291, -61260097},
+    {16384, 162, 156914619},
+    {-16384, -108, -29863682},
+    {-16384, -7291, -61260097},
+    {16384, 7291, 76209028},
+    {-16384, -162, 156914619},
+    {16384, 108, -29863682},
+    {0, -16384, -416611828},
+    {0, 16384, 485331304},
+    {-16384, -1638, 401723992},
+    {16384, 1638, -345002779},
+    {0, 16384, -416611828},
+    {0, -16384, 485331304},
+    {16384, 1638, 401723992},
+    {-16384, -1638, -345002779},
+    {0, 16384, 416611828},
+    {8281, 16384, 221184024},
+    {-6717, -16384, -234842849},
+    {-3107, -16384, -267726250},
+    {0, -16384, 416611828},
+    {-8281, -16384, 221184024},
+    {6717, 16384, -234842849},
+    {3107, 16384, -267726250},
+    {0, 16384, -485331304},
+    {-16384, -655, -430843870},
+    {0, -16384, 519691043},
+    {0, -16384, -485331304},
+    {16384, 655, -430843870},
+    {0, 16384, 519691043},
+    {0, 16384, -519691043},
+    {-16384, -164, -260612148},
+    {16384, 164, 389703660},
+    {0, -16384, -519691043},
+    {16384, 164, -260612148},
+    {-16384, -164, 389703660},
+    {-16384, -3493, -1582595},
+    {16384, 3493, 17298745},
+    {16384, 1610, 18870313},
+    {-16384, -1762, -3961196},
+    {-16384, -1941, -4822928},
+    {-16384, -3493, 17298745},
+    {16384, 3493, -1582595},
+    {-16384, -1610, 18870313},
+    {16384, 1762, -3961196},
+    {16384, 1941, -4822928},
+    {0, -16384, -485331304},
+    {0, 16384, 519691043},
+    {-16384, -655, 430843870},
+    {16384, 655, -374112929},
+    {0, 16384, -485331304},
+    {0, -16384, 519691043},
+    {16384, 655, 430843870},
+    {-16384, -655, -374112929},
+    {0, 16384, -519691043},
+    {-16384, -164, -446434601},
+    {0, -16384, -519691043},
+    {16384, 164, -446434601},
+    {-16384, -3232, 8768932},
+    {16384, 3232, 2126872},
+    {16384, 621, 24966776},
+    {-16384, -404, -8030269},
+    {-16384, -3232, 2126872},
+    {16384, 3232, 8768932},
+    {-16384, -621, 24966776},
+    {16384, 404, -8030269},
+    {0, 16384, -519691043},
+    {-16384, -164, -190270369},
+    {16384, 164, 251301048},
+    {0, -16384, -519691043},
+    {16384, 164, -190270369},
+    {-16384, -164, 251301048},
+    {0, 16384, -519691043},
+    {16384, 164, 446434601},
+    {-16384, -164, -389703660},
+    {0, -16384, -519691043},
+    {-16384, -164, 446434601},
+    {16384, 164, -389703660},
+    {-9382, -16384, 442925446},
+    {9382, 16384, -408761146},
+    {16384, 163, 188554683},
+    {-16384, -162, -156914619},
+    {-9382, -16384, -408761146},
+    {9382, 16384, 442925446},
+    {-16384, -163, 188554683},
+    {16384, 162, -156914619},
+    {-16384, -3093, 14217469},
+    {16384, 3093, -8005069},
+    {16384, 108, 29863682},
+    {-16384, 139, -10688520},
+    {-16384, -3093, -8005069},
+    {16384, 3093, 14217469},
+    {-16384, -108, 29863682},
+    {16384, -139, -10688520},
+    {-16384, -1300, 1734051},
+    {16384, 1300, 1734051},
+    {16384, -7316, 39785011},
+    {-16384, 7316, 39785011},
+    {-16384, -1941, 1096810},
+    {16384, 1941, 4822928},
+    {16384, 404, 8030269},
+    {-16384, -1300, -1734051},
+    {-16384, -1941, 4822928},
+    {16384, 1941, 1096810},
+    {-16384, -404, 8030269},
+    {16384, 1300, -1734051},
+    {0, -16384, -485331304},
+    {0, 16384, 519691043},
+    {-16384, -655, 245021416},
+    {16384, 655, -235728760},
+    {0, 16384, -485331304},
+    {0, -16384, 519691043},
+    {16384, 655, 245021416},
+    {-16384, -655, -235728760},
+    {0, 16384, 485331304},
+    {9021, 16384, 344858865},
+    {-8281, -16384, -351677777},
+    {-3107, -16384, -402558456},
+    {0, -16384, 485331304},
+    {-9021, -16384, 344858865},
+    {8281, 16384, -351677777},
+    {3107, 16384, -402558456},
+    {-3107, -16384, 267726250},
+    {-16384, -7389, -14046121},
+    {16384, 7489, 13962966},
+    {3107, 16384, 267726250},
+    {16384, 7389, -14046121},
+    {-16384, -7489, 13962966},
+    {3107, 16384, 402558456},
+    {16384, 7326, 33685270},
+    {-16384, -7389, -34197242},
+    {-16384, -7489, -35111969},
+    {-3107, -16384, 402558456},
+    {-16384, -7326, 33685270},
+    {16384, 7389, -34197242},
+    {16384, 7489, -35111969},
+    {0, 16384, -519691043},
+    {16384, 164, 260612148},
+    {-16384, -164, -251301048},
+    {0, -16384, -519691043},
+    {-16384, -164, 260612148},
+    {16384, 164, -251301048},
+    {-16384, -1762, 3961196},
+    {16384, 1762, -307059},
+    {16384, -139, 10688520},
+    {-16384, 7316, -39785011},
+    {-16384, -1762, -307059},
+    {16384, 1762, 3961196},
+    {-16384, 139, 10688520},
+    {16384, -7316, -39785011},
+    {-3107, -16384, 470756583},
+    {-16384, -7291, 61260097},
+    {16384, 7326, -61665298},
+    {16384, 7489, -63772605},
+    {3107, 16384, 470756583},
+    {16384, 7291, 61260097},
+    {-16384, -7326, -61665298},
+    {-16384, -7489, -63772605},
+    {16384, 7489, 35111969},
+    {16384, 3232, -2126872},
+    {-16384, -3493, 1582595},
+    {-16384, -7489, 35111969},
+    {-16384, -3232, -2126872},
+    {16384, 3493, 1582595},
+    {-16384, -7489, 63772605},
+    {-16384, -3093, 8005069},
+    {16384, 3232, -8768932},
+    {16384, 3493, -10317770},
+    {16384, 7489, 63772605},
+    {16384, 3093, 8005069},
+    {-16384, -3232, -8768932},
+    {-16384, -3493, -10317770},
+    {0, 16384, -519691043},
+    {16384, 164, 190270369},
+    {-16384, -163, -188554683},
+    {0, -16384, -519691043},
+    {-16384, -164, 190270369},
+    {16384, 163, -188554683},
+    {0, 16384, 519691043},
+    {9382, 16384, 408761146},
+    {-9021, -16384, -412066199},
+    {-3107, -16384, -470756583},
+    {0, -16384, 519691043},
+    {-9382, -16384, 408761146},
+    {9021, 16384, -412066199},
+    {3107, 16384, -470756583},
+    {-16384, -3493, 10317770},
+    {-16384, -1762, 307059},
+    {16384, 1941, -1096810},
+    {16384, 3493, 10317770},
+    {16384, 1762, 307059},
+    {-16384, -1941, -1096810},
+};
+
+constexpr MpcRegion kMpcRegions[] = {
+    {0, 4, 0, 0, 32768},
+    {4, 4, 0, 0, -32768},
+    {8, 4, 0, 0, 32768},
+    {12, 4, 0, 0, -32768},
+    {16, 2, 0, 0, 32768},
+    {18, 2, 0, 0, -32768},
+    {20, 5, 0, 0, 32768},
+    {25, 5, 0, 0, -32768},
+    {30, 2, 0, 0, 32768},
+    {32, 2, 0, 0, -32768},
+    {34, 5, 0, 0, 32768},
+    {39, 5, 0, 0, -32768},
+    {44, 4, 0, 0, -32768},
+    {48, 4, 0, 0, 32768},
+    {52, 4, 0, 0, 32768},
+    {56, 4, 0, 0, -32768},
+    {60, 3, 0, 0, -32768},
+    {63, 3, 0, 0, 32768},
+    {66, 5, 0, 0, -32768},
+    {71, 5, 0, 0, 32768},
+    {76, 4, 0, 0, 32768},
+    {80, 4, 0, 0, -32768},
+    {84, 4, -4707276, -2094641, -301332},
+    {88, 4, -4707276, -2094641, 301332},
+    {92, 4, 0, 0, 32768},
+    {96, 4, 0, 0, -32768},
+    {100, 4, 0, 0, 32768},
+    {104, 4, 0, 0, -32768},
+    {108, 3, 0, 0, -32768},
+    {111, 3, 0, 0, 32768},
+    {114, 3, 0, -2048000, -1024000},
+    {117, 3, 0, -2048000, 1024000},
+    {120, 5, 0, 0, -32768},
+    {125, 5, 0, 0, 32768},
+    {130, 4, 0, 0, 32768},
+    {134, 4, 0, 0, -32768},
+    {138, 2, 0, -2048000, -1024000},
+    {140, 2, 0, -2048000, 1024000},
+    {142, 4, 0, 0, -32768},
+    {146, 4, 0, 0, 32768},
+    {150, 3, 0, -2048000, -1024000},
+    {153, 3, 0, -2048000, 1024000},
+    {156, 3, 0, -2048000, -1024000},
+    {159, 3, 0, -2048000, 1024000},
+    {162, 4, -1179475, -2059716, -816878},
+    {166, 4, -1179475, -2059716, 816878},
+    {170, 4, -11327143, -2138193, -117215},
+    {174, 4, -11327143, -2138193, 117215},
+    {178, 4, -20290271, -1609461, 0},
+    {182, 4, 0, 0, -32768},
+    {186, 4, 0, 0, 32768},
+    {190, 4, 0, 0, 32768},
+    {194, 4, 0, 0, -32768},
+    {198, 4, 0, 0, 32768},
+    {202, 4, 0, 0, -32768},
+    {206, 3, 0, 0, -32768},
+    {209, 3, 0, 0, 32768},
+    {212, 4, 0, 0, 32768},
+    {216, 4, 0, 0, -32768},
+    {220, 3, 0, -2048000, -1024000},
+    {223, 3, 0, -2048000, 1024000},
+    {226, 4, -19257281, -2070735, -38275},
+    {230, 4, -19257281, -2070735, 38275},
+    {234, 4, 0, 0, -32768},
+    {238, 4, 0, 0, 32768},
+    {242, 3, 0, 0, 32768},
+    {245, 3, 0, 0, -32768},
+    {248, 4, 0, 0, -32768},
+    {252, 4, 0, 0, 32768},
+    {256, 3, 0, -2048000, -1024000},
+    {259, 3, 0, -2048000, 1024000},
+    {262, 4, 0, 0, 32768},
+    {266, 4, 0, 0, -32768},
+    {270, 3, 0, 0, -32768},
+    {273, 3, 0, 0, 32768},
+};
+
+constexpr MpcTable kMpcTable = {
+    kMpcHalfspaces,
+    sizeof(kMpcHalfspaces) / sizeof(kMpcHalfspaces[0]),
+    kMpcRegions,
+    sizeof(kMpcRegions) / sizeof(kMpcRegions[0]),
+    4000.0f,  // positionRange (passos)
+    2000.0f,  // velocityLimit (passos/s)
+    1600.0f,  // accelLimit (passos/s²)
+};
+
+}  // namespace control
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "control/gain_schedule.h"
+
+namespace control {
+
+// ============================================================================
+// LEI DE CONTROLE PD + LUT (zona de toque → comando do motor)
+// ============================================================================
+//
+// Parte pura (sem FreeRTOS/Arduino) do controlador: roda no ESP32 dentro da
+// control_task e no host (benchmarks e simulações).
+
+// Comando calculado pela lei de controle (steps == 0 → sem movimento)
+struct MotorCommand {
+  int32_t steps;             // Passos relativos, com sinal (direção)
+  float speedInStepsPerSec;  // Velocidade do movimento
+};
+
+// Resultado da LUT para uma zona
+struct ZoneMapping {
+  uint32_t baseSteps;      // Passos base da zona
+  uint32_t speedInterval;  // Intervalo entre pulsos (μs)
+};
+
+// LUT zona → passos base e intervalo entre pulsos
+ZoneMapping mapZone(uint8_t zone);
+
+// Intervalo entre pulsos (μs) → passos por segundo
+float intervalToStepsPerSec(uint32_t speedInterval);
+
+// ============================================================================
+// VARIÁVEIS DE ESTADO DO CONTROLADOR
+// ============================================================================
+// 
+// Em sistemas de controle digital, mantemos um histórico de estados
+// para implementar a equação de diferenças do controlador.
+// 
+// A equação de diferenças é a versão discreta da função de transferência:
+//   y[k] = f(u[k], u[k-1], y[k-1], ...)
+// 
+// Onde:
+//   k = instante de tempo atual
+//   k-1 = instante de tempo anterior
+// ============================================================================
+
+
+// Estado anterior do controlador
+struct ControlState {
+  int32_t lastError;           // Erro anterior: e[k-1]
+  uint8_t lastZone;            // Zona anterior: zona[k-1]
+  bool alternateDirection;     // Direção alternada (para demonstração)
+};
+
+class PdLutLaw {
+ public:
+  // Executa uma amostra da lei de controle e atualiza o estado (z^-1)
+  MotorCommand update(uint8_t zone);
+
+  const ControlState& state() const { return state_; }
+  void reset() { state_ = ControlState{0, 0, false}; }
+
+ private:
+  ControlState state_ = {0, 0, false};
+};
+
+// ============================================================================
+// LEI PD COM ESCALONAMENTO DE GANHOS (substitui a LUT de 4 zonas)
+// ============================================================================
+//
+// Mesma estrutura da PdLutLaw, mas a entrada é contínua (intensidade do
+// toque ou outra variável de escalonamento, 0..kScheduleSpan):
+// passos base, velocidade e Kp/Kd vêm da tabela interpolada e o erro é
+// e[k] = s[k] − s[k−1]. Tudo em inteiros, sem divisão por amostra.
+//
+// direction ±1 fixa o sentido do comando (fontes que sabem para onde o
+// usuário quer ir, como o gesto do slider); 0 mantém a alternância.
+
+struct ScheduledControlState {
+  int32_t lastError;        // e[k-1]
+  uint16_t lastInput;       // s[k-1]
+  bool alternateDirection;  // Direção alternada (para demonstração, direction == 0)
+};
+
+class ScheduledPdLaw {
+ public:
+  explicit ScheduledPdLaw(const GainSchedule& table = defaultGainSchedule())
+      : scheduler_(table) {}
+
+  MotorCommand update(uint16_t input, int8_t direction = 0);
+
+  // Troca a tabela em execução (ex.: outro perfil de carga)
+  void setSchedule(const GainSchedule& table) { scheduler_.setTable(table); }
+  const GainScheduler& scheduler() const { return scheduler_; }
+
+  const ScheduledControlState& state() const { return state_; }
+  void reset() { state_ = ScheduledControlState{0, 0, false}; }
+
+ private:
+  GainScheduler scheduler_;
+  ScheduledControlState state_ = {0, 0, false};
+};
+
+}  // namespace control
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "control/cascade.h"
+
+namespace control {
+
+// ============================================================================
+// LEI PID DA MALHA INTERNA (alternativa à PositionLoop)
+// ============================================================================
+//
+//   v[k] = sat( Kp*e[k] + I[k] - Kd*(y[k] - y[k-1])/dt , ±min(v_max, v_freio) )
+//   I[k+1] = I[k] + Ki*dt*e[k]      (congelado quando saturado: anti-windup)
+//
+// A derivada é tomada sobre a medição, não sobre o erro, para não gerar um
+// impulso a cada degrau de referência da malha externa. Mesma interface da
+// PositionLoop: as duas podem ser trocadas na malha interna e no simulador.
+// dt é o intervalo medido (control/sample_clock.h); sem ele vale o Ts nominal.
+
+struct PidGains {
+  float kp;  // 1/s
+  float ki;  // 1/s^2
+  float kd;  // adimensional
+};
+
+class PidLoop {
+ public:
+  PidLoop(const PidGains& gains, float samplePeriodS, float decelLimit = 0.0f)
+      : gains_(gains), samplePeriodS_(samplePeriodS), decelLimit_(decelLimit) {}
+
+  float update(const PositionSetpoint& setpoint, int32_t measuredSteps) {
+    return update(setpoint, measuredSteps, samplePeriodS_);
+  }
+
+  float update(const PositionSetpoint& setpoint, int32_t measuredSteps, float dtS) {
+    const float error = static_cast<float>(setpoint.positionSteps - measuredSteps);
+    const float measuredDelta =
+        primed_ ? static_cast<float>(measuredSteps - lastMeasured_) : 0.0f;
+    lastMeasured_ = measuredSteps;
+    primed_ = true;
+
+    const float derivative = -gains_.kd * measuredDelta / dtS;
+    const float unclamped = gains_.kp * error + integral_ + derivative;
+    const float velocity =
+        clampVelocity(unclamped, error, setpoint.velocityLimit, decelLimit_);
+
+    // Integra só se a saída não está presa no limite no sentido do erro
+    const bool saturated = (velocity != unclamped) && ((unclamped > 0.0f) == (error > 0.0f));
+    if (!saturated) integral_ += gains_.ki * dtS * error;
+    return velocity;
+  }
+
+  void reset() {
+    integral_ = 0.0f;
+    primed_ = false;
+  }
+
+ private:
+  PidGains gains_;
+  float samplePeriodS_;
+  float decelLimit_;    // passos/s²
+  float integral_ = 0.0f;
+  int32_t lastMeasured_ = 0;
+  bool primed_ = false;
+};
+
+}  // namespace control
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+namespace control {
+
+// ============================================================================
+// PIPELINE SENSOR → CONTROLADOR → ATUADOR COMPOSTO EM TEMPO DE COMPILAÇÃO
+// ============================================================================
+//
+// Cada estágio é um tipo com a mensagem de entrada e de saída:
+//
+//   Fonte:      using Input = void; using Output = M; bool poll(M& out);
+//   Filtro:     using Input = A; using Output = B;
+//               bool process(const A& in, B& out);   // false = nada a repassar
+//   Sumidouro:  using Input = A; using Output = void; void process(const A& in);
+//
+// Stage<Tipo, Contexto> diz em qual task (contexto) o estágio roda.
+// Estágios vizinhos no mesmo contexto são fundidos em chamadas diretas,
+// sem fila, cópia para fila ou troca de contexto. Só onde o contexto muda
+// é criado um canal Channel<M> (fila FreeRTOS no firmware).
+//
+// O grafo é verificado na compilação: saída de cada estágio = entrada do
+// seguinte, fonte no início, sumidouro no fim, mensagens de canal copiáveis
+// por memcpy e os estágios de um mesmo contexto contíguos (uma task tem no
+// máximo um ponto de entrada).
+//
+// Canal (Channel<M>): void init(); bool send(const M&) sem bloqueio;
+//                     bool receive(M&, uint32_t waitTicks).
+
+template <typename Impl, typename Context>
+struct Stage {
+  using Type = Impl;
+  using ContextType = Context;
+};
+
+namespace detail {
+
+template <size_t I, typename... S>
+struct StageAt;
+template <typename S0, typename... R>
+struct StageAt<0, S0, R...> {
+  using type = S0;
+};
+template <size_t I, typename S0, typename... R>
+struct StageAt<I, S0, R...> {
+  using type = typename StageAt<I - 1, R...>::type;
+};
+
+template <typename Ctx, typename... S>
+struct ContextIn : std::false_type {};
+template <typename Ctx, typename S0, typename... R>
+struct ContextIn<Ctx, S0, R...>
+    : std::integral_constant<bool, std::is_same<Ctx, typename S0::ContextType>::value ||
+                                       ContextIn<Ctx, R...>::value> {};
+
+template <typename A, typename B>
+struct SameContext : std::is_same<typename A::ContextType, typename B::ContextType> {};
+
+template <typename... S>
+struct ChannelCount : std::integral_constant<size_t, 0> {};
+template <typename A, typename B, typename... R>
+struct ChannelCount<A, B, R...>
+    : std::integral_constant<size_t, (SameContext<A, B>::value ? 0 : 1) +
+                                         ChannelCount<B, R...>::value> {};
+
+// Ligação fundida: o estágio seguinte é chamado diretamente
+struct DirectLink {
+  void init() {}
+};
+
+template <size_t I>
+using Index = std::integral_constant<size_t, I>;
+
+template <template <typename> class Channel, typename... S>
+class Node;
+
+// Último estágio: sumidouro
+template <template <typename> class Channel, typename A>
+class Node<Channel, A> {
+  using Impl = typename A::Type;
+  static_assert(std::is_void<typename Impl::Output>::value,
+                "o último estágio deve ser um sumidouro (Output = void)");
+
+ public:
+  void init() {}
+
+  void push(const typename Impl::Input& in) { stage_.process(in); }
+
+  template <typename Ctx>
+  uint32_t receive(uint32_t /*waitTicks*/) {
+    return 0;
+  }
+
+  void inject(const typename Impl::Input& in, Index<0>) { push(in); }
+  Impl& stage(Index<0>) { return stage_; }
+
+ private:
+  Impl stage_;
+};
+
+template <template <typename> class Channel, typename A, typename B, typename... R>
+class Node<Channel, A, B, R...> {
+  using Impl = typename A::Type;
+  using Out = typename Impl::Output;
+  using Next = Node<Channel, B, R...>;
+  static constexpr bool kFused = SameContext<A, B>::value;
+  using Fused = std::integral_constant<bool, kFused>;
+
+  static_assert(!std::is_void<Out>::value, "só o último estágio pode ser sumidouro");
+  static_assert(std::is_same<Out, typename B::Type::Input>::value,
+                "saída de um estágio difere da entrada do estágio seguinte");
+  static_assert(kFused || std::is_trivially_copyable<Out>::value,
+                "mensagem que cruza tasks precisa ser copiável por memcpy");
+  static_assert(kFused || !ContextIn<typename A::ContextType, B, R...>::value,
+                "estágios do mesmo contexto devem ser contíguos");
+
+ public:
+  void init() {
+    link_.init();
+    next_.init();
+  }
+
+  // Entrada pelo estágio de origem (só usado no primeiro nó)
+  bool poll() {
+    Out out{};
+    if (!stage_.poll(out)) return false;
+    forward(out, Fused());
+    return true;
+  }
+
+  template <typename In>
+  void push(const In& in) {
+    Out out{};
+    if (stage_.process(in, out)) forward(out, Fused());
+  }
+
+  // Entrada do segmento de Ctx pelo canal que chega nele
+  template <typename Ctx>
+  uint32_t receive(uint32_t waitTicks) {
+    return receiveAt<Ctx>(
+        waitTicks,
+        std::integral_constant<bool, !kFused &&
+                                         std::is_same<Ctx, typename B::ContextType>::value>());
+  }
+
+  template <typename In>
+  void inject(const In& in, Index<0>) {
+    push(in);
+  }
+  template <typename In, size_t I>
+  void inject(const In& in, Index<I>) {
+    next_.inject(in, Index<I - 1>());
+  }
+
+  template <size_t I>
+  typename StageAt<I, A, B, R...>::type::Type& stage(Index<I>) {
+    return stageAt(Index<I>(), std::integral_constant<bool, I == 0>());
+  }
+
+ private:
+  template <size_t I>
+  using NextStage = typename StageAt<(I > 0 ? I - 1 : 0), B, R...>::type::Type;
+
+  Impl& stageAt(Index<0>, std::true_type) { return stage_; }
+  template <size_t I>
+  NextStage<I>& stageAt(Index<I>, std::false_type) {
+    return next_.stage(Index<I - 1>());
+  }
+
+  void forward(const Out& out, std::true_type) { next_.push(out); }
+  void forward(const Out& out, std::false_type) { link_.send(out); }
+
+  template <typename Ctx>
+  uint32_t receiveAt(uint32_t waitTicks, std::true_type) {
+    Out in{};
+    if (!link_.receive(in, waitTicks)) return 0;
+    next_.push(in);
+    return 1;
+  }
+  template <typename Ctx>
+  uint32_t receiveAt(uint32_t waitTicks, std::false_type) {
+    return next_.template receive<Ctx>(waitTicks);
+  }
+
+  Impl stage_;
+  typename std::conditional<kFused, DirectLink, Channel<Out>>::type link_;
+  Next next_;
+};
+
+}  // namespace detail
+
+template <template <typename> class Channel, typename... Stages>
+class Pipeline {
+  static_assert(sizeof...(Stages) >= 2, "pipeline precisa de fonte e sumidouro");
+  using Head = typename detail::StageAt<0, Stages...>::type;
+  static_assert(std::is_void<typename Head::Type::Input>::value,
+                "o primeiro estágio deve ser uma fonte (Input = void)");
+
+ public:
+  static constexpr size_t kStageCount = sizeof...(Stages);
+  static constexpr size_t kChannelCount = detail::ChannelCount<Stages...>::value;
+
+  template <size_t I>
+  using StageType = typename detail::StageAt<I, Stages...>::type::Type;
+  template <size_t I>
+  using ContextAt = typename detail::StageAt<I, Stages...>::type::ContextType;
+
+  // true se algum estágio roda no contexto Ctx (a task precisa existir)
+  template <typename Ctx>
+  static constexpr bool runsIn() {
+    return detail::ContextIn<Ctx, Stages...>::value;
+  }
+
+  // Cria os canais. Chamar uma vez, antes de iniciar as tasks.
+  void init() { root_.init(); }
+
+  // Uma iteração do segmento de Ctx: amostra a fonte (se ela roda em Ctx)
+  // ou recebe uma mensagem do canal de entrada, esperando até waitTicks.
+  // Retorna quantas mensagens entraram no segmento (0 ou 1).
+  template <typename Ctx>
+  uint32_t run(uint32_t waitTicks) {
+    return runIn<Ctx>(waitTicks, std::is_same<Ctx, typename Head::ContextType>());
+  }
+
+  // Entrega uma mensagem diretamente ao estágio I, no contexto de quem
+  // chama (entradas externas: injeção de teste, replay, outro sensor).
+  template <size_t I>
+  void inject(const typename StageType<I>::Input& in) {
+    static_assert(I > 0 && I < sizeof...(Stages), "injeção só em estágios com entrada");
+    root_.inject(in, detail::Index<I>());
+  }
+
+  template <size_t I>
+  StageType<I>& stage() {
+    return root_.stage(detail::Index<I>());
+  }
+
+ private:
+  template <typename Ctx>
+  uint32_t runIn(uint32_t /*waitTicks*/, std::true_type) {
+    return root_.poll() ? 1 : 0;
+  }
+  template <typename Ctx>
+  uint32_t runIn(uint32_t waitTicks, std::false_type) {
+    return root_.template receive<Ctx>(waitTicks);
+  }
+
+  detail::Node<Channel, Stages...> root_;
+};
+
+}  // namespace control
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace control {
+
+// ============================================================================
+// MÉTRICAS DE QUALIDADE DA RESPOSTA (degraus de referência)
+// ============================================================================
+//
+// Recebe amostras (t, r, y) em ordem. Cada mudança de r abre um novo
+// segmento (um degrau, de y no instante da mudança até o novo r); por
+// segmento são medidos:
+//   - tempo de acomodação: último instante fora da faixa ±band do alvo
+//   - overshoot: maior ultrapassagem além do alvo, em % do degrau
+//   - erro em regime: |e| médio nos últimos kSteadyStateFraction do segmento
+// IAE = Σ|e|·dt e ITAE = Σ t·|e|·dt, com t contado desde o início do degrau.
+// O resumo traz o pior caso (acomodação, overshoot) e a média (regime).
+
+struct ResponseSummary {
+  uint32_t segments;       // Degraus avaliados
+  float settlingTimeS;     // Pior tempo de acomodação
+  float overshootPct;      // Pior overshoot
+  float steadyStateError;  // Erro médio em regime (passos)
+  float iae;               // passos·s
+  float itae;              // passos·s²
+  uint32_t unsettled;      // Degraus que terminaram fora da faixa
+};
+
+class ResponseMetrics {
+ public:
+  // band: faixa de acomodação absoluta (passos); bandPct: relativa ao degrau.
+  // Vale a maior das duas.
+  ResponseMetrics(float band, float bandPct) : band_(band), bandPct_(bandPct) {}
+
+  void addSample(float timeS, float reference, float measured);
+
+  // Fecha o último segmento e retorna o resumo.
+  ResponseSummary finish();
+
+ private:
+  static constexpr float kSteadyStateFraction = 0.1f;
+  static constexpr uint32_t kMaxRecent = 512;
+
+  void openSegment(float timeS, float from, float to);
+  void closeSegment();
+
+  float band_;
+  float bandPct_;
+
+  bool active_ = false;
+  float lastReference_ = 0.0f;
+  float lastTime_ = 0.0f;
+
+  // Segmento atual
+  float segmentStart_ = 0.0f;
+  float segmentFrom_ = 0.0f;  // Posição medida no início do degrau
+  float segmentTo_ = 0.0f;
+  float lastOutsideBand_ = 0.0f;
+  float maxOvershoot_ = 0.0f;
+  bool wasOutside_ = false;
+
+  // Janela circular das últimas amostras de |e| (erro em regime)
+  float recentTime_[kMaxRecent] = {};
+  float recentError_[kMaxRecent] = {};
+  uint32_t recentCount_ = 0;
+  uint32_t recentHead_ = 0;
+
+  ResponseSummary summary_ = {};
+  float steadyStateSum_ = 0.0f;
+};
+
+}  // namespace control
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace control {
+
+// ============================================================================
+// AMOSTRAGEM ALINHADA NO TEMPO
+// ============================================================================
+//
+// Uma lei discreta costuma supor que as amostras chegam a cada Ts. Na
+// prática o intervalo varia: jitter do escalonador, amostras perdidas na
+// malha interna, e a malha externa no modo híbrido, que roda a cada entrada
+// nova. A SampleClock recebe o carimbo de cada amostra (µs, hal/clock.h) e
+// devolve o intervalo real desde a anterior. Termos derivativos e
+// integrais usam esse dt no lugar do Ts nominal.
+//
+//   - Primeira amostra (ou após reset): dt = nominal, pois não há anterior.
+//   - Intervalo maior que maxPeriodUs (pausa, entrada após longo silêncio):
+//     limitado a maxPeriodUs, para uma derivada não sumir nem uma integral
+//     saltar.
+//   - Carimbo repetido ou fora de ordem: dt = 1 µs, nunca divisão por zero.
+//
+// Sem dependência de relógio: quem chama passa o carimbo, então o replay
+// (carimbos do log) e o simulador (relógio simulado) reproduzem o mesmo dt.
+
+class SampleClock {
+ public:
+  SampleClock(uint32_t nominalPeriodUs, uint32_t maxPeriodUs)
+      : nominalUs_(nominalPeriodUs), maxUs_(maxPeriodUs), dtUs_(nominalPeriodUs) {}
+
+  // Registra o carimbo da amostra e devolve o intervalo em µs
+  uint32_t sample(int64_t timestampUs) {
+    if (!primed_) {
+      dtUs_ = nominalUs_;
+      primed_ = true;
+    } else {
+      const int64_t elapsed = timestampUs - lastUs_;
+      dtUs_ = (elapsed < 1) ? 1u
+              : (elapsed > maxUs_) ? maxUs_
+                                   : static_cast<uint32_t>(elapsed);
+    }
+    lastUs_ = timestampUs;
+    return dtUs_;
+  }
+
+  void reset() { primed_ = false; }
+
+  uint32_t dtUs() const { return dtUs_; }
+  float dtS() const { return static_cast<float>(dtUs_) * 1e-6f; }
+  uint32_t nominalUs() const { return nominalUs_; }
+
+  // Períodos nominais cobertos pelo último intervalo (1 = em dia; >1 = amostras perdidas)
+  uint32_t periodsElapsed() const { return (dtUs_ + nominalUs_ / 2) / nominalUs_; }
+
+ private:
+  uint32_t nominalUs_;
+  uint32_t maxUs_;
+  uint32_t dtUs_;
+  int64_t lastUs_ = 0;
+  bool primed_ = false;
+};
+
+}  // namespace control
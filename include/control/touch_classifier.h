@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace control {
+
+// ============================================================================
+// THRESHOLDS (LIMIARES) DE CLASSIFICAÇÃO DO TOQUE
+// ============================================================================
+// 
+// O sensor capacitivo ESP32 retorna valores MENORES para toques MAIS FORTES.
+// Quando não tocado, o valor é alto (~70-100).
+// Quando tocado levemente, o valor diminui (~30-50).
+// Quando tocado fortemente, o valor diminui mais (~5-20).
+//
+// Classificamos o toque em 4 zonas baseadas em thresholds:
+//
+//   Valor > 50        → Zona 0: SEM TOQUE
+//   30 < Valor ≤ 50   → Zona 1: TOQUE LEVE
+//   15 < Valor ≤ 30   → Zona 2: TOQUE MÉDIO  
+//   Valor ≤ 15        → Zona 3: TOQUE FORTE
+//
+// Estes thresholds devem ser ajustados experimentalmente para cada sensor.
+// ============================================================================
+
+// Limiar para detectar ausência de toque
+constexpr long kNoTouchThreshold = 50;
+
+// Limiar entre toque leve e médio
+constexpr long kLightTouchThreshold = 30;
+
+// Limiar entre toque médio e forte
+constexpr long kMediumTouchThreshold = 15;
+
+// Converte o valor bruto do sensor em uma zona discreta (0=nenhum, 1=leve,
+// 2=médio, 3=forte). Sem dependência de Arduino: usada pela touch_task e
+// pelos benchmarks no host.
+uint8_t classifyTouchZone(long touchValue);
+
+// ============================================================================
+// INTENSIDADE CONTÍNUA DO TOQUE (variável de escalonamento)
+// ============================================================================
+//
+// Mesma faixa dos thresholds, sem quantizar: 0 = sem toque (valor ≥ 50),
+// 256 = valor 0. Escala por multiplicação em Q8, sem divisão.
+constexpr uint16_t kTouchIntensityMax = 256;
+constexpr uint32_t kTouchIntensityScaleQ8 =
+    (kTouchIntensityMax * 256u + kNoTouchThreshold / 2) / kNoTouchThreshold;
+
+uint16_t touchIntensity(long touchValue);
+
+}  // namespace control
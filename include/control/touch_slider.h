@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "control/sample_clock.h"
+
+namespace control {
+
+// ============================================================================
+// SLIDER CAPACITIVO DE VÁRIOS PADS (posição interpolada e gesto)
+// ============================================================================
+//
+// Uma fileira de pads lida pela máquina de estados de toque do ESP32
+// (hal/touch_slider.h). Cada varredura traz o valor bruto de todos os pads;
+// aqui ela vira:
+//
+//   1. Força por pad: queda relativa à linha de base, em Q8
+//        s[i] = (base[i] − bruto[i]) · 256 / base[i]
+//      (no ESP32 o valor CAI com o toque). A linha de base acompanha a
+//      deriva lenta (temperatura, umidade) só com o slider solto. Um pad
+//      bem ACIMA da base (dedo que estava sobre ele na calibração e saiu)
+//      recalibra na hora; um toque mais longo que kSliderMaxTouchUs é
+//      tratado como base errada: solta e recalibra com a leitura atual.
+//   2. Máquina de toque com histerese e confirmação:
+//        Solto ──(pico ≥ kSliderPressStrength em kSliderPressScans)──> Tocado
+//        Tocado ──(pico < kSliderReleaseStrength em kSliderReleaseScans)──> Solto
+//   3. Posição contínua: centroide do pad de pico e dos dois vizinhos,
+//      pesos acima do piso de ruído. Passo de 256 por pad: com 5 pads,
+//      0..1024 (resolução bem menor que um pad, não 5 posições).
+//   4. Velocidade: derivada da posição com o intervalo medido entre
+//      varreduras (control::SampleClock), suavizada por média exponencial.
+//   5. Gesto: soltar com |v| ≥ kSwipeMinVelocity depois de percorrer ao
+//      menos kSwipeMinTravel vira um "swipe" (jog) com a velocidade final.
+//
+// Tudo em inteiros, uma divisão por pad e uma pelo centroide por varredura.
+
+constexpr uint8_t kSliderMaxPads = 8;
+
+// Posição: 256 unidades entre centros de pads vizinhos
+constexpr int32_t kSliderPadPitch = 256;
+
+// Limiares de força (Q8 da linha de base: 256 = queda de 100%)
+constexpr uint16_t kSliderPressStrength = 40;    // ~16% (toque)
+constexpr uint16_t kSliderReleaseStrength = 24;  // ~9% (soltou)
+constexpr uint16_t kSliderNoiseStrength = 8;     // Piso do centroide
+
+// Varreduras consecutivas para confirmar toque e soltura
+constexpr uint8_t kSliderPressScans = 2;
+constexpr uint8_t kSliderReleaseScans = 3;
+
+// Linha de base: média exponencial α = 1/2^kSliderBaselineShift por varredura
+// (~1 s de constante de tempo a 250 Hz), congelada durante o toque
+constexpr uint8_t kSliderBaselineShift = 8;
+
+// Toque sem soltura por mais que isso (µs) recalibra a linha de base
+constexpr int64_t kSliderMaxTouchUs = 10000000;
+
+// Gesto: velocidade mínima (unidades/s) e percurso mínimo no toque
+constexpr int32_t kSwipeMinVelocity = 3 * kSliderPadPitch;    // 3 pads/s
+constexpr int32_t kSwipeFullVelocity = 20 * kSliderPadPitch;  // Intensidade máxima
+constexpr int32_t kSwipeMinTravel = kSliderPadPitch;          // Um pad
+
+// Posição publicada só quando a intensidade muda mais que isso (de 256)
+constexpr uint16_t kSliderHysteresis = 2;
+
+static_assert(kSliderPressStrength > kSliderReleaseStrength, "Histerese do slider invertida");
+static_assert(kSliderReleaseStrength > kSliderNoiseStrength, "Piso de ruído acima da soltura");
+static_assert(kSwipeFullVelocity > kSwipeMinVelocity, "Faixa do gesto vazia");
+
+enum class SliderEvent : uint8_t {
+  None,     // Solto, ou tocado sem mudança de posição
+  Press,    // Toque confirmado (posição inicial)
+  Move,     // Posição mudou durante o toque
+  Release,  // Soltou sem gesto
+  Swipe,    // Soltou em movimento: jog com a velocidade final
+};
+
+struct SliderReading {
+  int32_t position;   // 0..(pads − 1)·kSliderPadPitch
+  int32_t velocity;   // Unidades de posição por segundo (com sinal)
+  uint16_t strength;  // Força do pad de pico (Q8)
+  bool touched;
+};
+
+class SliderTracker {
+ public:
+  // scanPeriodUs: período nominal da varredura (primeira amostra do dt)
+  SliderTracker(uint8_t padCount, uint32_t scanPeriodUs);
+
+  // Uma varredura: raw[0..padCount) e o instante da leitura (µs, hal/clock.h)
+  SliderEvent update(const uint16_t* raw, int64_t timestampUs, SliderReading& out);
+
+  // Posição → intensidade 1..256 (variável de escalonamento da lei; 0 fica
+  // para "sem toque", como nas outras fontes)
+  uint16_t positionIntensity(int32_t position) const;
+
+  // |velocidade| de um gesto → intensidade 1..256 (kSwipeMin..FullVelocity;
+  // 0 abaixo do mínimo)
+  static uint16_t swipeIntensity(int32_t velocity);
+
+  uint8_t padCount() const { return padCount_; }
+  const SliderReading& reading() const { return reading_; }
+
+  // Esquece linha de base e toque (a próxima varredura recalibra)
+  void reset();
+
+ private:
+  int32_t centroid(const uint16_t* strength, uint8_t peak) const;
+
+  uint8_t padCount_;
+  uint32_t intensityScaleQ16_;  // Posição → intensidade sem divisão
+  SampleClock clock_;
+  int32_t baselineQ4_[kSliderMaxPads] = {};
+  bool primed_ = false;
+  uint8_t confirmScans_ = 0;  // Varreduras seguidas além do limiar da transição
+  int32_t pressPosition_ = 0;
+  int64_t pressUs_ = 0;
+  int32_t velocityQ4_ = 0;
+  SliderReading reading_ = {0, 0, 0, false};
+};
+
+}  // namespace control
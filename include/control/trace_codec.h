@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace control {
+
+// ============================================================================
+// LOG BINÁRIO DE ENTRADAS E SAÍDAS (gravação e replay)
+// ============================================================================
+//
+// Sequência de registros na ordem em que aconteceram: cada entrada do
+// controlador (toque) seguida das saídas que ela produziu (comando ao
+// atuador). As saídas não têm carimbo de tempo próprio, de modo que um
+// replay determinístico reproduz o arquivo byte a byte, em qualquer
+// velocidade.
+//
+// Formato (little-endian):
+//   Cabeçalho: 'T' 'R' 'C' versão  tickHz(u32)
+//   Entrada:   0x10|sentido<<2|zona  varint(Δtick) zigzag(ΔtouchValue) zigzag(Δintensity)
+//              (sentido: 0 = a lei escolhe, 1 = +, 2 = −; logs antigos têm 0)
+//   Saída:     0x20       zigzag(Δsteps) varint(bits(speed) XOR bits(anterior))
+// Deltas em relação ao registro anterior do mesmo tipo: um toque típico
+// ocupa 4 a 6 bytes e um comando 3 a 6.
+
+constexpr uint8_t kTraceVersion = 1;
+constexpr size_t kTraceHeaderBytes = 8;
+constexpr size_t kTraceMaxRecordBytes = 20;
+
+struct TraceInput {
+  uint32_t tick;       // Carimbo em 1/tickHz s (µs; ticks do RTOS em logs antigos)
+  int32_t touchValue;  // Valor bruto do sensor
+  uint8_t touchZone;
+  uint16_t intensity;  // Variável de escalonamento entregue à lei
+  int8_t direction;    // Sentido pedido pela fonte (−1, 0, +1)
+};
+
+struct TraceOutput {
+  int32_t steps;             // Passos relativos do comando
+  float speedInStepsPerSec;  // Comparada pelos bits (replay exato)
+};
+
+enum class TraceRecordKind : uint8_t { Input, Output };
+
+struct TraceRecord {
+  TraceRecordKind kind;
+  TraceInput input;    // Válido se kind == Input
+  TraceOutput output;  // Válido se kind == Output
+};
+
+class TraceEncoder {
+ public:
+  // Escreve o cabeçalho (kTraceHeaderBytes) e zera o estado dos deltas
+  size_t begin(uint8_t* out, uint32_t tickHz);
+
+  // Codifica um registro em out (até kTraceMaxRecordBytes). Retorna o tamanho.
+  size_t write(const TraceRecord& record, uint8_t* out);
+
+ private:
+  TraceInput lastInput_ = {};
+  TraceOutput lastOutput_ = {};
+};
+
+class TraceDecoder {
+ public:
+  TraceDecoder(const uint8_t* data, size_t size);
+
+  // Cabeçalho reconhecido (magic e versão)
+  bool valid() const { return valid_; }
+  uint32_t tickHz() const { return tickHz_; }
+
+  // Próximo registro. false no fim dos dados ou em registro corrompido
+  // (corrupted() distingue os dois casos).
+  bool next(TraceRecord& record);
+  bool corrupted() const { return corrupted_; }
+  size_t offset() const { return offset_; }
+
+ private:
+  bool readVarint(uint32_t& value);
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool valid_ = false;
+  bool corrupted_ = false;
+  uint32_t tickHz_ = 0;
+  TraceInput lastInput_ = {};
+  TraceOutput lastOutput_ = {};
+};
+
+// Resultado da comparação registro a registro
+struct TraceDiff {
+  bool identical;        // Mesmos registros, bit a bit
+  uint32_t records;      // Registros comparados até a primeira diferença
+  uint32_t inputs;       // Entradas entre eles
+  uint32_t outputs;      // Saídas entre eles
+  size_t expectedOffset; // Posição da primeira diferença em cada log
+  size_t actualOffset;
+};
+
+TraceDiff diffTraces(const uint8_t* expected, size_t expectedSize, const uint8_t* actual,
+                     size_t actualSize);
+
+}  // namespace control
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace control {
+
+// ============================================================================
+// TRAJETÓRIA PLANEJADA E FEEDFORWARD (malha interna)
+// ============================================================================
+//
+// A malha externa só desloca o alvo (PositionSetpoint). O gerador de
+// trajetória transforma cada novo alvo num perfil trapezoidal amostrado na
+// taxa da malha interna: posição, velocidade e aceleração planejadas para
+// cada amostra, com |v| ≤ velocityLimit e |a| ≤ accelLimit. O perfil é
+// recalculado a cada amostra, então um alvo novo no meio do movimento
+// apenas muda o destino, sem parada.
+//
+// Com a referência planejada, a lei não precisa esperar o erro crescer:
+//   v[k] = sat( Kvff·v_ref[k] + Kaff·a_ref[k] + Kp·(p_ref[k] − y[k]) )
+// Kvff ≈ 1 entrega a velocidade planejada diretamente; Kaff (em segundos)
+// adianta o comando para compensar o atraso do atuador e da carga durante
+// as rampas. O Kp fica só com o resíduo e pode continuar modesto.
+
+struct TrajectorySample {
+  float position;      // Passos
+  float velocity;      // Passos/s
+  float acceleration;  // Passos/s²
+};
+
+class TrajectoryGenerator {
+ public:
+  TrajectoryGenerator(float accelLimit, float samplePeriodS)
+      : accelLimit_(accelLimit), samplePeriodS_(samplePeriodS) {}
+
+  // Parado em position (partida, retomada após falha)
+  void reset(float position);
+
+  // Avança uma amostra em direção a targetSteps (Ts nominal)
+  const TrajectorySample& update(int32_t targetSteps, float velocityLimit) {
+    return update(targetSteps, velocityLimit, samplePeriodS_);
+  }
+
+  // Idem, integrando o intervalo medido desde a amostra anterior
+  // (control/sample_clock.h): amostras perdidas não atrasam o perfil
+  const TrajectorySample& update(int32_t targetSteps, float velocityLimit, float dtS);
+
+  const TrajectorySample& sample() const { return sample_; }
+
+ private:
+  float accelLimit_;     // Passos/s²
+  float samplePeriodS_;
+  TrajectorySample sample_ = {0.0f, 0.0f, 0.0f};
+};
+
+struct FeedforwardGains {
+  float kp;    // 1/s (realimentação de posição)
+  float kvff;  // Adimensional
+  float kaff;  // s
+};
+
+// Lei da malha interna com feedforward. Saturação em 1,25 × a maior entre a
+// velocidade planejada e o limite: folga para a realimentação recuperar
+// atraso sem deixar o comando disparar. O limite de frenagem da PositionLoop
+// não é necessário aqui: a própria trajetória já freia com accelLimit.
+class FeedforwardLoop {
+ public:
+  explicit FeedforwardLoop(const FeedforwardGains& gains) : gains_(gains) {}
+
+  float update(const TrajectorySample& reference, float velocityLimit,
+               int32_t measuredSteps) const;
+
+ private:
+  FeedforwardGains gains_;
+};
+
+}  // namespace control
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hal/clock.h"
+
+namespace hal {
+
+// ============================================================================
+// ANALOG SETPOINT INPUT - ESP32 continuous (DMA) ADC
+// ============================================================================
+//
+// ADC1 samples kAnalogInputPin continuously at kAnalogSampleRateHz; the
+// digital controller writes the conversions to RAM through DMA and the
+// driver collects them in a ring buffer. No task or ISR runs per sample:
+// the consumer drains the buffer a few times per second and reduces each
+// drain to a block (decimation by averaging).
+
+// Conversions reduced by one drainAnalogInput() call.
+struct AnalogBlock {
+  uint32_t samples;         // Conversions in this block (0 = nothing new)
+  uint32_t sum;             // Sum of the 12-bit raw values
+  uint16_t min;
+  uint16_t max;
+  bool overrun;             // Driver ring buffer overflowed since the last drain
+  TimestampUs timestampUs;  // Drain time; the newest conversion is at most one DMA frame older
+};
+
+// Configures ADC1 continuous mode and starts the conversions. Returns false
+// when the driver cannot be installed.
+bool initAnalogInput();
+
+// True after a successful initAnalogInput().
+bool isAnalogInputReady();
+
+// Reads everything the DMA wrote since the last call, without blocking.
+// Returns false when there is nothing new (block.samples == 0).
+bool drainAnalogInput(AnalogBlock& block);
+
+}  // namespace hal
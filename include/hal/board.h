@@ -25,6 +25,62 @@ constexpr uint8_t kStepperEnablePin = 18;     // ENA - LOW=enabled, HIGH=disable
 constexpr uint8_t kStepperDirectionPin = 17;  // DIR - direction control
 constexpr uint8_t kStepperPulsePin = 16;      // PUL/STEP - step pulse
 
+// 17HS4401S: 1.8 deg/step. TB6600 microstep resolution is set by DIP switches.
+constexpr int32_t kStepperFullStepsPerRev = 200;
+constexpr int32_t kStepperMicrosteps = 1;
+constexpr int32_t kStepperStepsPerRev = kStepperFullStepsPerRev * kStepperMicrosteps;
+
+// Optional quadrature encoder on axis 0 (read by PCNT unit 0).
+// Off by default: GPIO34/35 have no internal pull-ups, so unconnected inputs
+// float and would read as a stalled axis. Set to true once one is fitted.
+constexpr bool kHasEncoder = false;
+constexpr uint8_t kEncoderAPin = 34;              // Input-only pin, external pull-up
+constexpr uint8_t kEncoderBPin = 35;              // Input-only pin, external pull-up
+constexpr int32_t kEncoderCountsPerRev = 2400;    // 600 PPR x4 quadrature decoding
+
+// Analog setpoint input (potentiometer or 0-10 V signal) on ADC1 channel 0.
+// A 0-10 V source needs a divider to stay below ~3.1 V at 11 dB attenuation
+// (e.g. 22k / 10k). ADC1 only: ADC2 is shared with Wi-Fi.
+constexpr uint8_t kAnalogInputPin = 36;           // GPIO36 = ADC1_CH0, input-only
+constexpr uint32_t kAnalogSampleRateHz = 20000;   // Lowest rate of the ESP32 DMA mode
+
+// Capacitive touch slider: touch channels in physical order along the strip
+// (hal/touch_slider.h). T0 is the single touch pad of the default source, so
+// the slider and TouchSensorStage are alternatives, not used together.
+// GPIO12 (T5) is a strapping pin: the bare electrode must not pull it high.
+constexpr uint8_t kTouchSliderPads[] = {0, 3, 4, 5, 6};  // T0, T3-T6 = GPIO4, 15, 13, 12, 14
+constexpr uint8_t kTouchSliderPadCount = sizeof(kTouchSliderPads) / sizeof(kTouchSliderPads[0]);
+constexpr uint32_t kTouchSliderScanHz = 250;  // Reads of the latest FSM results
+
+// Marker for optional pins that are not wired.
+constexpr uint8_t kNoPin = 0xFF;
+
+// Pin set of one stepper axis (one TB6600 driver plus optional limit switches).
+// Limit switches are active HIGH: min stops motion towards -, max towards +.
+struct StepperAxisPins {
+  uint8_t pulsePin;
+  uint8_t directionPin;
+  uint8_t enablePin;
+  uint8_t limitMinPin;
+  uint8_t limitMaxPin;
+};
+
+// Stepper axis table - add one row per driver (up to motion::kMaxAxes).
+// Step, direction and limit pins must be below GPIO32 (fast GPIO.out/in access).
+constexpr StepperAxisPins kStepperAxes[] = {
+    {kStepperPulsePin, kStepperDirectionPin, kStepperEnablePin, kLimitBtn1Pin, kLimitBtn2Pin},
+};
+
+constexpr uint8_t kStepperAxisCount = sizeof(kStepperAxes) / sizeof(kStepperAxes[0]);
+
+// ============================================================================
+// HARDWARE TIMER ALLOCATION (ESP32 general-purpose timers 0..3)
+// ============================================================================
+
+constexpr uint8_t kInputDebounceTimer = 0;  // Shared debounce/long-press timer
+constexpr uint8_t kStepperTimer = 1;        // Step generator tick (all axes)
+constexpr uint8_t kControlTimer = 2;        // Inner control loop sample clock
+
 // ============================================================================
 // HARDWARE INITIALIZATION AND CONTROL
 // ============================================================================
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_timer.h>
+#endif
+
+namespace hal {
+
+// ============================================================================
+// HIGH-RESOLUTION TIME BASE
+// ============================================================================
+//
+// Every timestamp in the message path comes from this clock: signed 64-bit
+// microseconds since boot. It never wraps in practice (~292,000 years), so
+// an interval is a plain subtraction, with no tick-rate conversion and no
+// 1-10 ms RTOS tick granularity.
+//
+// On the ESP32 it is esp_timer (ISR-safe; forced inline so IRAM handlers
+// can call it). Native builds (sim/) have no esp_timer: the clock is
+// simulated and only moves when the simulation advances it, which keeps
+// host runs deterministic.
+
+using TimestampUs = int64_t;
+
+constexpr int64_t kMicrosPerSecond = 1000000;
+
+#if defined(ESP_PLATFORM)
+
+__attribute__((always_inline)) inline TimestampUs nowUs() { return esp_timer_get_time(); }
+
+#else
+
+TimestampUs nowUs();
+
+// Simulated clock (native builds only)
+void setSimulatedTimeUs(TimestampUs timeUs);
+void advanceSimulatedTimeUs(int64_t deltaUs);
+
+#endif
+
+}  // namespace hal
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace hal {
+
+// ============================================================================
+// QUADRATURE ENCODER - ESP32 Pulse Counter (PCNT)
+// ============================================================================
+//
+// Both encoder channels are decoded x4 entirely in hardware: no CPU work per
+// edge. The 16-bit hardware counter is extended to 64 bits by an ISR that
+// runs only when the counter reaches one of its limits.
+
+// Configures PCNT unit 0 on kEncoderAPin/kEncoderBPin. Returns false when
+// kHasEncoder is false or the driver cannot be installed.
+bool initEncoder();
+
+// True after a successful initEncoder().
+bool isEncoderReady();
+
+// Accumulated count since init (or the last reset), in quadrature counts.
+// A read that lands between the hardware wrap at the counter limit and the
+// overflow ISR is corrected against the previous read, so reads must be
+// less than half a limit (16000 counts) of travel apart; the stepper task
+// supervision (10 ms) guarantees that.
+int64_t readEncoderCount();
+
+// Sets the accumulated count (e.g. after homing or a resync).
+void resetEncoderCount(int64_t value = 0);
+
+}  // namespace hal
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+
+#include "hal/clock.h"
+
+namespace hal {
+
+// ============================================================================
+// INTERRUPT-DRIVEN INPUT EVENTS - Buttons and Limit Switches
+// ============================================================================
+//
+// Edges are timestamped in the GPIO ISR. A single shared hardware timer
+// performs debouncing and long-press detection for every input, so no task
+// polls the pins. Debounced events are delivered through a FreeRTOS queue.
+
+// Logical identifiers of the debounced inputs.
+enum class InputId : uint8_t {
+  UserBtn1 = 0,
+  UserBtn2 = 1,
+  UserBtn3 = 2,
+  LimitBtn1 = 3,
+  LimitBtn2 = 4,
+  Count
+};
+
+// Event kinds. LongPress is only generated for user buttons.
+enum class InputEventType : uint8_t { Press = 0, Release = 1, LongPress = 2 };
+
+// Message delivered to the application for each debounced transition.
+struct InputEvent {
+  InputId id;
+  InputEventType type;
+  TimestampUs timestampUs;  // Time of the first edge (hal/clock.h, microseconds)
+};
+
+// Debounce window: the level must stay stable (no further edges) this long
+// before a transition is accepted. Each bounce edge restarts the window; the
+// event keeps the timestamp of the first edge.
+constexpr uint32_t kInputDebounceUs = 20000;
+
+// Hold time for a LongPress event (measured from the debounced press edge).
+constexpr uint32_t kInputLongPressUs = 800000;
+
+// Installs the GPIO edge interrupts and the shared debounce timer.
+// Must be called after initBoard(). Returns false if resources are missing.
+bool initInputEvents();
+
+// Waits up to ticksToWait for the next event. Returns true when evt was filled.
+bool receiveInputEvent(InputEvent& evt, TickType_t ticksToWait = portMAX_DELAY);
+
+// Debounced level of an input (true = pressed / activated).
+bool isInputActive(InputId id);
+
+// Counters of the event queue, same meaning as the channel stats
+// (tasks/channel.h). An event posted while the queue is full is lost and
+// counted in dropped.
+struct InputEventStats {
+  uint32_t capacity;  // Queue length
+  uint32_t depth;     // Events pending now
+  uint32_t posted;    // Events accepted by the queue
+  uint32_t dropped;   // Events lost because the queue was full
+};
+
+InputEventStats getInputEventStats();
+
+}  // namespace hal
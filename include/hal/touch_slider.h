@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hal/board.h"
+#include "hal/clock.h"
+
+namespace hal {
+
+// ============================================================================
+// CAPACITIVE TOUCH SLIDER - ESP32 touch sensor FSM in timer mode
+// ============================================================================
+//
+// The touch peripheral measures every pad in kTouchSliderPads on its own,
+// in hardware, at a few hundred Hz (timer-triggered FSM). No touchRead()
+// call ever waits for a measurement: a periodic esp_timer callback copies
+// the latest results of all pads (register reads) into a queue at
+// kTouchSliderScanHz, each scan stamped with hal::nowUs(). The consumer
+// drains the queue once per control period and sees every scan with its
+// own timestamp, so position changes and velocities keep the scan rate.
+
+// Latest FSM results of all slider pads.
+struct TouchSliderScan {
+  TimestampUs timestampUs;             // When the results were read
+  uint16_t raw[kTouchSliderPadCount];  // Raw count per pad (lower = touched)
+};
+
+// Configures the touch pads, starts the FSM and the scan timer. Returns
+// false when the driver cannot be installed.
+bool initTouchSlider();
+
+// True after a successful initTouchSlider().
+bool isTouchSliderReady();
+
+// Oldest unread scan, without blocking. Returns false when none is pending.
+bool readTouchSliderScan(TouchSliderScan& scan);
+
+// Scans dropped because the consumer fell behind, since initTouchSlider().
+uint32_t getTouchSliderOverruns();
+
+}  // namespace hal
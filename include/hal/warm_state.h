@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace hal {
+
+// ============================================================================
+// WARM-START STATE - survives software resets, panics and watchdog resets
+// ============================================================================
+//
+// Kept in RTC slow memory that the bootloader does not clear. A magic word,
+// a layout version and a CRC mark the record as valid; anything else (power
+// on, brown-out, corrupted or half-written record) is a cold start and
+// requires homing.
+//
+// Positions are mirrored every few ms, so a reset in the middle of a move
+// could restore a stale one. The record is therefore marked as moving
+// before the first step of every move and cleared, together with the final
+// positions, once the axes are at rest; a moving record is a cold start.
+//
+// The record also keeps the runtime-selected parameters (velocity-mode
+// acceleration, active gain schedule). They do not depend on the axes being
+// at rest and are restored on every warm boot.
+
+constexpr uint8_t kWarmStateMaxAxes = 4;
+
+struct WarmState {
+  int32_t axisPositions[kWarmStateMaxAxes];  // Commanded position of each axis, in steps
+  float velocityAccel;                       // Velocity-mode acceleration (steps/s²); 0 = default
+  uint8_t axisCount;                         // Axes described by this record
+  uint8_t moving;                            // Axes were in motion: positions not trustworthy
+  uint8_t fault;                             // Latched actuator fault (tasks::StepperFault)
+  uint8_t gainSchedule;                      // Active gain schedule (control::GainScheduleId)
+};
+
+// Returns true and fills state when a valid record survived the last reset;
+// otherwise starts a fresh (cold) record. The first call (at boot) decides;
+// later calls, from other tasks restoring their own fields, get the same
+// boot snapshot.
+bool restoreWarmState(WarmState& state);
+
+// Field updates: RAM write + CRC, cheap enough to call every few ms.
+void storeWarmAxisPositions(const int32_t* positions, uint8_t axisCount);
+void storeWarmFault(uint8_t fault);
+void storeWarmVelocityAccel(float accel);
+void storeWarmGainSchedule(uint8_t schedule);
+
+// Marks a move as started (before its first step pulse).
+void storeWarmMoving();
+
+// Final positions of a finished move; clears the moving mark in the same write.
+void storeWarmAtRest(const int32_t* positions, uint8_t axisCount);
+
+// Drops the record so the next boot is cold (e.g. after homing is lost).
+void invalidateWarmState();
+
+}  // namespace hal
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "motion/step_generator.h"
+
+namespace motion {
+
+// ============================================================================
+// SPEED PLANNING: RESONANCE BANDS AND MICROSTEP SCALING
+// ============================================================================
+//
+// A hybrid stepper loses torque when it runs steadily inside its mid-band
+// resonance. The bands depend on the electrical frequency, i.e. the
+// full-step rate, so they are configured in full steps per second and
+// scaled by the microstep resolution before use:
+//   - a cruise speed strictly inside a band is moved to the nearest edge
+//     (the lower edge when the upper one is above the speed ceiling);
+//   - ramps crossing a band use the acceleration multiplied by
+//     2^bandAccelShift, so the motor spends as little time there as possible.
+//
+// Everything here runs in task context; the generator only sees the bands
+// in Q0.32 and one precomputed shift.
+
+// Open interval (lowFullStepsPerSec, highFullStepsPerSec); edges are safe.
+struct ResonanceBand {
+  uint32_t lowFullStepsPerSec;
+  uint32_t highFullStepsPerSec;
+};
+
+struct SpeedProfileConfig {
+  int32_t fullStepsPerRev;     // Motor full steps per revolution (200 for 1.8 deg)
+  int32_t microsteps;          // Driver microstep resolution (TB6600 DIP switches)
+  const ResonanceBand* bands;  // Sorted, non-overlapping (see resonanceBandsValid)
+  uint8_t bandCount;           // Up to kMaxVelocityBands
+  uint8_t bandAccelShift;      // Ramp acceleration x2^shift inside a band
+  uint32_t maxStepsPerSec;     // Step-rate ceiling of the generator (microsteps/s)
+};
+
+// ---------------------------------------------------------------------------
+// Compile-time band logic (C++11 constexpr: checked by static_assert)
+// ---------------------------------------------------------------------------
+
+// Bands are sorted by speed, each one non-empty and above the previous one.
+constexpr bool resonanceBandsValid(const ResonanceBand* bands, size_t count, size_t i = 0) {
+  return i >= count ||
+         (bands[i].lowFullStepsPerSec < bands[i].highFullStepsPerSec &&
+          (i == 0 || bands[i - 1].highFullStepsPerSec <= bands[i].lowFullStepsPerSec) &&
+          resonanceBandsValid(bands, count, i + 1));
+}
+
+// Index of the band that strictly contains stepsPerSec, or -1.
+constexpr int findResonanceBand(uint32_t stepsPerSec, const ResonanceBand* bands, size_t count,
+                                int32_t microsteps, size_t i = 0) {
+  return (i >= count) ? -1
+         : (stepsPerSec > bands[i].lowFullStepsPerSec * static_cast<uint32_t>(microsteps) &&
+            stepsPerSec < bands[i].highFullStepsPerSec * static_cast<uint32_t>(microsteps))
+             ? static_cast<int>(i)
+             : findResonanceBand(stepsPerSec, bands, count, microsteps, i + 1);
+}
+
+// Nearest edge of one band (ties and an unreachable upper edge go down).
+constexpr uint32_t bandEdgeFor(uint32_t stepsPerSec, uint32_t low, uint32_t high,
+                               uint32_t maxStepsPerSec) {
+  return (high > maxStepsPerSec || stepsPerSec - low <= high - stepsPerSec) ? low : high;
+}
+
+// Cruise speed with the bands skipped. Sorted, non-overlapping bands make a
+// single pass enough: an edge is never strictly inside another band.
+constexpr uint32_t skipResonanceBands(uint32_t stepsPerSec, const ResonanceBand* bands,
+                                      size_t count, int32_t microsteps, uint32_t maxStepsPerSec) {
+  return (findResonanceBand(stepsPerSec, bands, count, microsteps) < 0)
+             ? stepsPerSec
+             : bandEdgeFor(
+                   stepsPerSec,
+                   bands[findResonanceBand(stepsPerSec, bands, count, microsteps)].lowFullStepsPerSec *
+                       static_cast<uint32_t>(microsteps),
+                   bands[findResonanceBand(stepsPerSec, bands, count, microsteps)].highFullStepsPerSec *
+                       static_cast<uint32_t>(microsteps),
+                   maxStepsPerSec);
+}
+
+// 17HS4401S on a TB6600 (24 V): natural low-speed resonance and the
+// mid-band instability region. Starting values; refine per machine with the
+// frequency sweep or by ear while ramping slowly through the range.
+constexpr ResonanceBand k17HS4401SResonanceBands[] = {
+    {100, 160},  // ~0.5-0.8 rev/s
+    {700, 1000}, // ~3.5-5 rev/s
+};
+constexpr uint8_t k17HS4401SResonanceBandCount =
+    sizeof(k17HS4401SResonanceBands) / sizeof(k17HS4401SResonanceBands[0]);
+
+static_assert(resonanceBandsValid(k17HS4401SResonanceBands, k17HS4401SResonanceBandCount),
+              "Resonance bands must be sorted and non-overlapping");
+static_assert(k17HS4401SResonanceBandCount <= kMaxVelocityBands,
+              "More resonance bands than the step generator handles");
+
+// ---------------------------------------------------------------------------
+// Runtime planner
+// ---------------------------------------------------------------------------
+
+class SpeedPlanner {
+ public:
+  explicit SpeedPlanner(const SpeedProfileConfig& config);
+
+  // Cruise speed (microsteps/s) clamped to the ceiling and moved out of the
+  // bands. The sign is kept, so velocity-mode targets can use it too.
+  float planCruise(float stepsPerSec) const;
+
+  // Loads the bands, scaled to the tick rate, into the generator. Call while idle.
+  void applyTo(StepGenerator& generator, uint32_t tickHz) const;
+
+  int32_t stepsPerRev() const { return config_.fullStepsPerRev * config_.microsteps; }
+  float revsPerSecToStepsPerSec(float revsPerSec) const {
+    return revsPerSec * static_cast<float>(stepsPerRev());
+  }
+  float stepsPerSecToRevsPerSec(float stepsPerSec) const {
+    return stepsPerSec / static_cast<float>(stepsPerRev());
+  }
+
+  const SpeedProfileConfig& config() const { return config_; }
+
+ private:
+  uint32_t skipBands(uint32_t stepsPerSec) const;
+
+  SpeedProfileConfig config_;
+};
+
+}  // namespace motion
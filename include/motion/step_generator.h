@@ -0,0 +1,265 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace motion {
+
+// ============================================================================
+// COORDINATED STEP GENERATOR (DDA + BRESENHAM)
+// ============================================================================
+//
+// One timing source (a periodic tick) drives every axis. The dominant axis
+// (largest |delta|) advances through a phase accumulator whose increment is
+// the current velocity; the other axes follow it with Bresenham error terms,
+// so all axes start and finish on the same tick.
+//
+// A second mode streams velocity instead of positions: each axis slews its
+// own phase-accumulator velocity towards a target that can be rewritten at
+// any time (latest value wins), with no planning and no stop between updates.
+//
+// Both modes ramp faster through configured velocity bands (motor
+// resonance, see motion/speed_profile.h).
+//
+// Only integer arithmetic is used: tick() runs inside a timer ISR, where the
+// ESP32 FPU must not be touched.
+
+// Maximum number of axes handled by one generator.
+constexpr uint8_t kMaxAxes = 4;
+
+// Velocities are expressed in steps per tick, Q0.32 (2^32 = one step/tick).
+// A step pulse needs one tick high and one tick low, so the ceiling is 0.5.
+// Signed velocities (velocity mode) use the same scale in an int32_t.
+constexpr uint32_t kMaxVelocityQ32 = 0x7FFFFFFFu;
+
+// Converts physical units to tick units (task context only: uses float).
+uint32_t stepsPerSecToQ32(float stepsPerSec, uint32_t tickHz);
+uint32_t stepsPerSecSecToQ32(float stepsPerSecSec, uint32_t tickHz);
+int32_t signedStepsPerSecToQ32(float stepsPerSec, uint32_t tickHz);
+
+// Velocity interval crossed with boosted acceleration: (lowQ32, highQ32).
+struct VelocityBand {
+  uint32_t lowQ32;
+  uint32_t highQ32;
+};
+
+constexpr uint8_t kMaxVelocityBands = 2;
+
+// Description of one coordinated straight-line move.
+struct LinearMove {
+  int32_t deltas[kMaxAxes];    // Relative steps per axis
+  uint32_t cruiseVelocityQ32;  // Dominant-axis cruise velocity
+  uint32_t accelQ32;           // Velocity increment per tick
+  uint32_t minVelocityQ32;     // Floor used at start and end of the ramp
+};
+
+class StepGenerator {
+ public:
+  enum class Mode : uint8_t { Idle = 0, Linear = 1, Velocity = 2 };
+
+  // Sets the number of active axes (1..kMaxAxes). Call while idle.
+  void configure(uint8_t axisCount);
+
+  // Ramps inside any of the bands use accel << accelShift (up to
+  // kMaxVelocityBands; count 0 disables). Call while idle.
+  void setVelocityBands(const VelocityBand* bands, uint8_t count, uint8_t accelShift);
+
+  // Starts a move. Returns false (and stays as is) when not idle, the move is
+  // empty or its cruise velocity is zero (it would never step).
+  bool start(const LinearMove& move);
+
+  // Enters velocity mode with every axis at rest. Returns false when not idle.
+  // The mode ends by itself when no target arrives for watchdogTicks.
+  bool startVelocity(uint32_t accelQ32, uint32_t watchdogTicks);
+
+  // Latest-value mailbox: safe to call from any context at any rate.
+  void setTargetVelocity(uint8_t axis, int32_t velocityQ32);
+  void setVelocityAccel(uint32_t accelQ32) { velocityAccel_ = (accelQ32 == 0) ? 1 : accelQ32; }
+
+  // Ramps every axis to zero, then returns to Idle.
+  void requestVelocityStop() { stopRequested_ = true; }
+
+  // Hard-stops the given axes in velocity mode (limit switches).
+  void haltAxes(uint8_t mask);
+
+  // Aborts the current move immediately (no deceleration).
+  void stop();
+
+  // Advances one tick. Returns the mask of axes that must pulse now.
+  inline uint8_t tick();
+
+  Mode mode() const { return mode_; }
+  bool busy() const { return mode_ != Mode::Idle; }
+  uint8_t axisCount() const { return axisCount_; }
+  uint8_t activeMask() const { return activeMask_; }      // Axes currently moving
+  uint8_t negativeMask() const { return negativeMask_; }  // Axes moving in -direction
+  uint32_t velocityQ32() const { return velocity_; }
+
+  int32_t position(uint8_t axis) const;
+  void setPosition(uint8_t axis, int32_t steps);
+
+ private:
+  inline uint8_t tickLinear();
+  inline uint8_t tickVelocity();
+  inline bool inBand(uint32_t velocity) const;
+  inline uint32_t boosted(uint32_t accel) const;
+
+  uint8_t axisCount_ = 1;
+  volatile Mode mode_ = Mode::Idle;
+  uint8_t activeMask_ = 0;
+  uint8_t negativeMask_ = 0;
+  bool decelerating_ = false;
+
+  volatile int32_t position_[kMaxAxes] = {};
+
+  // Resonance bands (both modes)
+  VelocityBand bands_[kMaxVelocityBands] = {};
+  uint8_t bandCount_ = 0;
+  uint8_t bandAccelShift_ = 0;
+
+  // Linear (coordinated) mode
+  uint32_t absDelta_[kMaxAxes] = {};
+  uint32_t error_[kMaxAxes] = {};
+  uint32_t totalSteps_ = 0;  // Steps of the dominant axis
+  uint32_t stepsDone_ = 0;
+  uint32_t stepsAccel_ = 0;  // Steps spent accelerating (mirrors the decel ramp)
+  uint32_t phase_ = 0;
+  uint32_t velocity_ = 0;
+  uint32_t cruise_ = 0;
+  uint32_t accel_ = 0;
+  uint32_t bandAccel_ = 0;  // accel_ boosted for the bands
+  uint32_t minVelocity_ = 0;
+
+  // Velocity (streaming) mode
+  volatile int32_t targetVelocity_[kMaxAxes] = {};
+  int32_t axisVelocity_[kMaxAxes] = {};
+  uint32_t axisPhase_[kMaxAxes] = {};
+  uint32_t velocityAccel_ = 1;
+  uint32_t watchdogTicks_ = 0;
+  volatile uint32_t watchdogLeft_ = 0;
+  volatile bool stopRequested_ = false;
+};
+
+// Kept in the header so the timer ISR gets an inlined copy in IRAM.
+inline uint8_t StepGenerator::tick() {
+  switch (mode_) {
+    case Mode::Linear:
+      return tickLinear();
+    case Mode::Velocity:
+      return tickVelocity();
+    default:
+      return 0;
+  }
+}
+
+inline bool StepGenerator::inBand(uint32_t velocity) const {
+  for (uint8_t i = 0; i < bandCount_; ++i) {
+    if (velocity > bands_[i].lowQ32 && velocity < bands_[i].highQ32) return true;
+  }
+  return false;
+}
+
+inline uint32_t StepGenerator::boosted(uint32_t accel) const {
+  return (accel > (kMaxVelocityQ32 >> bandAccelShift_)) ? kMaxVelocityQ32
+                                                         : accel << bandAccelShift_;
+}
+
+inline uint8_t StepGenerator::tickLinear() {
+  // Velocity profile (symmetric trapezoid on the dominant axis). The boost
+  // applies on both ramps, so the decel ramp still mirrors stepsAccel_.
+  const uint32_t remaining = totalSteps_ - stepsDone_;
+  if (!decelerating_ && remaining <= stepsAccel_) {
+    decelerating_ = true;
+  }
+  const uint32_t accel = inBand(velocity_) ? bandAccel_ : accel_;
+  if (decelerating_) {
+    velocity_ = (velocity_ > minVelocity_ + accel) ? velocity_ - accel : minVelocity_;
+  } else if (velocity_ < cruise_) {
+    velocity_ = (cruise_ - velocity_ > accel) ? velocity_ + accel : cruise_;
+  }
+
+  // Phase accumulator: a carry means one dominant-axis step
+  const uint32_t previous = phase_;
+  phase_ += velocity_;
+  if (phase_ >= previous) return 0;
+
+  ++stepsDone_;
+  if (!decelerating_ && velocity_ < cruise_) {
+    ++stepsAccel_;
+  }
+
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < axisCount_; ++i) {
+    if (absDelta_[i] == 0) continue;
+    error_[i] += absDelta_[i];
+    if (error_[i] >= totalSteps_) {
+      error_[i] -= totalSteps_;
+      const uint8_t bit = static_cast<uint8_t>(1u << i);
+      mask |= bit;
+      position_[i] = position_[i] + ((negativeMask_ & bit) ? -1 : 1);
+    }
+  }
+
+  if (stepsDone_ >= totalSteps_) {
+    mode_ = Mode::Idle;
+    activeMask_ = 0;
+  }
+  return mask;
+}
+
+inline uint8_t StepGenerator::tickVelocity() {
+  // Stream lost: ramp down instead of running on a stale command
+  if (watchdogLeft_ > 0) {
+    watchdogLeft_ = watchdogLeft_ - 1;
+    if (watchdogLeft_ == 0) stopRequested_ = true;
+  }
+
+  uint8_t mask = 0;
+  uint8_t moving = 0;
+  for (uint8_t i = 0; i < axisCount_; ++i) {
+    const uint8_t bit = static_cast<uint8_t>(1u << i);
+    const int32_t target = stopRequested_ ? 0 : targetVelocity_[i];
+    int32_t v = axisVelocity_[i];
+
+    // Slew towards the target under the acceleration limit (boosted in a band)
+    const uint32_t speed = (v < 0) ? static_cast<uint32_t>(-static_cast<int64_t>(v))
+                                   : static_cast<uint32_t>(v);
+    const uint32_t accel = (bandCount_ != 0 && inBand(speed)) ? boosted(velocityAccel_)
+                                                              : velocityAccel_;
+    const int64_t diff = static_cast<int64_t>(target) - v;
+    if (diff > static_cast<int64_t>(accel)) {
+      v += static_cast<int32_t>(accel);
+    } else if (diff < -static_cast<int64_t>(accel)) {
+      v -= static_cast<int32_t>(accel);
+    } else {
+      v = target;
+    }
+    axisVelocity_[i] = v;
+    if (v == 0) continue;
+
+    // Reversal: restart the phase so the next pulse is at least a tick
+    // after the direction pin changes
+    const bool negative = v < 0;
+    if (negative != ((negativeMask_ & bit) != 0)) {
+      negativeMask_ ^= bit;
+      axisPhase_[i] = 0;
+    }
+
+    moving |= bit;
+    const uint32_t magnitude = negative ? static_cast<uint32_t>(-static_cast<int64_t>(v))
+                                        : static_cast<uint32_t>(v);
+    const uint32_t previous = axisPhase_[i];
+    axisPhase_[i] += magnitude;
+    if (axisPhase_[i] < previous) {
+      mask |= bit;
+      position_[i] = position_[i] + (negative ? -1 : 1);
+    }
+  }
+
+  activeMask_ = moving;
+  if (stopRequested_ && moving == 0) {
+    mode_ = Mode::Idle;
+  }
+  return mask;
+}
+
+}  // namespace motion
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace motion {
+
+// ============================================================================
+// COMMANDED vs MEASURED POSITION (stall / lost-step detection)
+// ============================================================================
+//
+// Called once per supervision period with the commanded step count and the
+// raw encoder count. The encoder is scaled to steps with integer math; a
+// following error beyond the limit is a fault:
+//   - Stall:     steps were commanded but the shaft did not move
+//   - LostSteps: the shaft moves but lags/leads the command
+
+enum class TrackingFault : uint8_t { None = 0, LostSteps = 1, Stall = 2 };
+
+struct TrackingConfig {
+  int32_t stepsPerRev;         // Motor steps per revolution (microsteps included)
+  int32_t countsPerRev;        // Encoder counts per revolution (after x4 decoding)
+  int32_t maxFollowingError;   // Allowed |commanded - measured|, in steps
+  int32_t stallMotionSteps;    // Measured motion at or below this counts as "not moving"
+  uint8_t confirmSamples;      // Consecutive periods over the limit before a fault
+};
+
+class TrackingMonitor {
+ public:
+  explicit TrackingMonitor(const TrackingConfig& config) : config_(config) {}
+
+  // Aligns the reference: the current encoder count now equals commandedSteps.
+  void reset(int32_t commandedSteps, int64_t encoderCounts);
+
+  // Evaluates one supervision period.
+  TrackingFault update(int32_t commandedSteps, int64_t encoderCounts);
+
+  // Encoder position converted to steps (same origin as the command).
+  int32_t measuredSteps(int64_t encoderCounts) const;
+
+  int32_t followingError() const { return followingError_; }
+
+ private:
+  TrackingConfig config_;
+  int64_t countOffset_ = 0;
+  int32_t lastCommanded_ = 0;
+  int32_t lastMeasured_ = 0;
+  int32_t followingError_ = 0;
+  uint8_t strikes_ = 0;
+};
+
+}  // namespace motion
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include <atomic>
+
+namespace tasks {
+
+// ============================================================================
+// CANAIS ENTRE TASKS COM POLÍTICA DE CONTRAPRESSÃO
+// ============================================================================
+//
+// Cada canal declara o que acontece quando o consumidor não acompanha:
+//
+//   Fifo        fila limitada; com a fila cheia o envio espera até
+//               ticksToWait e depois descarta a mensagem nova (dropped).
+//   LatestWins  caixa de correio de uma posição (xQueueOverwrite): a
+//               mensagem nova substitui a pendente (coalesced). Para
+//               referências absolutas: nunca há valor velho atrás de um novo.
+//   Coalesce    caixa de uma posição com função de fusão: a mensagem
+//               pendente e a nova viram uma só (ex.: somar movimentos
+//               relativos). Se não forem fundíveis, a nova substitui a
+//               pendente e esta conta como descartada.
+//
+// Envios com LatestWins nunca bloqueiam. Coalesce espera no máximo
+// kCoalesceLockTicks pela trava dos produtores; se outro produtor a
+// segurar por mais tempo, a mensagem nova é descartada (dropped). Os
+// contadores são atômicos e podem ser lidos por qualquer task (getChannelStats).
+
+enum class ChannelPolicy : uint8_t { Fifo, LatestWins, Coalesce };
+
+// Espera máxima pela trava de produtores do Coalesce (a seção crítica são
+// três operações de fila; passar disso indica produtor preemptado)
+constexpr TickType_t kCoalesceLockTicks = 1;
+
+// Cópia dos contadores de um canal
+struct ChannelStats {
+  const char* name;
+  ChannelPolicy policy;
+  uint32_t capacity;   // Posições da fila (1 para caixas de correio)
+  uint32_t depth;      // Mensagens pendentes agora
+  uint32_t maxDepth;   // Maior ocupação observada após um envio
+  uint32_t sent;       // Envios aceitos
+  uint32_t dropped;    // Mensagens perdidas (fila cheia ou não fundíveis)
+  uint32_t coalesced;  // Mensagens absorvidas por uma mais nova
+};
+
+struct ChannelCounters {
+  std::atomic<uint32_t> sent{0};
+  std::atomic<uint32_t> dropped{0};
+  std::atomic<uint32_t> coalesced{0};
+  std::atomic<uint32_t> maxDepth{0};
+
+  void recordDepth(uint32_t depth) {
+    uint32_t seen = maxDepth.load(std::memory_order_relaxed);
+    while (depth > seen && !maxDepth.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {
+    }
+  }
+};
+
+// Registro global, para inspeção em execução (até kMaxChannels canais)
+constexpr size_t kMaxChannels = 8;
+
+void registerChannel(const char* name, ChannelPolicy policy, QueueHandle_t queue,
+                     uint32_t capacity, const ChannelCounters* counters);
+
+// Copia os contadores de até maxCount canais; retorna quantos existem
+size_t getChannelStats(ChannelStats* out, size_t maxCount);
+
+// Uma linha CSV por canal pela serial
+// ("channel,name,policy,capacity,depth,max_depth,sent,dropped,coalesced")
+void printChannelStats();
+
+template <typename T>
+class Channel {
+ public:
+  // Funde a mensagem nova na pendente; false se não for possível
+  using MergeFn = bool (*)(T& pending, const T& newer);
+
+  // Cria a fila (idempotente). length só vale para Fifo; merge só para Coalesce.
+  bool create(const char* name, ChannelPolicy policy, size_t length = 1,
+              MergeFn merge = nullptr) {
+    if (queue_ != nullptr) return true;
+    policy_ = policy;
+    merge_ = merge;
+    const size_t capacity = (policy == ChannelPolicy::Fifo) ? length : 1;
+    if (policy == ChannelPolicy::Coalesce) {
+      producerLock_ = xSemaphoreCreateMutex();
+      if (producerLock_ == nullptr) return false;
+    }
+    queue_ = xQueueCreate(capacity, sizeof(T));
+    if (queue_ == nullptr) return false;
+    registerChannel(name, policy, queue_, static_cast<uint32_t>(capacity), &counters_);
+    return true;
+  }
+
+  bool created() const { return queue_ != nullptr; }
+
+  // ticksToWait só é usado por Fifo
+  bool send(const T& msg, TickType_t ticksToWait = 0) {
+    if (queue_ == nullptr) return false;
+    switch (policy_) {
+      case ChannelPolicy::Fifo:
+        if (xQueueSend(queue_, &msg, ticksToWait) != pdTRUE) {
+          counters_.dropped.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        break;
+      case ChannelPolicy::LatestWins:
+        if (uxQueueMessagesWaiting(queue_) != 0) {
+          counters_.coalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+        xQueueOverwrite(queue_, &msg);
+        break;
+      case ChannelPolicy::Coalesce:
+        if (!sendCoalesced(msg)) {
+          counters_.dropped.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        break;
+    }
+    counters_.sent.fetch_add(1, std::memory_order_relaxed);
+    counters_.recordDepth(uxQueueMessagesWaiting(queue_));
+    return true;
+  }
+
+  bool receive(T& msg, TickType_t ticksToWait) {
+    return queue_ != nullptr && xQueueReceive(queue_, &msg, ticksToWait) == pdTRUE;
+  }
+
+  uint32_t depth() const {
+    return (queue_ != nullptr) ? uxQueueMessagesWaiting(queue_) : 0;
+  }
+
+ private:
+  // Retira a pendente, funde e recoloca. Produtores são serializados pelo
+  // mutex; o consumidor no máximo encontra a caixa vazia por um instante.
+  // false se a trava não vier em kCoalesceLockTicks (nada foi alterado).
+  bool sendCoalesced(const T& msg) {
+    if (xSemaphoreTake(producerLock_, kCoalesceLockTicks) != pdTRUE) return false;
+    T pending;
+    if (xQueueReceive(queue_, &pending, 0) == pdTRUE) {
+      if (merge_ != nullptr && merge_(pending, msg)) {
+        counters_.coalesced.fetch_add(1, std::memory_order_relaxed);
+        xQueueOverwrite(queue_, &pending);
+      } else {
+        counters_.dropped.fetch_add(1, std::memory_order_relaxed);
+        xQueueOverwrite(queue_, &msg);
+      }
+    } else {
+      xQueueOverwrite(queue_, &msg);
+    }
+    xSemaphoreGive(producerLock_);
+    return true;
+  }
+
+  QueueHandle_t queue_ = nullptr;
+  SemaphoreHandle_t producerLock_ = nullptr;
+  ChannelPolicy policy_ = ChannelPolicy::Fifo;
+  MergeFn merge_ = nullptr;
+  ChannelCounters counters_;
+};
+
+}  // namespace tasks
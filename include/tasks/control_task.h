@@ -2,23 +2,69 @@
 
 #include <freertos/FreeRTOS.h>
 
+#include "control/cascade.h"
+#include "control/frequency_response.h"
+#include "control/gain_schedule.h"
+#include "hal/clock.h"
+
 namespace tasks {
 
 // Mensagem de entrada do sensor de toque para o controlador
 // Representa a referência (setpoint) ou entrada do sistema de controle
 struct TouchInputMessage {
-  int32_t touchValue;      // Valor bruto do sensor capacitivo (0-100)
-  uint8_t touchZone;       // Zona de toque identificada (0=nenhum, 1=leve, 2=médio, 3=forte)
-  TickType_t timestamp;    // Timestamp para análise temporal
+  int32_t touchValue;            // Toque: 0-100; ADC: 0-4095; slider: posição (swipe: velocidade)
+  uint8_t touchZone;             // Zona de toque identificada (0=nenhum, 1=leve, 2=médio, 3=forte)
+  uint16_t intensity;            // Intensidade (0..256): variável de escalonamento da lei
+  int8_t direction;              // Sentido pedido pela fonte (±1: slider, ADC); 0 = a lei escolhe
+  hal::TimestampUs timestampUs;  // Instante da amostra na fonte (µs, hal/clock.h)
 };
 
-// Envia mensagem de toque para o controlador
-// ticksToWait: tempo de espera se a fila estiver cheia
-bool sendTouchInputMessage(const TouchInputMessage& msg, TickType_t ticksToWait = portMAX_DELAY);
+// Envia mensagem de toque para o controlador. A fonte carimba timestampUs
+// com hal::nowUs() no instante da amostra (o replay, com o instante gravado)
+// ticksToWait: tempo de espera se a fila estiver cheia (Fifo limitada; por
+// padrão não bloqueia; descartes aparecem no canal "touch_input", tasks/channel.h)
+bool sendTouchInputMessage(const TouchInputMessage& msg, TickType_t ticksToWait = 0);
 
 // Inicia a task de controle digital
 // Esta task implementa a função de transferência do sistema de controle
 // Prioridade intermediária entre sensor (entrada) e atuador (saída)
-void startControlTask(UBaseType_t priority);
+// innerLoopPriority: prioridade da malha interna rápida (modo cascata),
+// acima de todas as demais tasks
+void startControlTask(UBaseType_t priority, UBaseType_t innerLoopPriority);
+
+// Acorda a malha externa para processar entradas novas (modo híbrido).
+// sendTouchInputMessage já chama; produtores que entregam por outro canal
+// (touch_task com o pipeline dividido) chamam após cada envio.
+void notifyControlInput();
+
+// Tabela de escalonamento da lei de controle (control/gain_schedule.h).
+// A troca vale na próxima entrada e fica guardada para a partida a quente.
+// Retorna false para um id desconhecido (a tabela ativa não muda).
+bool setControlGainSchedule(control::GainScheduleId id);
+control::GainScheduleId getControlGainSchedule();
+
+// Contadores de execução e de perda de prazo das malhas interna e externa
+struct ControlLoopStats {
+  control::LoopStats inner;
+  control::LoopStats outer;          // Uma execução por despertar (período ou evento)
+  uint32_t eventWakes;               // Despertares da malha externa por entrada nova
+  control::LatencyStats inputLatency;  // Carimbo da mensagem → lei de controle
+};
+
+ControlLoopStats getControlLoopStats();
+
+// Registra a latência de uma entrada que chegou à lei (chamado pelo pipeline)
+void recordInputLatency(hal::TimestampUs timestampUs);
+
+// Resposta em frequência (Bode) da malha interna - requer modo cascata.
+// Injeta um seno em degraus na saída da malha interna e transmite pela
+// serial uma linha CSV por frequência ("bode,index,hz,..."). Durante a
+// medição a aceleração do modo velocidade passa a velocityAccel, que deve
+// ser maior que amplitude × 2π × stopHz; ao final (ou no abort) volta a
+// que estava configurada antes da medição.
+// Retorna false se já houver uma varredura ou a configuração for inválida.
+bool startFrequencyResponse(const control::SweepConfig& config, float velocityAccel);
+void abortFrequencyResponse();
+bool isFrequencyResponseRunning();
 
 }  // namespace tasks
@@ -2,6 +2,8 @@
 
 #include <freertos/FreeRTOS.h>
 
+#include "hal/clock.h"
+
 namespace tasks {
 
 // Commands that can be sent to the display task.
@@ -15,10 +17,13 @@ struct DisplayMessage {
 	uint8_t col;
 	uint8_t row;
 	char c;
+	hal::TimestampUs timestampUs;  // Send time (hal/clock.h), set by sendDisplayMessage
 };
 
 // Enqueue a message to the display task. Returns true on success.
-bool sendDisplayMessage(const DisplayMessage& msg, TickType_t ticksToWait = portMAX_DELAY);
+// Bounded FIFO: when full, the message is dropped after ticksToWait (by
+// default right away) and counted in the "display" channel stats (tasks/channel.h).
+bool sendDisplayMessage(const DisplayMessage& msg, TickType_t ticksToWait = 0);
 
 // Starts the FreeRTOS task that manages the I2C LCD display.
 void startDisplayTask(UBaseType_t priority);
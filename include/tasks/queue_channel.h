@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+
+#include "tasks/channel.h"
+
+namespace tasks {
+
+// Comprimento das filas criadas entre estágios de pipeline
+constexpr size_t kQueueChannelLength = 10;
+
+// Canal entre estágios que rodam em tasks diferentes (control/pipeline.h):
+// Channel Fifo com cópia por valor. O envio nunca bloqueia; com a fila
+// cheia a mensagem é descartada e contada (getChannelStats, "pipeline").
+// Fifo porque os eventos de toque chegam em ordem e nenhum pode ser fundido.
+template <typename T>
+class QueueChannel {
+ public:
+  void init() { channel_.create("pipeline", ChannelPolicy::Fifo, kQueueChannelLength); }
+
+  bool send(const T& msg) { return channel_.send(msg, 0); }
+
+  bool receive(T& msg, uint32_t waitTicks) { return channel_.receive(msg, waitTicks); }
+
+ private:
+  Channel<T> channel_;
+};
+
+}  // namespace tasks
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+
+#include "control/analog_setpoint.h"
+#include "control/pd_lut_law.h"
+#include "control/pipeline.h"
+#include "control/touch_classifier.h"
+#include "control/touch_slider.h"
+#include "hal/board.h"
+#include "tasks/control_task.h"
+#include "tasks/queue_channel.h"
+#include "tasks/trace_task.h"
+
+namespace tasks {
+
+// ============================================================================
+// PIPELINE SENSOR → CONTROLADOR → ATUADOR
+// ============================================================================
+//
+// A composição é feita por tipos (control/pipeline.h): cada estágio declara
+// em qual task roda. Estágios na mesma task viram chamadas diretas; só
+// entre tasks diferentes existe uma fila. Para mover o sensor para a sua
+// própria task basta trocar ControlContext por TouchContext no primeiro
+// estágio: a fila e a touch_task passam a existir automaticamente.
+
+// Contextos de execução
+struct TouchContext {};    // touch_task
+struct ControlContext {};  // control_task (malha externa)
+
+// Fonte: amostra o sensor capacitivo, classifica em zonas, mostra a zona no
+// display e aplica debounce; o evento leva a intensidade da amostra que
+// mudou a zona (touch_task.cpp)
+class TouchSensorStage {
+ public:
+  using Input = void;
+  using Output = TouchInputMessage;
+
+  bool poll(TouchInputMessage& out);
+
+ private:
+  uint8_t lastZone_ = 0;
+  hal::TimestampUs lastMessageUs_ = 0;
+};
+
+// Fonte alternativa: setpoint analógico (potenciômetro ou 0-10 V) no ADC
+// contínuo com DMA. Cada poll esvazia o buffer do driver, reduz o bloco a
+// uma média e publica quando a intensidade muda além da histerese. Sem task
+// nem interrupção por amostra (analog_setpoint_stage.cpp).
+class AnalogSetpointStage {
+ public:
+  using Input = void;
+  using Output = TouchInputMessage;
+
+  bool poll(TouchInputMessage& out);
+
+ private:
+  control::AnalogSetpointFilter filter_;
+  uint8_t lastZone_ = 0;
+  uint16_t published_ = 0;  // Última intensidade enviada (sentido da próxima)
+};
+
+// Fonte alternativa: slider capacitivo de vários pads (hal/touch_slider.h).
+// O FSM de toque varre os pads em hardware; cada poll processa todas as
+// varreduras acumuladas (posição interpolada, velocidade, gesto) e publica
+// a posição como intensidade, ou um jog ao soltar em movimento
+// (touch_slider_stage.cpp).
+class TouchSliderStage {
+ public:
+  using Input = void;
+  using Output = TouchInputMessage;
+
+  bool poll(TouchInputMessage& out);
+
+ private:
+  control::SliderTracker tracker_{hal::kTouchSliderPadCount,
+                                  hal::kMicrosPerSecond / hal::kTouchSliderScanHz};
+  uint16_t published_ = 0;
+  uint8_t lastZone_ = 0;
+};
+
+// Fonte em uso: TouchSensorStage, AnalogSetpointStage ou TouchSliderStage
+// (mesma mensagem)
+using SetpointSourceStage = TouchSensorStage;
+
+// Lei de controle PD com ganhos escalonados pela intensidade do toque;
+// só repassa comandos com movimento
+class ControlLawStage {
+ public:
+  using Input = TouchInputMessage;
+  using Output = control::MotorCommand;
+
+  bool process(const TouchInputMessage& in, control::MotorCommand& out) {
+    out = law_.update(in.intensity, in.direction);
+    return out.steps != 0;
+  }
+
+  // Troca a tabela de escalonamento em execução
+  void setSchedule(const control::GainSchedule& table) { law_.setSchedule(table); }
+
+  // Estado inicial (início de gravação ou replay)
+  void reset() { law_.reset(); }
+
+ private:
+  control::ScheduledPdLaw law_;
+};
+
+// Pontos de gravação (tasks/trace_task.h): repassam a mensagem inalterada.
+// A entrada também mede a latência até a lei (getControlLoopStats).
+class InputTraceStage {
+ public:
+  using Input = TouchInputMessage;
+  using Output = TouchInputMessage;
+
+  bool process(const TouchInputMessage& in, TouchInputMessage& out) {
+    recordInputLatency(in.timestampUs);
+    traceInput(in);
+    out = in;
+    return true;
+  }
+};
+
+class OutputTraceStage {
+ public:
+  using Input = control::MotorCommand;
+  using Output = control::MotorCommand;
+
+  bool process(const control::MotorCommand& in, control::MotorCommand& out) {
+    traceOutput(in);
+    out = in;
+    return true;
+  }
+};
+
+// Atuador: acumula os comandos de um despertar da control_task; flush()
+// desloca a referência da cascata (ou envia um StepperMessage) uma vez
+// com a soma (control_task.cpp)
+class ActuatorStage {
+ public:
+  using Input = control::MotorCommand;
+  using Output = void;
+
+  void process(const control::MotorCommand& command) {
+    pending_.steps += command.steps;
+    pending_.speedInStepsPerSec = command.speedInStepsPerSec;  // A mais recente vale
+    ++pendingCommands_;
+  }
+
+  // Entrega o agregado; retorna quantos comandos foram somados
+  uint32_t flush();
+
+ private:
+  control::MotorCommand pending_ = {0, 0.0f};
+  uint32_t pendingCommands_ = 0;
+};
+
+using SensorPipeline = control::Pipeline<
+    QueueChannel,
+    control::Stage<SetpointSourceStage, ControlContext>,  // ENTRADA
+    control::Stage<InputTraceStage, ControlContext>,
+    control::Stage<ControlLawStage, ControlContext>,      // PROCESSAMENTO
+    control::Stage<OutputTraceStage, ControlContext>,
+    control::Stage<ActuatorStage, ControlContext>>;       // SAÍDA
+
+constexpr size_t kSourceStage = 0;
+constexpr size_t kInputTraceStage = 1;
+constexpr size_t kControlLawStage = 2;
+constexpr size_t kOutputTraceStage = 3;
+constexpr size_t kActuatorStage = 4;
+
+// Instância única; cada task executa apenas o seu segmento
+SensorPipeline& sensorPipeline();
+
+// Cria os canais e as tasks usadas pelo pipeline (touch_task só se algum
+// estágio rodar em TouchContext), a control_task com a malha interna e a
+// task de gravação/replay (com a prioridade do sensor).
+void startSensorPipeline(UBaseType_t touchPriority, UBaseType_t controlPriority,
+                         UBaseType_t innerLoopPriority);
+
+}  // namespace tasks
@@ -2,31 +2,144 @@
 
 #include <freertos/FreeRTOS.h>
 
+#include "control/cascade.h"
+#include "hal/clock.h"
+#include "tasks/task_config.h"
+
 namespace tasks {
 
-// Message structure sent to the stepper task
+// Maximum number of axes in one coordinated move (matches motion::kMaxAxes).
+constexpr uint8_t kMaxStepperAxes = 4;
+
+// Message structure sent to the stepper task (single axis: axis 0)
 struct StepperMessage {
   int32_t targetPosition;      // Target position in steps (absolute or relative)
   float speedInStepsPerSec;    // Movement speed in steps per second
   float accelInStepsPerSecSec; // Acceleration in steps per second^2
   bool isRelative;             // true = relative move, false = absolute move
+  hal::TimestampUs timestampUs; // Send time (hal/clock.h); 0 = stamped by sendStepperMessage
+};
+
+// Coordinated straight-line move over several axes. All axes in axisMask
+// start and finish together; speed and acceleration apply to the axis with
+// the longest travel. Speeds are in microsteps (hal::kStepperMicrosteps);
+// a cruise speed inside a resonance band is moved to the band edge
+// (motion/speed_profile.h).
+struct MultiAxisStepperMessage {
+  int32_t targetPositions[kMaxStepperAxes];  // Per-axis target (absolute or relative)
+  uint8_t axisMask;                          // Bit i set = axis i takes part in the move
+  float speedInStepsPerSec;                  // Dominant-axis speed in steps per second
+  float accelInStepsPerSecSec;               // Dominant-axis acceleration in steps per second^2
+  bool isRelative;                           // true = relative move, false = absolute move
+  hal::TimestampUs timestampUs;              // Send time; 0 = stamped on send
 };
 
-// Enqueue a message to the stepper task. Returns true on success.
-// ticksToWait: time to wait if queue is full (default: wait forever)
-bool sendStepperMessage(const StepperMessage& msg, TickType_t ticksToWait = portMAX_DELAY);
+// Hand a move to the stepper task. Never blocks: the stepper mailbox holds
+// one pending move, and a move sent while another is still pending is
+// coalesced into it (relative deltas add, absolute targets replace; see
+// tasks/channel.h). A move that cannot be merged replaces the pending one
+// and is counted as dropped in the "stepper" channel stats.
+// ticksToWait: kept for API compatibility, unused by the mailbox.
+// Returns false only if the mailbox could not be created.
+bool sendStepperMessage(const StepperMessage& msg, TickType_t ticksToWait = 0);
+
+// Hand a coordinated multi-axis move to the stepper task (same policy).
+// A coalesced move keeps the timestamp of the oldest move folded into it.
+bool sendMultiAxisStepperMessage(const MultiAxisStepperMessage& msg,
+                                 TickType_t ticksToWait = 0);
+
+// Cruise speed (steps/s, sign kept) clamped to the step-rate ceiling and
+// moved out of the resonance bands (kStepperSpeedProfile). Queued moves
+// apply it on their own; other cruise caps, such as the cascade's velocity
+// limit, must go through it too.
+float planStepperCruise(float stepsPerSec);
+
+// Time from a move's timestamp to the start of its execution, in us
+// (coalesced moves count once, from the oldest one).
+control::LatencyStats getStepperCommandLatency();
 
-// Starts the FreeRTOS task that controls the stepper motor via TB6600 driver using ESP-FlexyStepper.
-// Use high priority (e.g., tskIDLE_PRIORITY + 3) for precise timing.
+// Starts the FreeRTOS task that drives the stepper axes listed in hal::kStepperAxes.
+// Step pulses come from one hardware timer; use high priority (e.g., tskIDLE_PRIORITY + 3).
 void startStepperTask(UBaseType_t priority);
 
-// Get the current position of the stepper motor
+// ----------------------------------------------------------------------------
+// Velocity (jog / streaming) mode
+// ----------------------------------------------------------------------------
+// The caller writes a target velocity as often as it likes (e.g. every 1 ms
+// from a feedback loop). The step generator slews towards it under the
+// acceleration limit, with no queued moves and no stop between updates.
+// Only the newest value matters. If no update arrives for 50 ms the axes
+// ramp down to rest. A queued position move ramps the stream down and takes over.
+
+// Sets the target velocity (steps/s, signed) of an axis, entering velocity
+// mode if idle. Returns false while a queued position move is running or
+// waiting for the stream to ramp down (the move always wins the hand-over).
+bool setStepperVelocity(float stepsPerSec, uint8_t axis = 0);
+
+// Velocity-mode acceleration until setStepperVelocityAccel() is called:
+// kDefaultStepperVelocityAccel (tasks/task_config.h).
+
+// Acceleration limit used to slew towards the target velocity. It persists
+// across velocity-mode entries (idle periods, queued moves) until changed,
+// and across warm resets unless persist is false (a temporary change, such
+// as the one made during a frequency-response sweep).
+void setStepperVelocityAccel(float accelStepsPerSecSec, bool persist = true);
+
+// Current velocity-mode acceleration limit (steps/s²), as last set.
+float getStepperVelocityAccel();
+
+// Ramps every axis down to rest and leaves velocity mode.
+void stopStepperVelocity();
+
+// Get the current position of the stepper motor (axis 0)
 int32_t getStepperPosition();
 
-// Emergency stop the stepper motor
+// Get the current position of a given axis, in steps
+int32_t getStepperPosition(uint8_t axis);
+
+// ----------------------------------------------------------------------------
+// Encoder feedback (axis 0, optional - see hal::kHasEncoder)
+// ----------------------------------------------------------------------------
+
+// Faults detected by comparing commanded and measured position.
+enum class StepperFault : uint8_t { None = 0, LostSteps = 1, Stall = 2 };
+
+// Shaft position measured by the encoder, in steps (commanded position without encoder)
+int32_t getMeasuredStepperPosition();
+
+// Commanded minus measured position at the last supervision period, in steps
+int32_t getStepperFollowingError();
+
+// Latched fault (the configured recovery has already been applied)
+StepperFault getStepperFault();
+void clearStepperFault();
+
+// True when axis positions were restored from RTC memory after a warm reset.
+// A reset during a move is a cold start (the last mirrored position may be stale).
+bool isStepperWarmStart();
+
+// Time from boot (esp_timer start) to the first step pulse, in us (0 = no step yet).
+// Also printed once per boot on the serial port ("boot_to_first_step_us,<us>,warm|cold").
+int64_t getBootToFirstStepUs();
+
+// True when the move on this axis was stopped by one of its limit switches
+bool isStepperLimitHit(uint8_t axis);
+
+// Emergency stop all stepper axes
 void emergencyStopStepper();
 
-// Enable/disable the stepper motor
+// Enable/disable all stepper drivers
 void setStepperEnabled(bool enabled);
 
+// Step generator throughput for a given axis count, measured on target.
+struct StepRateReport {
+  uint8_t axisCount;
+  float nsPerTick;                 // Cost of one generator tick (all axes stepping)
+  float maxTickHz;                 // Tick rate at 100% of one core
+  float aggregateStepsPerSec;      // Sum over axes at maxTickHz (0.5 step/tick/axis)
+};
+
+// Runs the generator kernel on a scratch instance (no GPIO) and times it.
+StepRateReport measureAggregateStepRate(uint8_t axisCount, uint32_t ticks = 100000);
+
 }  // namespace tasks
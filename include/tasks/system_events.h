@@ -0,0 +1,32 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+namespace tasks {
+
+// ============================================================================
+// BOOT SYNCHRONISATION - one event group shared by all subsystems
+// ============================================================================
+//
+// Subsystems start in parallel and set their bit once initialised. Anything
+// that depends on another subsystem waits on its bit instead of sleeping.
+
+constexpr EventBits_t kDisplayReadyBit = BIT0;   // LCD initialised, display queue live
+constexpr EventBits_t kStepperReadyBit = BIT1;   // Step timer, encoder and axis state ready
+constexpr EventBits_t kControlReadyBit = BIT2;   // Control loops running
+constexpr EventBits_t kTouchReadyBit = BIT3;     // Touch sensor sampling
+
+// Creates the event group. Call once from setup() before starting tasks.
+void initSystemEvents();
+
+// Marks the given subsystems as ready.
+void signalSystemReady(EventBits_t bits);
+
+// Waits until all bits are set. Returns true if they were set before the timeout.
+bool waitSystemReady(EventBits_t bits, TickType_t ticksToWait = portMAX_DELAY);
+
+// Non-blocking check.
+bool isSystemReady(EventBits_t bits);
+
+}  // namespace tasks
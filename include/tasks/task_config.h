@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "control/cascade.h"
+#include "control/trajectory.h"
+#include "hal/board.h"
+#include "motion/speed_profile.h"
+
+namespace tasks {
+
+// ============================================================================
+// CONSTANTES DAS TASKS COMPARTILHADAS COM O HOST
+// ============================================================================
+//
+// Taxas, ganhos e limites que definem o comportamento das tasks e que o
+// sim/ reproduz. Sem Arduino/FreeRTOS: as tasks e os builds nativos incluem
+// este mesmo header, então simulação e firmware não divergem.
+
+// ----------------------------------------------------------------------------
+// stepper_task
+// ----------------------------------------------------------------------------
+
+// Tick do gerador: timer a 1 MHz, alarme a cada 25 us -> 40 kHz.
+// Um pulso ocupa um tick alto e um baixo: cada eixo chega a 20 kHz.
+constexpr uint32_t kStepperTickPeriodUs = 25;
+constexpr uint32_t kStepperTickHz = 1000000 / kStepperTickPeriodUs;
+
+// Velocidade no início e no fim de cada rampa (passos/s)
+constexpr float kStepperMinStepRate = 20.0f;
+
+// Planejamento de velocidade: micropassos, faixas de ressonância do 17HS4401S
+// e aceleração 4x enquanto uma rampa atravessa uma delas. Nenhum cruzeiro
+// fica dentro de uma faixa (movimentos enfileirados e o limite de velocidade
+// da cascata); a saída da malha interna só recebe o reforço na rampa.
+constexpr motion::SpeedProfileConfig kStepperSpeedProfile = {
+    hal::kStepperFullStepsPerRev,
+    hal::kStepperMicrosteps,
+    motion::k17HS4401SResonanceBands,
+    motion::k17HS4401SResonanceBandCount,
+    2,                   // bandAccelShift
+    kStepperTickHz / 2,  // Um tick alto, um baixo
+};
+
+// Aceleração do modo velocidade até setStepperVelocityAccel() (passos/s²)
+constexpr float kDefaultStepperVelocityAccel = 2000.0f;
+
+// Modo velocidade: 50 ms sem atualização -> rampa até parar
+constexpr uint32_t kVelocityWatchdogTicks = kStepperTickHz / 20;
+
+// ----------------------------------------------------------------------------
+// control_task
+// ----------------------------------------------------------------------------
+
+// Fila de entradas da malha externa (Fifo limitada)
+constexpr size_t kTouchInputQueueLength = 10;
+
+// Aceleração dos movimentos enfileirados no modo legado (passos/s²)
+constexpr float kQueuedMoveAccel = 200.0f;
+
+// Ganho proporcional da malha interna de posição (1/s)
+constexpr float kInnerPositionGain = 20.0f;
+
+// Desaceleração usada no limite de frenagem da malha interna (passos/s²).
+// 80% da aceleração do modo velocidade: folga para o atraso de uma amostra
+// e para a elasticidade da carga (ver sim/).
+constexpr float kInnerDecelLimit = 0.8f * kDefaultStepperVelocityAccel;
+
+// Trajetória + feedforward da malha interna. Kaff ajustado no sim/
+// (--tracking): cobre o atraso de uma amostra e o amortecimento do acoplamento.
+constexpr control::FeedforwardGains kFeedforwardGains = {kInnerPositionGain, 1.0f, 0.01f};
+
+// Maior intervalo medido aceito na integração da malha interna (10 períodos).
+// Além disso a task ficou parada (depurador, flash) e a trajetória não deve
+// saltar tudo o que "andaria" nesse tempo.
+constexpr uint32_t kInnerMaxSampleGapUs = 10 * control::kControlRates.innerPeriodUs();
+
+// Repouso da malha interna: 10 amostras paradas no alvo encerram o streaming
+// de velocidade e liberam o gerador para movimentos enfileirados
+constexpr uint32_t kInnerIdleSamples = 10;
+
+// ----------------------------------------------------------------------------
+// Sensor de toque (TouchSensorStage)
+// ----------------------------------------------------------------------------
+
+// Período de amostragem do sensor capacitivo (100 ms)
+constexpr uint32_t kTouchPollPeriodUs = 100000;
+
+// Tempo de debounce para evitar múltiplas leituras do mesmo toque
+constexpr int64_t kTouchDebounceUs = 300000;
+
+}  // namespace tasks
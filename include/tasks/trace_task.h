@@ -0,0 +1,70 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+#include "control/pd_lut_law.h"
+#include "tasks/control_task.h"
+
+namespace tasks {
+
+// ============================================================================
+// GRAVAÇÃO E REPLAY DE ENTRADAS (regressão determinística)
+// ============================================================================
+//
+// Gravação: cada TouchInputMessage que chega à lei de controle e cada
+// comando entregue ao atuador vão para um log binário compacto na
+// LittleFS (formato em control/trace_codec.h).
+//
+// Replay: as entradas do log voltam pelo sendTouchInputMessage, com o
+// sensor real silenciado, em tempo real ou acelerado. O novo log é gravado
+// em kReplayOutputPath e comparado registro a registro (bit a bit) com o
+// original; o resultado sai pela serial ("trace,replay,...").
+//
+// O mesmo log roda no host: program --replay ARQ (env native_scenarios).
+
+constexpr const char* kTraceDefaultPath = "/trace.bin";
+constexpr const char* kReplayOutputPath = "/replay.bin";
+
+enum class TraceMode : uint8_t { Idle, Recording, Replaying };
+
+struct TraceStatus {
+  TraceMode mode;
+  uint32_t records;             // Registros gravados na sessão atual ou na última
+  uint32_t bytes;               // Bytes escritos na flash
+  uint32_t dropped;             // Registros perdidos (fila cheia)
+  bool lastReplayIdentical;     // Último replay reproduziu o log bit a bit
+  uint32_t lastReplayMatched;   // Registros iguais até a primeira diferença
+};
+
+// Monta a LittleFS e cria a task de gravação/replay (prioridade baixa:
+// só ela escreve na flash; a control_task apenas enfileira registros).
+void startTraceTask(UBaseType_t priority);
+
+// Grava em path (sobrescreve). A lei de controle recomeça do estado
+// inicial para que o log possa ser reexecutado desde o primeiro registro.
+bool startTraceRecording(const char* path = kTraceDefaultPath);
+
+// Reexecuta o log em path. speed: 1 = tempo real, N = N vezes mais rápido,
+// 0 = tão rápido quanto o controlador consome (no escalonamento híbrido
+// cada entrada é processada ao chegar; no periódico, uma por período).
+bool startTraceReplay(const char* path = kTraceDefaultPath, uint16_t speed = 1);
+
+// Encerra a gravação ou interrompe o replay
+void stopTrace();
+
+TraceStatus getTraceStatus();
+
+// --- Pontos de gravação, chamados pela control_task --------------------------
+
+// true: uma sessão vai começar; a control_task reinicia a lei de controle
+// e chama traceSessionBegin() antes do próximo processamento
+bool traceSessionPending();
+void traceSessionBegin();
+
+void traceInput(const TouchInputMessage& msg);
+void traceOutput(const control::MotorCommand& command);
+
+// Durante o replay o sensor de toque real não gera eventos
+bool isTraceReplaying();
+
+}  // namespace tasks
@@ -0,0 +1,249 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "control/cascade.h"
+#include "scenario.h"
+
+// ============================================================================
+// BENCHMARK DE CENÁRIOS EM MALHA FECHADA
+// ============================================================================
+//
+// Roda cada cenário com cada variante de controlador e imprime CSV:
+//   scenario,variant,segments,settling_s,overshoot_pct,sse_steps,iae,itae,
+//   unsettled,outer_ns,inner_ns,touch_q_hwm,stepper_q_hwm,dropped
+//
+// Uso: program [--scenario NOME] [--variant NOME]
+//      program --bode [--variant NOME]   (resposta em frequência da malha interna)
+//      program --latency [--scenario NOME] [--variant NOME]
+//        latência entrada → lei e CPU da malha externa, periódica × híbrida
+//      program --tracking [--scenario NOME] [--variant NOME]
+//        erro de seguimento da trajetória planejada (feedforward × só P × MPC)
+//      program --record ARQ --scenario NOME   (grava o log de um cenário de toque)
+//      program --replay ARQ [--speed N] [--out ARQ]
+//        reexecuta um log (do ESP32 ou do --record) e compara bit a bit;
+//        N = 1 tempo real, N > 1 acelerado, 0 sem espera (padrão)
+
+namespace {
+
+// Degraus de posição direto na malha externa
+constexpr sim::TracePoint kStepTrace[] = {
+    {0.0f, 0}, {0.2f, 400}, {1.7f, -200}, {3.2f, 800}, {4.7f, 780},
+};
+
+// Toques roteirizados: leve, médio, forte, com soltura entre eles
+constexpr sim::TracePoint kTouchTrace[] = {
+    {0.0f, 80}, {0.3f, 40}, {0.8f, 80}, {1.5f, 22}, {2.0f, 80},
+    {3.0f, 10}, {3.6f, 80}, {5.0f, 40}, {5.4f, 80},
+};
+
+// Toques rápidos e fortes: mais comandos do que o atuador consegue executar
+constexpr sim::TracePoint kTouchBurstTrace[] = {
+    {0.0f, 80}, {0.2f, 10}, {0.5f, 80}, {0.6f, 10}, {0.9f, 80}, {1.0f, 10},
+    {1.3f, 80}, {1.4f, 10}, {1.7f, 80}, {1.8f, 10}, {2.1f, 80}, {2.2f, 10},
+    {2.5f, 80},
+};
+
+#define TRACE(t) t, sizeof(t) / sizeof(t[0])
+
+// Rajadas de mensagens externas (replay, outro produtor) a cada 5 ms
+constexpr sim::TracePoint kInputBurstTrace[] = {
+    {0.50f, 60},  {0.505f, 90},  {0.51f, 120}, {0.515f, 150}, {0.52f, 180}, {0.525f, 210},
+    {0.53f, 240}, {0.535f, 256}, {2.50f, 200}, {2.505f, 140}, {2.51f, 80},  {2.515f, 40},
+    {2.52f, 20},  {2.525f, 60},  {2.53f, 100}, {2.535f, 140},
+};
+
+const sim::Scenario kScenarios[] = {
+    {"setpoint_steps", sim::TraceKind::Setpoint, TRACE(kStepTrace), 6.2f, 2000.0f},
+    {"touch_sequence", sim::TraceKind::Touch, TRACE(kTouchTrace), 8.0f, 0.0f},
+    {"touch_burst", sim::TraceKind::Touch, TRACE(kTouchBurstTrace), 8.0f, 0.0f},
+    {"input_burst", sim::TraceKind::Input, TRACE(kInputBurstTrace), 5.0f, 0.0f},
+};
+
+const char* gBodeVariant = "";
+
+const sim::Variant kVariants[] = {
+    sim::Variant::PdLutQueued,
+    sim::Variant::CascadeP,
+    sim::Variant::CascadePid,
+    sim::Variant::CascadeProfiled,
+    sim::Variant::CascadeFf,
+    sim::Variant::CascadeMpc,
+};
+
+void printPoint(const control::FrequencyPoint& p) {
+  printf("%u,%.3f,%.2f,%.1f,%.2f,%.1f\n", p.index, p.hz, p.plantGainDb, p.plantPhaseDeg,
+         p.loopGainDb, p.loopPhaseDeg);
+}
+
+int runBode(const char* variantFilter) {
+  // Amplitude × 2·pi·f_max abaixo da aceleração usada na varredura
+  const control::SweepConfig config = {0.5f, 10.0f, 6, 100.0f, 3, 8, control::kControlRates.innerHz};
+  constexpr float kSweepAccel = 10000.0f;
+  printf("variant,index,hz,plant_gain_db,plant_phase_deg,loop_gain_db,loop_phase_deg\n");
+  for (const sim::Variant variant : kVariants) {
+    const char* name = sim::variantName(variant);
+    if (variantFilter != nullptr && strcmp(variantFilter, name) != 0) continue;
+    if (variant == sim::Variant::PdLutQueued) continue;
+    gBodeVariant = name;
+    sim::runFrequencyResponse(config, kSweepAccel, variant, [](const control::FrequencyPoint& p) {
+      printf("%s,", gBodeVariant);
+      printPoint(p);
+    });
+  }
+  return 0;
+}
+
+int runLatency(const char* scenarioFilter, const char* variantFilter) {
+  const sim::Scheduling kSchedulings[] = {sim::Scheduling::TimeTriggered, sim::Scheduling::Hybrid};
+  printf("scenario,variant,scheduling,inputs,latency_mean_ms,latency_max_ms,outer_wakes,"
+         "event_wakes,outer_ns,outer_cpu_us_per_s,settling_s,itae\n");
+  for (const sim::Scenario& scenario : kScenarios) {
+    if (scenario.kind == sim::TraceKind::Setpoint) continue;
+    if (scenarioFilter != nullptr && strcmp(scenarioFilter, scenario.name) != 0) continue;
+    for (const sim::Variant variant : kVariants) {
+      const char* name = sim::variantName(variant);
+      if (variantFilter != nullptr && strcmp(variantFilter, name) != 0) continue;
+      for (const sim::Scheduling scheduling : kSchedulings) {
+        const sim::ScenarioResult r = sim::runScenario(scenario, variant, nullptr, scheduling);
+        printf("%s,%s,%s,%lu,%.1f,%.1f,%lu,%lu,%.1f,%.2f,%.3f,%.1f\n", scenario.name, name,
+               sim::schedulingName(scheduling), static_cast<unsigned long>(r.inputs),
+               r.latencyMeanMs, r.latencyMaxMs, static_cast<unsigned long>(r.outerSamples),
+               static_cast<unsigned long>(r.eventWakes), r.outerNsPerSample, r.outerCpuUsPerS,
+               r.response.settlingTimeS, r.response.itae);
+      }
+    }
+  }
+  return 0;
+}
+
+int runTracking(const char* scenarioFilter, const char* variantFilter) {
+  printf("scenario,variant,moving_s,tracking_rms_steps,tracking_max_steps,settling_s,"
+         "overshoot_pct,itae,inner_ns\n");
+  for (const sim::Scenario& scenario : kScenarios) {
+    if (scenarioFilter != nullptr && strcmp(scenarioFilter, scenario.name) != 0) continue;
+    for (const sim::Variant variant : kVariants) {
+      const char* name = sim::variantName(variant);
+      if (variantFilter != nullptr && strcmp(variantFilter, name) != 0) continue;
+      if (variant == sim::Variant::PdLutQueued) continue;  // Sem malha interna
+      const sim::ScenarioResult r = sim::runScenario(scenario, variant);
+      printf("%s,%s,%.2f,%.2f,%.2f,%.3f,%.1f,%.1f,%.1f\n", scenario.name, name, r.movingS,
+             r.trackingRmsSteps, r.trackingMaxSteps, r.response.settlingTimeS,
+             r.response.overshootPct, r.response.itae, r.innerNsPerSample);
+    }
+  }
+  return 0;
+}
+
+int recordTrace(const char* path, const char* scenarioName, const char* variantFilter) {
+  for (const sim::Scenario& scenario : kScenarios) {
+    if (scenarioName == nullptr || strcmp(scenarioName, scenario.name) != 0) continue;
+    if (scenario.kind == sim::TraceKind::Setpoint) break;
+    sim::Variant variant = sim::Variant::CascadeP;
+    for (const sim::Variant v : kVariants) {
+      if (variantFilter != nullptr && strcmp(variantFilter, sim::variantName(v)) == 0) variant = v;
+    }
+    sim::TraceBuffer trace;
+    sim::runScenario(scenario, variant, &trace);
+    if (!sim::writeTraceFile(path, trace.bytes())) {
+      fprintf(stderr, "cannot write %s\n", path);
+      return 2;
+    }
+    printf("recorded,%s,%lu bytes\n", path, static_cast<unsigned long>(trace.bytes().size()));
+    return 0;
+  }
+  fprintf(stderr, "--record needs --scenario with a touch or input scenario\n");
+  return 2;
+}
+
+int replayTrace(const char* path, uint16_t speed, const char* outPath) {
+  std::vector<uint8_t> recorded;
+  std::vector<uint8_t> replayed;
+  if (!sim::readTraceFile(path, recorded)) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 2;
+  }
+  if (!sim::replayTrace(recorded, speed, replayed)) {
+    fprintf(stderr, "%s: invalid or corrupted trace\n", path);
+    return 2;
+  }
+  if (outPath != nullptr && !sim::writeTraceFile(outPath, replayed)) {
+    fprintf(stderr, "cannot write %s\n", outPath);
+    return 2;
+  }
+  const control::TraceDiff diff =
+      control::diffTraces(recorded.data(), recorded.size(), replayed.data(), replayed.size());
+  printf("trace,identical,records,inputs,outputs,expected_offset,actual_offset\n");
+  printf("%s,%d,%lu,%lu,%lu,%lu,%lu\n", path, diff.identical ? 1 : 0,
+         static_cast<unsigned long>(diff.records), static_cast<unsigned long>(diff.inputs),
+         static_cast<unsigned long>(diff.outputs), static_cast<unsigned long>(diff.expectedOffset),
+         static_cast<unsigned long>(diff.actualOffset));
+  return diff.identical ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* scenarioFilter = nullptr;
+  const char* variantFilter = nullptr;
+  bool bode = false;
+  bool latency = false;
+  bool trackingMode = false;
+  const char* recordPath = nullptr;
+  const char* replayPath = nullptr;
+  const char* outPath = nullptr;
+  uint16_t speed = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--bode") == 0) {
+      bode = true;
+    } else if (strcmp(argv[i], "--latency") == 0) {
+      latency = true;
+    } else if (strcmp(argv[i], "--tracking") == 0) {
+      trackingMode = true;
+    } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+      scenarioFilter = argv[++i];
+    } else if (strcmp(argv[i], "--variant") == 0 && i + 1 < argc) {
+      variantFilter = argv[++i];
+    } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      recordPath = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      replayPath = argv[++i];
+    } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+      speed = static_cast<uint16_t>(atoi(argv[++i]));
+    } else {
+      fprintf(stderr,
+              "usage: program [--bode | --latency | --tracking] [--scenario NAME] [--variant NAME]\n"
+              "       program --record FILE --scenario NAME\n"
+              "       program --replay FILE [--speed N] [--out FILE]\n");
+      return 2;
+    }
+  }
+  if (bode) return runBode(variantFilter);
+  if (latency) return runLatency(scenarioFilter, variantFilter);
+  if (trackingMode) return runTracking(scenarioFilter, variantFilter);
+  if (recordPath != nullptr) return recordTrace(recordPath, scenarioFilter, variantFilter);
+  if (replayPath != nullptr) return replayTrace(replayPath, speed, outPath);
+
+  printf("scenario,variant,segments,settling_s,overshoot_pct,sse_steps,iae,itae,"
+         "unsettled,outer_ns,inner_ns,touch_q_hwm,stepper_q_hwm,dropped,coalesced\n");
+  for (const sim::Scenario& scenario : kScenarios) {
+    if (scenarioFilter != nullptr && strcmp(scenarioFilter, scenario.name) != 0) continue;
+    for (const sim::Variant variant : kVariants) {
+      const char* name = sim::variantName(variant);
+      if (variantFilter != nullptr && strcmp(variantFilter, name) != 0) continue;
+
+      const sim::ScenarioResult r = sim::runScenario(scenario, variant);
+      printf("%s,%s,%lu,%.3f,%.1f,%.2f,%.1f,%.1f,%lu,%.1f,%.1f,%lu,%lu,%lu,%lu\n", scenario.name,
+             name, static_cast<unsigned long>(r.response.segments), r.response.settlingTimeS,
+             r.response.overshootPct, r.response.steadyStateError, r.response.iae,
+             r.response.itae, static_cast<unsigned long>(r.response.unsettled),
+             r.outerNsPerSample, r.innerNsPerSample,
+             static_cast<unsigned long>(r.touchQueueHighWater),
+             static_cast<unsigned long>(r.stepperQueueHighWater),
+             static_cast<unsigned long>(r.dropped), static_cast<unsigned long>(r.coalesced));
+    }
+  }
+  return 0;
+}
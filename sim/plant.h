@@ -0,0 +1,53 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+namespace sim {
+
+// ============================================================================
+// PLANTA SIMULADA: rotor do motor de passo + carga com acoplamento elástico
+// ============================================================================
+//
+// O rotor segue exatamente os passos emitidos pelo gerador (sem perda de
+// passos). A carga, onde está o encoder, é um sistema de 2ª ordem puxado
+// pelo rotor:
+//   x'' = wn²·(rotor − x) − 2·zeta·wn·x'
+// Integração semi-implícita de Euler no período do tick do gerador.
+
+struct PlantConfig {
+  float naturalHz;        // Frequência natural do acoplamento
+  float damping;          // Amortecimento (zeta)
+  int32_t stepsPerRev;    // Passos por volta (microsteps incluídos)
+  int32_t countsPerRev;   // Contagens do encoder por volta (x4)
+};
+
+class FlexibleLoad {
+ public:
+  explicit FlexibleLoad(const PlantConfig& config)
+      : config_(config), wn_(2.0f * 3.14159265f * config.naturalHz) {}
+
+  void step(int32_t rotorSteps, float dt) {
+    const float accel = wn_ * wn_ * (static_cast<float>(rotorSteps) - position_) -
+                        2.0f * config_.damping * wn_ * velocity_;
+    velocity_ += accel * dt;
+    position_ += velocity_ * dt;
+  }
+
+  // Posição da carga em passos (contínua)
+  float position() const { return position_; }
+
+  // Leitura quantizada do encoder, como o PCNT entregaria
+  int64_t encoderCounts() const {
+    return static_cast<int64_t>(
+        lroundf(position_ * config_.countsPerRev / static_cast<float>(config_.stepsPerRev)));
+  }
+
+ private:
+  PlantConfig config_;
+  float wn_;
+  float position_ = 0.0f;
+  float velocity_ = 0.0f;
+};
+
+}  // namespace sim
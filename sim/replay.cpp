@@ -0,0 +1,82 @@
+#include "replay.h"
+
+#include <stdio.h>
+
+#include <chrono>
+#include <thread>
+
+#include "control/pd_lut_law.h"
+
+namespace sim {
+
+void TraceBuffer::begin(uint32_t tickHz) {
+  bytes_.resize(control::kTraceHeaderBytes);
+  encoder_.begin(bytes_.data(), tickHz);
+}
+
+void TraceBuffer::add(const control::TraceRecord& record) {
+  uint8_t encoded[control::kTraceMaxRecordBytes];
+  const size_t n = encoder_.write(record, encoded);
+  bytes_.insert(bytes_.end(), encoded, encoded + n);
+}
+
+bool replayTrace(const std::vector<uint8_t>& recorded, uint16_t speed,
+                 std::vector<uint8_t>& replayed) {
+  control::TraceDecoder decoder(recorded.data(), recorded.size());
+  if (!decoder.valid() || decoder.tickHz() == 0) return false;
+
+  TraceBuffer out;
+  out.begin(decoder.tickHz());
+  control::ScheduledPdLaw law;
+
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point start = Clock::now();
+  bool first = true;
+  uint32_t firstTick = 0;
+
+  control::TraceRecord record;
+  while (decoder.next(record)) {
+    if (record.kind != control::TraceRecordKind::Input) continue;  // Saídas são recalculadas
+
+    if (first) {
+      firstTick = record.input.tick;
+      first = false;
+    }
+    if (speed > 0) {
+      const uint64_t dueUs = static_cast<uint64_t>(record.input.tick - firstTick) * 1000000u /
+                             (static_cast<uint64_t>(decoder.tickHz()) * speed);
+      std::this_thread::sleep_until(start + std::chrono::microseconds(dueUs));
+    }
+
+    out.add(record);
+    const control::MotorCommand command = law.update(record.input.intensity, record.input.direction);
+    if (command.steps != 0) {
+      control::TraceRecord output = {};
+      output.kind = control::TraceRecordKind::Output;
+      output.output = {command.steps, command.speedInStepsPerSec};
+      out.add(output);
+    }
+  }
+  replayed = out.bytes();
+  return !decoder.corrupted();
+}
+
+bool readTraceFile(const char* path, std::vector<uint8_t>& bytes) {
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) return false;
+  bytes.clear();
+  uint8_t chunk[512];
+  size_t n = 0;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+  fclose(file);
+  return true;
+}
+
+bool writeTraceFile(const char* path, const std::vector<uint8_t>& bytes) {
+  FILE* file = fopen(path, "wb");
+  if (file == nullptr) return false;
+  const bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+  return (fclose(file) == 0) && ok;
+}
+
+}  // namespace sim
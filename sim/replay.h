@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "control/trace_codec.h"
+
+namespace sim {
+
+// ============================================================================
+// GRAVAÇÃO E REPLAY DE LOGS DE ENTRADA/SAÍDA NO HOST
+// ============================================================================
+//
+// Mesmo formato do firmware (control/trace_codec.h, trace_task no ESP32):
+// um log gravado na bancada é reexecutado aqui e comparado bit a bit.
+
+// Unidade do carimbo nos logs gravados (trace_task: µs de hal/clock.h).
+// Logs antigos, em ticks do FreeRTOS (1 kHz), continuam válidos no replay:
+// o cabeçalho traz a unidade de cada um
+constexpr uint32_t kTraceTickHz = 1000000;
+
+// Log em memória
+class TraceBuffer {
+ public:
+  void begin(uint32_t tickHz);
+  void add(const control::TraceRecord& record);
+  const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+ private:
+  control::TraceEncoder encoder_;
+  std::vector<uint8_t> bytes_;
+};
+
+// Reenvia cada entrada do log à lei de controle pelo mesmo caminho da
+// control_task (ScheduledPdLaw a partir do estado inicial; só comandos com
+// movimento chegam ao atuador) e grava o novo log em replayed.
+// speed: 1 = tempo real, N = N vezes mais rápido, 0 = sem espera.
+// Retorna false se o log gravado é inválido.
+bool replayTrace(const std::vector<uint8_t>& recorded, uint16_t speed,
+                 std::vector<uint8_t>& replayed);
+
+bool readTraceFile(const char* path, std::vector<uint8_t>& bytes);
+bool writeTraceFile(const char* path, const std::vector<uint8_t>& bytes);
+
+}  // namespace sim
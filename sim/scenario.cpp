@@ -0,0 +1,455 @@
+#include "scenario.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "control/cascade.h"
+#include "control/explicit_mpc.h"
+#include "control/frequency_response.h"
+#include "control/mpc_table.h"
+#include "control/pd_lut_law.h"
+#include "control/pid_loop.h"
+#include "control/sample_clock.h"
+#include "control/touch_classifier.h"
+#include "control/trajectory.h"
+#include "hal/board.h"
+#include "hal/clock.h"
+#include "motion/speed_profile.h"
+#include "motion/step_generator.h"
+#include "motion/tracking_monitor.h"
+#include "plant.h"
+#include "sim_queue.h"
+#include "tasks/task_config.h"
+
+namespace sim {
+namespace {
+
+// Constantes das tasks: as mesmas do firmware (tasks/task_config.h)
+using tasks::kDefaultStepperVelocityAccel;
+using tasks::kFeedforwardGains;
+using tasks::kInnerDecelLimit;
+using tasks::kInnerIdleSamples;
+using tasks::kInnerMaxSampleGapUs;
+using tasks::kInnerPositionGain;
+using tasks::kQueuedMoveAccel;
+using tasks::kStepperMinStepRate;
+using tasks::kStepperSpeedProfile;
+using tasks::kTouchDebounceUs;
+using tasks::kTouchInputQueueLength;
+using tasks::kVelocityWatchdogTicks;
+constexpr uint32_t kTickHz = tasks::kStepperTickHz;
+constexpr uint32_t kTouchPollTicks =
+    static_cast<uint32_t>(static_cast<uint64_t>(kTickHz) * tasks::kTouchPollPeriodUs /
+                          hal::kMicrosPerSecond);
+
+// Ganhos do PID avaliado (malha interna)
+constexpr control::PidGains kPidGains = {24.0f, 60.0f, 0.02f};
+
+// Trajetória sem os termos de feedforward (kFeedforwardGains) para isolar
+// o ganho da antecipação
+constexpr control::FeedforwardGains kProfiledOnlyGains = {kInnerPositionGain, 0.0f, 0.0f};
+
+constexpr uint32_t kInnerTicks = kTickHz / control::kControlRates.innerHz;
+constexpr uint32_t kOuterTicks = kInnerTicks * control::kControlRates.outerDivider;
+
+// Planta: acoplamento de 20 Hz pouco amortecido, encoder do board.h
+constexpr PlantConfig kPlantConfig = {20.0f, 0.2f, hal::kStepperStepsPerRev,
+                                      hal::kEncoderCountsPerRev};
+
+struct SimTouchMessage {
+  int32_t touchValue;
+  uint8_t touchZone;
+  uint16_t intensity;
+  hal::TimestampUs timestampUs;
+};
+
+struct SimStepperMessage {
+  int32_t deltaSteps;
+  float speedInStepsPerSec;
+  float accelInStepsPerSecSec;
+  hal::TimestampUs timestampUs;
+};
+
+// Caixa de correio do stepper_task (mergeStepperMoves, um eixo relativo;
+// o movimento pendente fica com o carimbo mais antigo)
+bool mergeRelativeMoves(SimStepperMessage& pending, const SimStepperMessage& newer) {
+  pending.deltaSteps += newer.deltaSteps;
+  pending.speedInStepsPerSec = newer.speedInStepsPerSec;
+  pending.accelInStepsPerSecSec = newer.accelInStepsPerSecSec;
+  return true;
+}
+
+uint64_t nowNs() {
+  using namespace std::chrono;
+  return static_cast<uint64_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// Custo do próprio par de leituras do relógio (descontado das medições)
+uint64_t timerOverheadNs() {
+  uint64_t best = ~0ull;
+  for (int i = 0; i < 1000; ++i) {
+    const uint64_t a = nowNs();
+    const uint64_t b = nowNs();
+    if (b - a < best) best = b - a;
+  }
+  return best;
+}
+
+int32_t traceValueAt(const Scenario& scenario, float timeS) {
+  int32_t value = scenario.trace[0].value;
+  for (size_t i = 0; i < scenario.traceLength; ++i) {
+    if (scenario.trace[i].timeS > timeS) break;
+    value = scenario.trace[i].value;
+  }
+  return value;
+}
+
+// Mediana do custo por amostra: imune a preempções ocasionais do SO do host
+struct CpuMeter {
+  std::vector<uint32_t> samplesNs;
+  uint64_t overheadNs = 0;
+
+  void add(uint64_t startNs) {
+    const uint64_t elapsed = nowNs() - startNs;
+    samplesNs.push_back(static_cast<uint32_t>((elapsed > overheadNs) ? elapsed - overheadNs : 0));
+  }
+  float medianNs() {
+    if (samplesNs.empty()) return 0.0f;
+    const auto middle = samplesNs.begin() + samplesNs.size() / 2;
+    std::nth_element(samplesNs.begin(), middle, samplesNs.end());
+    return static_cast<float>(*middle);
+  }
+  uint64_t totalNs() const {
+    uint64_t total = 0;
+    for (const uint32_t ns : samplesNs) total += ns;
+    return total;
+  }
+};
+
+// Mesmos pontos de gravação do firmware: entrada da lei e comando ao atuador
+void recordTrace(TraceBuffer& trace, const SimTouchMessage& msg,
+                 const control::MotorCommand& command) {
+  control::TraceRecord record = {};
+  record.kind = control::TraceRecordKind::Input;
+  record.input = {static_cast<uint32_t>(static_cast<uint64_t>(msg.timestampUs) * kTraceTickHz /
+                                        hal::kMicrosPerSecond),
+                  msg.touchValue, msg.touchZone, msg.intensity, 0};
+  trace.add(record);
+  if (command.steps == 0) return;
+  record.kind = control::TraceRecordKind::Output;
+  record.output = {command.steps, command.speedInStepsPerSec};
+  trace.add(record);
+}
+
+}  // namespace
+
+const char* variantName(Variant variant) {
+  switch (variant) {
+    case Variant::PdLutQueued:
+      return "pd_lut_queued";
+    case Variant::CascadeP:
+      return "cascade_p";
+    case Variant::CascadePid:
+      return "cascade_pid";
+    case Variant::CascadeProfiled:
+      return "cascade_profiled";
+    case Variant::CascadeFf:
+      return "cascade_ff";
+    case Variant::CascadeMpc:
+      return "cascade_mpc";
+  }
+  return "?";
+}
+
+const char* schedulingName(Scheduling scheduling) {
+  switch (scheduling) {
+    case Scheduling::TimeTriggered:
+      return "time";
+    case Scheduling::Hybrid:
+      return "hybrid";
+  }
+  return "?";
+}
+
+Scheduling defaultScheduling(Variant variant) {
+  return (variant == Variant::PdLutQueued) ? Scheduling::TimeTriggered : Scheduling::Hybrid;
+}
+
+ScenarioResult runScenario(const Scenario& scenario, Variant variant, TraceBuffer* trace) {
+  return runScenario(scenario, variant, trace, defaultScheduling(variant));
+}
+
+ScenarioResult runScenario(const Scenario& scenario, Variant variant, TraceBuffer* trace,
+                           Scheduling scheduling) {
+  const bool cascaded = variant != Variant::PdLutQueued;
+  const bool hybrid = scheduling == Scheduling::Hybrid;
+  const float innerPeriodS = 1.0f / control::kControlRates.innerHz;
+  const float tickS = 1.0f / kTickHz;
+
+  // Mesmo planejamento do stepper_task: faixas e reforço no gerador, e
+  // nenhum cruzeiro dentro de uma faixa (planStepperCruise())
+  const motion::SpeedPlanner speedPlanner(kStepperSpeedProfile);
+  motion::StepGenerator generator;
+  generator.configure(1);
+  speedPlanner.applyTo(generator, kTickHz);
+  FlexibleLoad plant(kPlantConfig);
+  motion::TrackingMonitor tracking({hal::kStepperStepsPerRev, hal::kEncoderCountsPerRev, 0, 0, 1});
+  tracking.reset(0, 0);
+
+  SimQueue<SimTouchMessage, kTouchInputQueueLength> touchQueue;
+  SimMailbox<SimStepperMessage> stepperQueue(mergeRelativeMoves);
+
+  control::ScheduledPdLaw outerLaw;
+  const control::PositionLoop positionLoop(kInnerPositionGain, kInnerDecelLimit);
+  control::PidLoop pidLoop(kPidGains, innerPeriodS, kInnerDecelLimit);
+  const bool profiled = variant == Variant::CascadeProfiled || variant == Variant::CascadeFf;
+  const control::FeedforwardLoop feedforwardLoop(
+      (variant == Variant::CascadeFf) ? kFeedforwardGains : kProfiledOnlyGains);
+  control::ExplicitMpcLoop mpcLoop(control::kMpcTable, innerPeriodS);
+  control::StreamGate streamGate(kInnerIdleSamples);
+
+  // Trajetória planejada: referência da malha interna nas variantes com
+  // perfil e, em todas, a base do erro de seguimento
+  control::TrajectoryGenerator trajectory(kInnerDecelLimit, innerPeriodS);
+  trajectory.reset(0.0f);
+  control::SampleClock innerClock(control::kControlRates.innerPeriodUs(), kInnerMaxSampleGapUs);
+  float plannedSpeed = speedPlanner.planCruise(scenario.velocityLimit);
+  double trackingSquareSum = 0.0;
+  float trackingMax = 0.0f;
+  uint32_t trackingSamples = 0;
+
+  control::PositionSetpoint setpoint = {0, plannedSpeed, 0};
+  int32_t commandedTarget = 0;  // Alvo acumulado (referência das métricas)
+
+  // Estado da touch_task
+  uint8_t lastZone = 0;
+  hal::TimestampUs lastMessageUs = 0;
+  bool sentAny = false;
+
+  control::ResponseMetrics metrics(2.0f, 2.0f);
+  CpuMeter outerCpu;
+  CpuMeter innerCpu;
+  outerCpu.overheadNs = innerCpu.overheadNs = timerOverheadNs();
+  size_t nextInput = 0;  // Próximo ponto de um cenário Input
+  uint32_t eventWakes = 0;
+  uint32_t inputs = 0;
+  uint64_t latencyUsSum = 0;
+  int64_t latencyUsMax = 0;
+
+  if (trace != nullptr) trace->begin(kTraceTickHz);
+
+  const uint32_t totalTicks = static_cast<uint32_t>(scenario.durationS * kTickHz);
+  for (uint32_t tick = 0; tick < totalTicks; ++tick) {
+    const float timeS = tick * tickS;
+    hal::setSimulatedTimeUs(static_cast<int64_t>(tick) * hal::kMicrosPerSecond / kTickHz);
+
+    // --- touch_task: amostragem, classificação e debounce -----------------
+    if (scenario.kind == TraceKind::Touch && tick % kTouchPollTicks == 0) {
+      const long raw = traceValueAt(scenario, timeS);
+      const uint8_t zone = control::classifyTouchZone(raw);
+      const uint16_t intensity = control::touchIntensity(raw);
+      const bool debounceElapsed = !sentAny || (hal::nowUs() - lastMessageUs) >= kTouchDebounceUs;
+      if (zone != lastZone && debounceElapsed && zone > 0) {
+        touchQueue.send({static_cast<int32_t>(raw), zone, intensity, hal::nowUs()});
+        lastMessageUs = hal::nowUs();
+        sentAny = true;
+      }
+      lastZone = zone;
+    }
+
+    // --- produtor externo: mensagens no instante de cada ponto -------------
+    while (scenario.kind == TraceKind::Input && nextInput < scenario.traceLength &&
+           scenario.trace[nextInput].timeS <= timeS) {
+      const int32_t value = scenario.trace[nextInput++].value;
+      touchQueue.send({value, 0, static_cast<uint16_t>(value), hal::nowUs()});
+    }
+
+    // --- control_task: malha externa (período ou, no híbrido, mensagem) ---
+    const bool periodic = tick % kOuterTicks == kOuterTicks - 1;
+    const bool event = hybrid && touchQueue.size() > 0;
+    if (periodic || event) {
+      const uint64_t start = nowNs();
+      if (!periodic) ++eventWakes;
+      int32_t deltaSteps = 0;
+      float speed = scenario.velocityLimit;
+      if (scenario.kind != TraceKind::Setpoint) {
+        // Híbrido drena a fila e soma os comandos (ActuatorStage::flush)
+        SimTouchMessage msg;
+        bool drained = false;
+        while (!drained && touchQueue.receive(msg)) {
+          const control::MotorCommand command = outerLaw.update(msg.intensity);
+          deltaSteps += command.steps;
+          if (command.steps != 0) speed = command.speedInStepsPerSec;
+          if (trace != nullptr) recordTrace(*trace, msg, command);
+          const int64_t latencyUs = hal::nowUs() - msg.timestampUs;
+          latencyUsSum += latencyUs;
+          latencyUsMax = std::max(latencyUsMax, latencyUs);
+          ++inputs;
+          drained = !hybrid;
+        }
+      } else {
+        deltaSteps = traceValueAt(scenario, timeS) - commandedTarget;
+      }
+      if (deltaSteps != 0) {
+        plannedSpeed = speedPlanner.planCruise(speed);
+        if (cascaded) {
+          setpoint.positionSteps += deltaSteps;
+          setpoint.velocityLimit = plannedSpeed;
+          setpoint.timestampUs = hal::nowUs();
+          commandedTarget += deltaSteps;
+        } else {
+          stepperQueue.send({deltaSteps, speed, kQueuedMoveAccel, hal::nowUs()});
+          commandedTarget += deltaSteps;
+        }
+      }
+      outerCpu.add(start);
+    }
+
+    // --- stepper_task: próximo movimento da fila (modo legado) ------------
+    if (!cascaded && !generator.busy()) {
+      SimStepperMessage msg;
+      if (stepperQueue.receive(msg)) {
+        motion::LinearMove move{};
+        move.deltas[0] = msg.deltaSteps;
+        move.cruiseVelocityQ32 =
+            motion::stepsPerSecToQ32(speedPlanner.planCruise(msg.speedInStepsPerSec), kTickHz);
+        move.accelQ32 = motion::stepsPerSecSecToQ32(msg.accelInStepsPerSecSec, kTickHz);
+        move.minVelocityQ32 = motion::stepsPerSecToQ32(kStepperMinStepRate, kTickHz);
+        generator.start(move);
+      }
+    }
+
+    // --- malha interna + amostragem das métricas ---------------------------
+    if (tick % kInnerTicks == 0) {
+      const int32_t measured = tracking.measuredSteps(plant.encoderCounts());
+      uint64_t start = nowNs();
+      const float dtS = static_cast<float>(innerClock.sample(hal::nowUs())) * 1e-6f;
+      const control::TrajectorySample& reference =
+          trajectory.update(commandedTarget, plannedSpeed, dtS);
+      if (!profiled) start = nowNs();  // Só base das métricas: fora da medição
+      if (cascaded) {
+        float velocity = 0.0f;
+        if (profiled) {
+          velocity = feedforwardLoop.update(reference, setpoint.velocityLimit, measured);
+        } else if (variant == Variant::CascadePid) {
+          velocity = pidLoop.update(setpoint, measured, dtS);
+        } else if (variant == Variant::CascadeMpc) {
+          velocity = mpcLoop.update(setpoint, measured, dtS);
+        } else {
+          velocity = positionLoop.update(setpoint, measured);
+        }
+        // Mesmo caminho de setStepperVelocity() / stopStepperVelocity()
+        switch (streamGate.update(setpoint.positionSteps - measured, velocity)) {
+          case control::StreamAction::Write:
+            if (!generator.busy()) {
+              generator.startVelocity(motion::stepsPerSecSecToQ32(kDefaultStepperVelocityAccel, kTickHz),
+                                      kVelocityWatchdogTicks);
+            }
+            generator.setTargetVelocity(0, motion::signedStepsPerSecToQ32(velocity, kTickHz));
+            break;
+          case control::StreamAction::Stop:
+            generator.requestVelocityStop();
+            break;
+          case control::StreamAction::Hold:
+            break;
+        }
+        innerCpu.add(start);
+      }
+      // Erro de seguimento só durante o movimento planejado
+      if (reference.velocity != 0.0f) {
+        const float error = fabsf(reference.position - plant.position());
+        trackingSquareSum += static_cast<double>(error) * error;
+        trackingMax = std::max(trackingMax, error);
+        ++trackingSamples;
+      }
+      metrics.addSample(timeS, static_cast<float>(commandedTarget), plant.position());
+    }
+
+    // --- ISR do gerador + planta -------------------------------------------
+    generator.tick();
+    plant.step(generator.position(0), tickS);
+  }
+
+  ScenarioResult result{};
+  result.response = metrics.finish();
+  result.outerNsPerSample = outerCpu.medianNs();
+  result.innerNsPerSample = innerCpu.medianNs();
+  result.outerSamples = static_cast<uint32_t>(outerCpu.samplesNs.size());
+  result.innerSamples = static_cast<uint32_t>(innerCpu.samplesNs.size());
+  result.touchQueueHighWater = touchQueue.highWater();
+  result.stepperQueueHighWater = stepperQueue.highWater();
+  result.dropped = touchQueue.dropped() + stepperQueue.dropped();
+  result.coalesced = stepperQueue.coalesced();
+  result.eventWakes = eventWakes;
+  result.outerCpuUsPerS = outerCpu.totalNs() / 1000.0f / scenario.durationS;
+  result.inputs = inputs;
+  result.latencyMeanMs = (inputs > 0) ? latencyUsSum / 1000.0f / inputs : 0.0f;
+  result.latencyMaxMs = latencyUsMax / 1000.0f;
+  result.trackingRmsSteps =
+      (trackingSamples > 0) ? static_cast<float>(sqrt(trackingSquareSum / trackingSamples)) : 0.0f;
+  result.trackingMaxSteps = trackingMax;
+  result.movingS = static_cast<float>(trackingSamples) / control::kControlRates.innerHz;
+  return result;
+}
+
+uint8_t runFrequencyResponse(const control::SweepConfig& config, float velocityAccel,
+                              Variant variant, void (*report)(const control::FrequencyPoint&)) {
+  if (variant == Variant::PdLutQueued) return 0;  // Sem malha interna
+  const float innerPeriodS = 1.0f / control::kControlRates.innerHz;
+  const float tickS = 1.0f / kTickHz;
+
+  motion::StepGenerator generator;
+  generator.configure(1);
+  motion::SpeedPlanner(kStepperSpeedProfile).applyTo(generator, kTickHz);
+  generator.startVelocity(motion::stepsPerSecSecToQ32(velocityAccel, kTickHz),
+                          kVelocityWatchdogTicks);
+  FlexibleLoad plant(kPlantConfig);
+  motion::TrackingMonitor tracking({hal::kStepperStepsPerRev, hal::kEncoderCountsPerRev, 0, 0, 1});
+  tracking.reset(0, 0);
+
+  const control::PositionLoop positionLoop(kInnerPositionGain, kInnerDecelLimit);
+  control::PidLoop pidLoop(kPidGains, innerPeriodS, kInnerDecelLimit);
+  const control::FeedforwardLoop feedforwardLoop(
+      (variant == Variant::CascadeFf) ? kFeedforwardGains : kProfiledOnlyGains);
+  control::ExplicitMpcLoop mpcLoop(control::kMpcTable, innerPeriodS);
+  const control::PositionSetpoint setpoint = {0, 2000.0f, 0};
+  const control::TrajectorySample rest = {0.0f, 0.0f, 0.0f};  // Trajetória parada
+
+  // Mesmo caminho da malha interna do firmware: u = controlador + d
+  control::FrequencySweep sweep;
+  if (!sweep.start(config)) return 0;
+  uint8_t points = 0;
+  for (uint32_t tick = 0; sweep.running(); ++tick) {
+    hal::setSimulatedTimeUs(static_cast<int64_t>(tick) * hal::kMicrosPerSecond / kTickHz);
+    if (tick % kInnerTicks == 0) {
+      const int32_t measured = tracking.measuredSteps(plant.encoderCounts());
+      float controller = 0.0f;
+      if (variant == Variant::CascadeProfiled || variant == Variant::CascadeFf) {
+        controller = feedforwardLoop.update(rest, setpoint.velocityLimit, measured);
+      } else if (variant == Variant::CascadePid) {
+        controller = pidLoop.update(setpoint, measured);
+      } else if (variant == Variant::CascadeMpc) {
+        controller = mpcLoop.update(setpoint, measured);
+      } else {
+        controller = positionLoop.update(setpoint, measured);
+      }
+      const float velocity = controller + sweep.excitation();
+      if (sweep.record(velocity, static_cast<float>(measured))) {
+        control::FrequencyPoint point = sweep.lastPoint();
+        point.timestampUs = hal::nowUs();
+        report(point);
+        ++points;
+      }
+      generator.setTargetVelocity(0, motion::signedStepsPerSecToQ32(velocity, kTickHz));
+    }
+    generator.tick();
+    plant.step(generator.position(0), tickS);
+  }
+  return points;
+}
+
+}  // namespace sim
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "control/frequency_response.h"
+#include "control/response_metrics.h"
+#include "replay.h"
+
+namespace sim {
+
+// ============================================================================
+// CENÁRIOS EM MALHA FECHADA
+// ============================================================================
+//
+// Executa a lógica real do firmware (classifyTouchZone, ScheduledPdLaw, malha
+// interna, StepGenerator, TrackingMonitor) contra a planta simulada,
+// seguindo as mesmas taxas das tasks: gerador a 40 kHz, malha interna a
+// kControlRates.innerHz, touch_task e malha externa a cada 100 ms.
+
+// Variante de controlador avaliada
+enum class Variant : uint8_t {
+  PdLutQueued,  // Legado: um StepperMessage (movimento trapezoidal) por comando
+  CascadeP,     // Cascata com P de posição na malha interna (padrão atual)
+  CascadePid,   // Cascata com PID na malha interna
+  CascadeProfiled,  // Cascata: trajetória planejada + P, sem feedforward
+  CascadeFf,        // Cascata: trajetória planejada + feedforward de velocidade e aceleração
+  CascadeMpc,       // Cascata: MPC explícito (tabela de regiões) na malha interna
+};
+
+const char* variantName(Variant variant);
+
+// Escalonamento da malha externa (control_task: kControlScheduling)
+enum class Scheduling : uint8_t {
+  TimeTriggered,  // Acorda a cada 100 ms e consome uma mensagem
+  Hybrid,         // Também acorda a cada mensagem e drena todas
+};
+
+const char* schedulingName(Scheduling scheduling);
+
+// Padrão do firmware: híbrido na cascata, por período no modo legado
+Scheduling defaultScheduling(Variant variant);
+
+// Entrada roteirizada: valores brutos do sensor de toque (passam pelo
+// classificador, filtro de intensidade, debounce e ScheduledPdLaw),
+// setpoints de posição diretos, ou mensagens externas (sendTouchInputMessage:
+// cada ponto é uma mensagem com intensidade = value, sem debounce).
+enum class TraceKind : uint8_t { Touch, Setpoint, Input };
+
+struct TracePoint {
+  float timeS;    // Vale a partir deste instante até o próximo ponto
+  int32_t value;  // Touch: valor bruto do sensor; Setpoint: posição (passos)
+};
+
+struct Scenario {
+  const char* name;
+  TraceKind kind;
+  const TracePoint* trace;
+  size_t traceLength;
+  float durationS;
+  float velocityLimit;  // Setpoint: velocidade máxima (passos/s)
+};
+
+struct ScenarioResult {
+  control::ResponseSummary response;
+  float outerNsPerSample;    // CPU por amostra da malha externa (mediana, host)
+  float innerNsPerSample;    // CPU por amostra da malha interna (mediana, host)
+  uint32_t outerSamples;
+  uint32_t innerSamples;
+  size_t touchQueueHighWater;
+  size_t stepperQueueHighWater;
+  uint32_t dropped;          // Mensagens descartadas por fila cheia
+  uint32_t coalesced;        // Movimentos fundidos na caixa do stepper_task
+  uint32_t eventWakes;       // Despertares da malha externa por mensagem (híbrido)
+  float outerCpuUsPerS;      // CPU total da malha externa por segundo simulado (host)
+  uint32_t inputs;           // Mensagens de toque processadas pela lei
+  float latencyMeanMs;       // Envio pela touch_task → lei de controle
+  float latencyMaxMs;
+  // Erro de seguimento |trajetória planejada − carga| enquanto ela se move
+  // (control/trajectory.h; mesma trajetória para todas as variantes)
+  float trackingRmsSteps;
+  float trackingMaxSteps;
+  float movingS;             // Tempo com a trajetória em movimento
+};
+
+// trace != nullptr: grava as entradas da lei e os comandos resultantes no
+// formato do trace_task (cenários de toque)
+ScenarioResult runScenario(const Scenario& scenario, Variant variant, TraceBuffer* trace,
+                           Scheduling scheduling);
+
+// Mesmo, com o escalonamento padrão da variante
+ScenarioResult runScenario(const Scenario& scenario, Variant variant,
+                           TraceBuffer* trace = nullptr);
+
+// Varredura de Bode na malha interna simulada (referência parada em 0),
+// com o mesmo FrequencySweep do firmware e a aceleração do modo velocidade
+// elevada para velocityAccel durante a medição. Retorna o número de pontos.
+uint8_t runFrequencyResponse(const control::SweepConfig& config, float velocityAccel,
+                             Variant variant, void (*report)(const control::FrequencyPoint&));
+
+}  // namespace sim
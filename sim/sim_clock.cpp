@@ -0,0 +1,17 @@
+#include "hal/clock.h"
+
+// Relógio simulado do hal/clock.h: só anda quando o simulador avança
+namespace hal {
+namespace {
+
+TimestampUs gSimulatedTimeUs = 0;
+
+}  // namespace
+
+TimestampUs nowUs() { return gSimulatedTimeUs; }
+
+void setSimulatedTimeUs(TimestampUs timeUs) { gSimulatedTimeUs = timeUs; }
+
+void advanceSimulatedTimeUs(int64_t deltaUs) { gSimulatedTimeUs += deltaUs; }
+
+}  // namespace hal
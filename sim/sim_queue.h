@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace sim {
+
+// Fila limitada com a semântica de xQueueSend(..., 0): cheia → descarta.
+// Registra a maior ocupação (high-water mark) e os descartes.
+template <typename T, size_t N>
+class SimQueue {
+ public:
+  bool send(const T& item) {
+    if (count_ == N) {
+      ++dropped_;
+      return false;
+    }
+    items_[(head_ + count_) % N] = item;
+    ++count_;
+    if (count_ > highWater_) highWater_ = count_;
+    return true;
+  }
+
+  bool receive(T& item) {
+    if (count_ == 0) return false;
+    item = items_[head_];
+    head_ = (head_ + 1) % N;
+    --count_;
+    return true;
+  }
+
+  size_t size() const { return count_; }
+  size_t highWater() const { return highWater_; }
+  uint32_t dropped() const { return dropped_; }
+
+ private:
+  T items_[N] = {};
+  size_t head_ = 0;
+  size_t count_ = 0;
+  size_t highWater_ = 0;
+  uint32_t dropped_ = 0;
+};
+
+// Caixa de correio de uma posição com fusão (ChannelPolicy::Coalesce do
+// firmware, tasks/channel.h): a mensagem nova é fundida na pendente por
+// merge(pending, newer); se não der, substitui a pendente (descarte).
+template <typename T>
+class SimMailbox {
+ public:
+  using MergeFn = bool (*)(T& pending, const T& newer);
+
+  explicit SimMailbox(MergeFn merge) : merge_(merge) {}
+
+  bool send(const T& item) {
+    if (!full_) {
+      item_ = item;
+      full_ = true;
+      highWater_ = 1;
+    } else if (merge_(item_, item)) {
+      ++coalesced_;
+    } else {
+      item_ = item;
+      ++dropped_;
+    }
+    return true;
+  }
+
+  bool receive(T& item) {
+    if (!full_) return false;
+    item = item_;
+    full_ = false;
+    return true;
+  }
+
+  size_t size() const { return full_ ? 1 : 0; }
+  size_t highWater() const { return highWater_; }
+  uint32_t dropped() const { return dropped_; }
+  uint32_t coalesced() const { return coalesced_; }
+
+ private:
+  MergeFn merge_;
+  T item_ = {};
+  bool full_ = false;
+  size_t highWater_ = 0;
+  uint32_t dropped_ = 0;
+  uint32_t coalesced_ = 0;
+};
+
+}  // namespace sim
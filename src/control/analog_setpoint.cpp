@@ -0,0 +1,67 @@
+#include "control/analog_setpoint.h"
+
+namespace control {
+namespace {
+
+// Limiares de zona do toque convertidos para intensidade: o display mostra
+// a mesma escala 0..3 com qualquer fonte
+constexpr uint16_t intensityAt(long touchValue) {
+  return static_cast<uint16_t>(
+      (static_cast<uint32_t>(kNoTouchThreshold - touchValue) * kTouchIntensityScaleQ8) >> 8);
+}
+
+constexpr uint16_t kLightZoneIntensity = 1;
+constexpr uint16_t kMediumZoneIntensity = intensityAt(kLightTouchThreshold);
+constexpr uint16_t kStrongZoneIntensity = intensityAt(kMediumTouchThreshold);
+
+}  // namespace
+
+uint16_t analogIntensity(uint32_t meanQ4) {
+  constexpr uint32_t kMinQ4 = static_cast<uint32_t>(kAnalogRawMin) << 4;
+  if (meanQ4 <= kMinQ4) return 0;
+  const uint32_t scaled = ((meanQ4 - kMinQ4) * kAnalogIntensityScaleQ16 + (1u << 19)) >> 20;
+  return static_cast<uint16_t>((scaled > kTouchIntensityMax) ? kTouchIntensityMax : scaled);
+}
+
+uint8_t intensityZone(uint16_t intensity) {
+  if (intensity >= kStrongZoneIntensity) return 3;
+  if (intensity >= kMediumZoneIntensity) return 2;
+  if (intensity >= kLightZoneIntensity) return 1;
+  return 0;
+}
+
+bool AnalogSetpointFilter::update(uint32_t sum, uint32_t samples, AnalogSetpoint& out) {
+  // ETAPA 1: decimação — média do bloco em Q4
+  const int32_t meanQ4 = (samples > 0) ? static_cast<int32_t>((sum << 4) / samples) : stateQ4_;
+
+  // ETAPA 2: média exponencial entre blocos (o primeiro bloco inicializa)
+  if (!primed_) {
+    stateQ4_ = meanQ4;
+    primed_ = true;
+  } else {
+    stateQ4_ += (meanQ4 - stateQ4_) >> kShift;
+  }
+
+  // ETAPA 3: escala para intensidade e zona
+  out.raw = static_cast<uint16_t>((stateQ4_ + 8) >> 4);
+  out.intensity = analogIntensity(static_cast<uint32_t>(stateQ4_));
+  out.zone = intensityZone(out.intensity);
+
+  // ETAPA 4: histerese — ruído abaixo de kHysteresis não gera evento
+  const int32_t delta = static_cast<int32_t>(out.intensity) - static_cast<int32_t>(published_);
+  const bool crossedEnd = (out.intensity != published_) &&
+                          (out.intensity == 0 || out.intensity == kTouchIntensityMax);
+  if (delta <= kHysteresis && delta >= -static_cast<int32_t>(kHysteresis) && !crossedEnd) {
+    return false;
+  }
+  published_ = out.intensity;
+  return true;
+}
+
+void AnalogSetpointFilter::reset() {
+  stateQ4_ = 0;
+  primed_ = false;
+  published_ = 0;
+}
+
+}  // namespace control
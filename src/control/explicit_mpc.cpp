@@ -0,0 +1,81 @@
+#include "control/explicit_mpc.h"
+
+#include "control/mpc_table.h"
+
+namespace control {
+namespace {
+
+constexpr int32_t kQ15One = 1 << 15;
+
+static_assert(mpcTableValid(kMpcTable), "Tabela do MPC inconsistente (regenerar com tools/)");
+static_assert(sizeof(kMpcHalfspaces) / sizeof(kMpcHalfspaces[0]) <= kMpcCheckBudget,
+              "Busca do MPC passa do orçamento de semiplanos por amostra");
+
+int32_t clampQ15(int32_t value) {
+  if (value > kQ15One) return kQ15One;
+  if (value < -kQ15One) return -kQ15One;
+  return value;
+}
+
+}  // namespace
+
+size_t locateMpcRegion(const MpcTable& table, int32_t xe, int32_t xv) {
+  // Menor violação vista até agora (fallback); uma região cuja violação
+  // parcial já chega nela é descartada sem avaliar o resto dos semiplanos
+  int32_t bestViolation = INT32_MAX;
+  size_t best = 0;
+  for (size_t r = 0; r < table.regionCount; ++r) {
+    const MpcRegion& region = table.regions[r];
+    const MpcHalfspace* plane = table.halfspaces + region.first;
+    int32_t violation = INT32_MIN;
+    for (uint16_t i = 0; i < region.count && violation < bestViolation; ++i, ++plane) {
+      const int32_t margin =
+          static_cast<int32_t>(plane->h1) * xe + static_cast<int32_t>(plane->h2) * xv - plane->k;
+      if (margin > violation) violation = margin;
+    }
+    if (violation <= 0) return r;
+    if (violation < bestViolation) {
+      bestViolation = violation;
+      best = r;
+    }
+  }
+  return best;
+}
+
+int32_t evaluateMpcLaw(const MpcRegion& region, int32_t xe, int32_t xv) {
+  const int64_t sum =
+      static_cast<int64_t>(region.gainE) * xe + static_cast<int64_t>(region.gainV) * xv;
+  return clampQ15(static_cast<int32_t>(sum >> 16) + region.offset);
+}
+
+ExplicitMpcLoop::ExplicitMpcLoop(const MpcTable& table, float samplePeriodS)
+    : table_(table),
+      samplePeriodS_(samplePeriodS),
+      positionRange_(static_cast<int32_t>(table.positionRange)),
+      errorScale_(static_cast<int64_t>((kQ15One - 1) * 65536.0f / table.positionRange)),
+      velocityScale_((kQ15One - 1) / table.velocityLimit) {}
+
+float ExplicitMpcLoop::update(const PositionSetpoint& setpoint, int32_t measuredSteps,
+                              float dtS) {
+  // Estado normalizado: erro y − r saturado na faixa da tabela, velocidade comandada
+  int32_t error = measuredSteps - setpoint.positionSteps;
+  if (error > positionRange_) error = positionRange_;
+  if (error < -positionRange_) error = -positionRange_;
+  const int32_t xe = static_cast<int32_t>((error * errorScale_) >> 16);
+  const int32_t xv = clampQ15(static_cast<int32_t>(velocity_ * velocityScale_));
+
+  lastRegion_ = locateMpcRegion(table_, xe, xv);
+  const int32_t accelQ15 = evaluateMpcLaw(table_.regions[lastRegion_], xe, xv);
+
+  // v[k+1] = v[k] + a·dt, dentro do limite da tabela e do setpoint
+  const float accel = static_cast<float>(accelQ15) * (table_.accelLimit / kQ15One);
+  float velocity = velocity_ + accel * dtS;
+  float limit = table_.velocityLimit;
+  if (setpoint.velocityLimit < limit) limit = setpoint.velocityLimit;
+  if (velocity > limit) velocity = limit;
+  if (velocity < -limit) velocity = -limit;
+  velocity_ = velocity;
+  return velocity;
+}
+
+}  // namespace control
@@ -0,0 +1,126 @@
+#include "control/frequency_response.h"
+
+#include <math.h>
+
+namespace control {
+namespace {
+
+constexpr float kPi = 3.14159265f;
+constexpr uint8_t kMaxPoints = 64;
+constexpr uint32_t kMinSamplesPerCycle = 4;
+
+struct Ratio {
+  float re;
+  float im;
+};
+
+Ratio divide(float aRe, float aIm, float bRe, float bIm) {
+  const float den = bRe * bRe + bIm * bIm;
+  if (den <= 0.0f) return {0.0f, 0.0f};
+  return {(aRe * bRe + aIm * bIm) / den, (aIm * bRe - aRe * bIm) / den};
+}
+
+float gainDb(const Ratio& r) {
+  const float mag = sqrtf(r.re * r.re + r.im * r.im);
+  return (mag > 1e-12f) ? 20.0f * log10f(mag) : -240.0f;
+}
+
+float phaseDeg(const Ratio& r) {
+  return atan2f(r.im, r.re) * 180.0f / kPi;
+}
+
+}  // namespace
+
+bool FrequencySweep::start(const SweepConfig& config) {
+  if (config.startHz <= 0.0f || config.stopHz < config.startHz) return false;
+  if (config.pointsPerDecade == 0 || config.measureCycles == 0 || config.sampleHz == 0) return false;
+  if (config.stopHz * kMinSamplesPerCycle > config.sampleHz) return false;
+
+  config_ = config;
+  const float decades = log10f(config.stopHz / config.startHz);
+  const uint32_t points = static_cast<uint32_t>(decades * config.pointsPerDecade + 1e-3f) + 1;
+  pointCount_ = static_cast<uint8_t>((points > kMaxPoints) ? kMaxPoints : points);
+  pointIndex_ = 0;
+  samplesPerCycle_ = 0;
+  beginPoint();
+  running_ = true;
+  return true;
+}
+
+void FrequencySweep::beginPoint() {
+  // Período inteiro em amostras: a janela tem ciclos completos e os bins
+  // ficam exatamente ortogonais. Pontos que caem no mesmo período são pulados.
+  uint32_t samplesPerCycle = 0;
+  for (;;) {
+    const float nominalHz = config_.startHz *
+        powf(10.0f, static_cast<float>(pointIndex_) / config_.pointsPerDecade);
+    samplesPerCycle = static_cast<uint32_t>(config_.sampleHz / nominalHz + 0.5f);
+    if (samplesPerCycle < kMinSamplesPerCycle) samplesPerCycle = kMinSamplesPerCycle;
+    if (samplesPerCycle != samplesPerCycle_ || pointIndex_ + 1 >= pointCount_) break;
+    ++pointIndex_;
+  }
+
+  samplesPerCycle_ = samplesPerCycle;
+  hz_ = static_cast<float>(config_.sampleHz) / samplesPerCycle;
+  const float w = 2.0f * kPi / samplesPerCycle;
+  stepCos_ = cosf(w);
+  stepSin_ = sinf(w);
+  cos_ = 1.0f;
+  sin_ = 0.0f;
+
+  settleSamples_ = config_.settleCycles * samplesPerCycle;
+  measureSamples_ = config_.measureCycles * samplesPerCycle;
+  sample_ = 0;
+  d_ = u_ = y_ = Bin{0.0f, 0.0f};
+}
+
+bool FrequencySweep::record(float plantInput, float plantOutput) {
+  if (!running_) return false;
+
+  if (sample_ >= settleSamples_) {
+    // X += x[k]·e^(−jwk)
+    const float d = config_.amplitude * sin_;
+    d_.re += d * cos_;
+    d_.im -= d * sin_;
+    u_.re += plantInput * cos_;
+    u_.im -= plantInput * sin_;
+    y_.re += plantOutput * cos_;
+    y_.im -= plantOutput * sin_;
+  }
+
+  ++sample_;
+  if (sample_ % samplesPerCycle_ == 0) {
+    // Fim de um período inteiro: fase volta a zero exatamente (sem deriva)
+    cos_ = 1.0f;
+    sin_ = 0.0f;
+  } else {
+    const float c = cos_ * stepCos_ - sin_ * stepSin_;
+    sin_ = sin_ * stepCos_ + cos_ * stepSin_;
+    cos_ = c;
+  }
+
+  if (sample_ < settleSamples_ + measureSamples_) return false;
+
+  finishPoint();
+  ++pointIndex_;
+  if (pointIndex_ >= pointCount_) {
+    running_ = false;
+  } else {
+    beginPoint();
+  }
+  return true;
+}
+
+void FrequencySweep::finishPoint() {
+  const Ratio plant = divide(y_.re, y_.im, u_.re, u_.im);
+  const Ratio loop = divide(d_.re - u_.re, d_.im - u_.im, u_.re, u_.im);
+
+  lastPoint_.index = pointIndex_;
+  lastPoint_.hz = hz_;
+  lastPoint_.plantGainDb = gainDb(plant);
+  lastPoint_.plantPhaseDeg = phaseDeg(plant);
+  lastPoint_.loopGainDb = gainDb(loop);
+  lastPoint_.loopPhaseDeg = phaseDeg(loop);
+}
+
+}  // namespace control
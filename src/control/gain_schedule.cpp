@@ -0,0 +1,73 @@
+#include "control/gain_schedule.h"
+
+#include "control/touch_classifier.h"
+
+namespace control {
+namespace {
+
+// ============================================================================
+// TABELA PADRÃO (variável de escalonamento = intensidade do toque)
+// ============================================================================
+//
+// Passa pelos valores da antiga LUT de zonas no centro de cada zona e
+// interpola entre eles:
+//   s = 0   (sem toque)            →   0 passos,  500 passos/s (2000 μs)
+//   s = 48  (leve, valor ≈ 40)     →  50 passos,  667 passos/s (1500 μs)
+//   s = 144 (médio, valor ≈ 22)    → 200 passos, 1250 passos/s ( 800 μs)
+//   s = 224 (forte, valor ≈ 6)     → 500 passos, 3333 passos/s ( 300 μs)
+//
+// Kp = 8 e Kd = 2 por zona equivalem a ≈ 0,1 e 0,025 por unidade de s
+// (uma zona ≈ 80 unidades): 26 e 6 em Q8.
+// ============================================================================
+
+constexpr int32_t kKpQ8 = 26;
+constexpr int32_t kKdQ8 = 6;
+
+constexpr ScheduleAnchor kTouchAnchors[] = {
+    {0, {0, 500, kKpQ8, kKdQ8}},
+    {48, {50, 667, kKpQ8, kKdQ8}},
+    {144, {200, 1250, kKpQ8, kKdQ8}},
+    {224, {500, 3333, kKpQ8, kKdQ8}},
+    {kScheduleSpan, {500, 3333, kKpQ8, kKdQ8}},
+};
+
+static_assert(anchorsAscending(kTouchAnchors), "âncoras fora de ordem");
+static_assert(kScheduleSpan == kTouchIntensityMax, "tabela deve cobrir toda a intensidade");
+
+constexpr GainSchedule kTouchSchedule = makeGainSchedule(kTouchAnchors);
+
+// Carga pesada: mesmos passos e ganhos, velocidades a ~60% da tabela do
+// toque (menos torque na aceleração de uma carga com mais inércia)
+constexpr ScheduleAnchor kHeavyLoadAnchors[] = {
+    {0, {0, 300, kKpQ8, kKdQ8}},
+    {48, {50, 400, kKpQ8, kKdQ8}},
+    {144, {200, 750, kKpQ8, kKdQ8}},
+    {224, {500, 2000, kKpQ8, kKdQ8}},
+    {kScheduleSpan, {500, 2000, kKpQ8, kKdQ8}},
+};
+
+static_assert(anchorsAscending(kHeavyLoadAnchors), "âncoras fora de ordem");
+
+constexpr GainSchedule kHeavyLoadSchedule = makeGainSchedule(kHeavyLoadAnchors);
+
+constexpr const GainSchedule* kSchedules[] = {&kTouchSchedule, &kHeavyLoadSchedule};
+static_assert(sizeof(kSchedules) / sizeof(kSchedules[0]) == kGainScheduleCount,
+              "uma tabela por GainScheduleId");
+
+// Âncoras na grade são reproduzidas exatamente; entre elas, interpolação
+static_assert(kTouchSchedule.points[3].baseSteps == 50, "âncora leve");
+static_assert(kTouchSchedule.points[9].stepsPerSec == 1250, "âncora média");
+static_assert(kTouchSchedule.points[14].baseSteps == 500, "âncora forte");
+static_assert(kTouchSchedule.points[6].baseSteps == 125, "meio do caminho leve → médio");
+
+}  // namespace
+
+const GainSchedule& defaultGainSchedule() {
+  return kTouchSchedule;
+}
+
+const GainSchedule* gainScheduleFor(uint8_t id) {
+  return (id < kGainScheduleCount) ? kSchedules[id] : nullptr;
+}
+
+}  // namespace control
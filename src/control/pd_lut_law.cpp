@@ -0,0 +1,269 @@
+#include "control/pd_lut_law.h"
+
+namespace control {
+namespace {
+
+// ============================================================================
+// PARÂMETROS DA FUNÇÃO DE TRANSFERÊNCIA
+// ============================================================================
+// 
+// Em sistemas de controle digital, a função de transferência G(z) relaciona
+// a entrada (sensor) com a saída (atuador) no domínio z (transformada Z).
+// 
+// Para um controlador simples proporcional-derivativo (PD):
+//   U(z) = Kp * E(z) + Kd * (E(z) - E(z^-1)) / Ts
+// 
+// Onde:
+//   U(z) = sinal de controle (número de passos do motor)
+//   E(z) = erro atual (diferença entre setpoint e valor medido)
+//   E(z^-1) = erro anterior (um período de amostragem atrás)
+//   Kp = ganho proporcional
+//   Kd = ganho derivativo
+//   Ts = período de amostragem
+// ============================================================================
+
+// Ganho proporcional - Define quanto a saída responde ao erro atual
+// Valores maiores = resposta mais agressiva
+constexpr float kProportionalGain = 8.0f;  // Kp
+
+// Ganho derivativo - Define quanto a saída responde à taxa de variação do erro
+// Ajuda a reduzir overshoot e melhorar estabilidade
+constexpr float kDerivativeGain = 2.0f;    // Kd
+
+// Valor mínimo de comando para vencer atrito estático do motor
+// Zona morta (deadband) - comandos menores são ignorados
+constexpr uint32_t kMinSteps = 10;
+
+// Valor máximo de passos por comando (saturação)
+// Limita a saída para evitar movimentos bruscos
+constexpr uint32_t kMaxSteps = 1000;
+
+
+// ============================================================================
+// MAPEAMENTO ENTRADA → SAÍDA
+// ============================================================================
+//
+// Função de transferência implementada em código:
+// Converte zona de toque (entrada digital) em número de passos (saída digital)
+//
+// Este mapeamento representa a relação estática do sistema:
+//   Zona 0 (sem toque)     → 0 passos      → sem movimento
+//   Zona 1 (toque leve)    → 50 passos     → movimento suave
+//   Zona 2 (toque médio)   → 200 passos    → movimento moderado
+//   Zona 3 (toque forte)   → 500 passos    → movimento rápido
+//
+// Em termos de controle digital, esta é uma LUT (Look-Up Table) que
+// implementa uma função não-linear: y[k] = f(u[k])
+// ============================================================================
+
+// Tabela de mapeamento: zona de toque → número de passos base
+constexpr uint32_t kZoneToStepsMap[] = {
+    0,      // Zona 0: sem toque → sem movimento
+    50,     // Zona 1: toque leve → 50 passos
+    200,    // Zona 2: toque médio → 200 passos
+    500     // Zona 3: toque forte → 500 passos
+};
+
+// Velocidades de rotação por zona (intervalo entre pulsos em microsegundos)
+// Intervalos menores = velocidade maior
+constexpr uint32_t kZoneToSpeedMap[] = {
+    2000,   // Zona 0: N/A (não usado)
+    1500,   // Zona 1: lento (1500μs entre pulsos)
+    800,    // Zona 2: médio (800μs entre pulsos)
+    300     // Zona 3: rápido (300μs entre pulsos)
+};
+
+constexpr size_t kZoneCount = sizeof(kZoneToStepsMap) / sizeof(kZoneToStepsMap[0]);
+
+}  // namespace
+
+
+ZoneMapping mapZone(uint8_t zone) {
+  ZoneMapping mapping = {0, 1000};
+  if (zone < kZoneCount) {
+    mapping.baseSteps = kZoneToStepsMap[zone];
+    mapping.speedInterval = kZoneToSpeedMap[zone];
+  }
+  return mapping;
+}
+
+float intervalToStepsPerSec(uint32_t speedInterval) {
+  // Converte velocidade de intervalo (μs) para steps/segundo
+  // Fórmula: steps/sec = 1.000.000 / intervalUs
+  return (speedInterval > 0) ? (1000000.0f / speedInterval) : 500.0f;
+}
+
+
+// ============================================================================
+// FUNÇÃO DE PROCESSAMENTO DO CONTROLADOR
+// ============================================================================
+//
+// Esta é a implementação da função de transferência discreta (digital).
+// Ela recebe a entrada (zona de toque) e calcula a saída (comando do motor);
+// o envio ao atuador (ETAPA 9) fica com a control_task.
+//
+// Fluxo do processamento:
+// 1. Lê entrada do sensor (via fila de mensagens)
+// 2. Calcula erro: e[k] = setpoint - medição
+// 3. Aplica lei de controle: u[k] = f(e[k], e[k-1], ...)
+// 4. Satura/limita a saída
+// 5. Envia comando ao atuador (motor de passo)
+// 6. Atualiza estados para próxima iteração
+// ============================================================================
+
+MotorCommand PdLutLaw::update(uint8_t zone) {
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 1: EXTRAÇÃO DA ZONA DE TOQUE (entrada do sistema)
+  // -------------------------------------------------------------------------
+  // A zona representa a intensidade do toque (0 a 3)
+  // Esta é nossa entrada discreta: u[k] (parâmetro zone)
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 2: MAPEAMENTO ENTRADA → PASSOS BASE (função de transferência)
+  // -------------------------------------------------------------------------
+  // Aqui aplicamos a tabela de conversão (LUT)
+  // Esta é a relação estática: passos_base = G_static(zona)
+  // 
+  // Matematicamente: y_base[k] = f(u[k])
+  const ZoneMapping mapping = mapZone(zone);
+  uint32_t baseSteps = mapping.baseSteps;          // Número de passos pela zona
+  uint32_t speedInterval = mapping.speedInterval;  // Velocidade pela zona
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 3: CÁLCULO DO ERRO (componente proporcional)
+  // -------------------------------------------------------------------------
+  // O erro é a diferença entre a zona desejada e a zona anterior
+  // Isso permite um comportamento mais suave e controlado
+  // 
+  // Erro atual: e[k] = referência[k] - medição[k]
+  // Para este sistema simplificado: e[k] = zona[k] - zona[k-1]
+  int32_t currentError = static_cast<int32_t>(zone) - static_cast<int32_t>(state_.lastZone);
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 4: COMPONENTE DERIVATIVA (taxa de variação)
+  // -------------------------------------------------------------------------
+  // A derivada discreta aproxima: d/dt ≈ (e[k] - e[k-1]) / Ts
+  // Isso nos dá informação sobre a tendência do erro
+  // 
+  // Derivada do erro: de[k] = e[k] - e[k-1]
+  int32_t errorDerivative = currentError - state_.lastError;
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 5: LEI DE CONTROLE PD (Proporcional-Derivativo)
+  // -------------------------------------------------------------------------
+  // Combinamos os componentes proporcional e derivativo
+  // 
+  // Sinal de controle: u[k] = Kp * e[k] + Kd * de[k]
+  // 
+  // O componente proporcional (Kp * e[k]) corrige o erro atual
+  // O componente derivativo (Kd * de[k]) antecipa mudanças futuras
+  float controlSignal = (kProportionalGain * currentError) + 
+                        (kDerivativeGain * errorDerivative);
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 6: COMBINAÇÃO COM O MAPEAMENTO BASE
+  // -------------------------------------------------------------------------
+  // Somamos o sinal de controle aos passos base da zona
+  // Isso permite ajuste fino além do mapeamento estático
+  // 
+  // Saída total: y[k] = y_base[k] + u[k]
+  int32_t totalSteps = baseSteps + static_cast<int32_t>(controlSignal);
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 7: SATURAÇÃO E ZONA MORTA
+  // -------------------------------------------------------------------------
+  // Limitamos a saída para valores fisicamente realizáveis
+  // 
+  // Zona morta: se |y[k]| < threshold, então y[k] = 0
+  // Saturação superior: se y[k] > max, então y[k] = max
+  // Saturação inferior: se y[k] < 0, então y[k] = 0
+  uint32_t commandSteps = 0;
+  
+  if (totalSteps < static_cast<int32_t>(kMinSteps)) {
+    // Zona morta - movimento muito pequeno é ignorado
+    commandSteps = 0;
+  } else if (totalSteps > static_cast<int32_t>(kMaxSteps)) {
+    // Saturação superior - limita movimento máximo
+    commandSteps = kMaxSteps;
+  } else {
+    // Faixa válida - usa o valor calculado
+    commandSteps = static_cast<uint32_t>(totalSteps);
+  }
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 8: DETERMINAR DIREÇÃO DO MOVIMENTO
+  // -------------------------------------------------------------------------
+  // Alternamos a direção para demonstrar controle bidirecional
+  // Em um sistema real, isso seria determinado pelo sinal do erro
+  int32_t directionMultiplier = state_.alternateDirection ? -1 : 1;
+  
+  MotorCommand command = {0, 0.0f};
+  if (commandSteps > 0) {
+    command.steps = static_cast<int32_t>(commandSteps) * directionMultiplier;
+    command.speedInStepsPerSec = intervalToStepsPerSec(speedInterval);
+  }
+  
+  // -------------------------------------------------------------------------
+  // ETAPA 10: ATUALIZAR ESTADOS PARA PRÓXIMA ITERAÇÃO
+  // -------------------------------------------------------------------------
+  // Armazenamos os valores atuais para uso no próximo ciclo
+  // Isso implementa o "atraso" (z^-1) da função de transferência discreta
+  // 
+  // Estado[k] → Estado[k-1] para o próximo ciclo
+  state_.lastError = currentError;
+  state_.lastZone = zone;
+  state_.alternateDirection = !state_.alternateDirection;
+  
+  return command;
+}
+
+
+
+// ============================================================================
+// LEI PD ESCALONADA
+// ============================================================================
+//
+// ETAPAS equivalentes às da PdLutLaw; a LUT de zonas (ETAPA 2) dá lugar à
+// tabela interpolada e a velocidade já sai em passos/s (sem 1e6/intervalo).
+// ============================================================================
+
+MotorCommand ScheduledPdLaw::update(uint16_t input, int8_t direction) {
+  // ETAPA 2: passos base, velocidade e ganhos no ponto de operação atual
+  const ScheduledGains gains = scheduler_.lookup(input);
+
+  // ETAPAS 3 e 4: erro e derivada na unidade da variável de escalonamento
+  const int32_t currentError = static_cast<int32_t>(input) - static_cast<int32_t>(state_.lastInput);
+  const int32_t errorDerivative = currentError - state_.lastError;
+
+  // ETAPAS 5 e 6: u[k] = Kp(s)·e[k] + Kd(s)·de[k] (Q8) somado aos passos base
+  const int32_t controlSignal = (gains.kpQ8 * currentError + gains.kdQ8 * errorDerivative) >> 8;
+  const int32_t totalSteps = gains.baseSteps + controlSignal;
+
+  // ETAPA 7: saturação e zona morta
+  uint32_t commandSteps = 0;
+  if (totalSteps < static_cast<int32_t>(kMinSteps)) {
+    commandSteps = 0;
+  } else if (totalSteps > static_cast<int32_t>(kMaxSteps)) {
+    commandSteps = kMaxSteps;
+  } else {
+    commandSteps = static_cast<uint32_t>(totalSteps);
+  }
+
+  // ETAPA 8: sentido pedido pela fonte ou, sem ele, direção alternada
+  const bool reverse = (direction != 0) ? direction < 0 : state_.alternateDirection;
+  MotorCommand command = {0, 0.0f};
+  if (commandSteps > 0) {
+    command.steps = static_cast<int32_t>(commandSteps) * (reverse ? -1 : 1);
+    command.speedInStepsPerSec = static_cast<float>(gains.stepsPerSec);
+  }
+
+  // ETAPA 10: estados para a próxima amostra (z^-1)
+  state_.lastError = currentError;
+  state_.lastInput = input;
+  if (direction == 0) state_.alternateDirection = !state_.alternateDirection;
+
+  return command;
+}
+
+}  // namespace control
@@ -0,0 +1,98 @@
+#include "control/response_metrics.h"
+
+namespace control {
+namespace {
+
+inline float absValue(float v) { return (v < 0.0f) ? -v : v; }
+
+}  // namespace
+
+void ResponseMetrics::addSample(float timeS, float reference, float measured) {
+  if (!active_) {
+    active_ = true;
+    lastTime_ = timeS;
+    openSegment(timeS, measured, reference);
+  } else if (reference != lastReference_) {
+    closeSegment();
+    openSegment(timeS, measured, reference);
+  }
+  lastReference_ = reference;
+
+  const float dt = timeS - lastTime_;
+  lastTime_ = timeS;
+
+  const float error = absValue(reference - measured);
+  const float sinceStep = timeS - segmentStart_;
+  summary_.iae += error * dt;
+  summary_.itae += sinceStep * error * dt;
+
+  // Faixa de acomodação do degrau atual (degrau medido a partir da posição
+  // real no início do segmento, que pode não ter acomodado ainda)
+  const float step = absValue(segmentTo_ - segmentFrom_);
+  const float relative = step * bandPct_ / 100.0f;
+  const float band = (relative > band_) ? relative : band_;
+  wasOutside_ = error > band;
+  if (wasOutside_) lastOutsideBand_ = timeS;
+
+  // Ultrapassagem no sentido do degrau
+  if (step >= 1.0f) {
+    const float direction = (segmentTo_ > segmentFrom_) ? 1.0f : -1.0f;
+    const float beyond = (measured - segmentTo_) * direction;
+    if (beyond > maxOvershoot_) maxOvershoot_ = beyond;
+  }
+
+  recentTime_[recentHead_] = timeS;
+  recentError_[recentHead_] = error;
+  recentHead_ = (recentHead_ + 1) % kMaxRecent;
+  if (recentCount_ < kMaxRecent) ++recentCount_;
+}
+
+ResponseSummary ResponseMetrics::finish() {
+  if (active_) {
+    closeSegment();
+    active_ = false;
+  }
+  ResponseSummary result = summary_;
+  if (result.segments > 0) result.steadyStateError = steadyStateSum_ / result.segments;
+  return result;
+}
+
+void ResponseMetrics::openSegment(float timeS, float from, float to) {
+  segmentStart_ = timeS;
+  segmentFrom_ = from;
+  segmentTo_ = to;
+  lastOutsideBand_ = timeS;
+  maxOvershoot_ = 0.0f;
+  wasOutside_ = false;
+  recentCount_ = 0;
+  recentHead_ = 0;
+}
+
+void ResponseMetrics::closeSegment() {
+  const float step = absValue(segmentTo_ - segmentFrom_);
+  if (step < 1.0f) return;  // Sem degrau (menos de um passo): só entra no IAE/ITAE
+
+  ++summary_.segments;
+
+  const float duration = lastTime_ - segmentStart_;
+  const float settling = lastOutsideBand_ - segmentStart_;
+  if (wasOutside_) ++summary_.unsettled;
+  if (settling > summary_.settlingTimeS) summary_.settlingTimeS = settling;
+
+  const float overshootPct = maxOvershoot_ * 100.0f / step;
+  if (overshootPct > summary_.overshootPct) summary_.overshootPct = overshootPct;
+
+  // |e| médio na parte final do segmento (limitado à janela guardada)
+  const float windowStart = lastTime_ - duration * kSteadyStateFraction;
+  float sum = 0.0f;
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < recentCount_; ++i) {
+    const uint32_t idx = (recentHead_ + kMaxRecent - 1 - i) % kMaxRecent;
+    if (recentTime_[idx] < windowStart) break;
+    sum += recentError_[idx];
+    ++count;
+  }
+  steadyStateSum_ += (count > 0) ? sum / count : 0.0f;
+}
+
+}  // namespace control
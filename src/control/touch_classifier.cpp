@@ -0,0 +1,42 @@
+#include "control/touch_classifier.h"
+
+namespace control {
+
+// ============================================================================
+// FUNÇÃO DE CLASSIFICAÇÃO DO TOQUE
+// ============================================================================
+//
+// Converte o valor bruto do sensor em uma zona discreta (0 a 3).
+// Esta é uma função de quantização: valor analógico → valor digital.
+//
+// Entrada: valor bruto do sensor capacitivo (0-100)
+// Saída: zona classificada (0=nenhum, 1=leve, 2=médio, 3=forte)
+//
+// Em controle digital, isso é chamado de ADC conceitual:
+// converte sinal contínuo em níveis discretos.
+// ============================================================================
+uint8_t classifyTouchZone(long touchValue) {
+  if (touchValue > kNoTouchThreshold) {
+    // Zona 0: SEM TOQUE - valor alto indica ausência de contato
+    return 0;
+  } else if (touchValue > kLightTouchThreshold) {
+    // Zona 1: TOQUE LEVE - valor moderado indica contato suave
+    return 1;
+  } else if (touchValue > kMediumTouchThreshold) {
+    // Zona 2: TOQUE MÉDIO - valor baixo indica contato moderado
+    return 2;
+  } else {
+    // Zona 3: TOQUE FORTE - valor muito baixo indica contato forte
+    return 3;
+  }
+}
+
+uint16_t touchIntensity(long touchValue) {
+  if (touchValue >= kNoTouchThreshold) return 0;
+  if (touchValue <= 0) return kTouchIntensityMax;
+  const uint32_t scaled =
+      (static_cast<uint32_t>(kNoTouchThreshold - touchValue) * kTouchIntensityScaleQ8) >> 8;
+  return static_cast<uint16_t>((scaled > kTouchIntensityMax) ? kTouchIntensityMax : scaled);
+}
+
+}  // namespace control
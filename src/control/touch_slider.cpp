@@ -0,0 +1,167 @@
+#include "control/touch_slider.h"
+
+#include "control/touch_classifier.h"
+
+namespace control {
+namespace {
+
+// Limite da velocidade estimada (64 pads/s): um intervalo de 1 µs entre
+// varreduras não pode estourar o estado em Q4
+constexpr int32_t kMaxSliderVelocity = 64 * kSliderPadPitch;
+
+// Suavização da velocidade: α = 1/4 por varredura
+constexpr uint8_t kVelocityShift = 2;
+
+// Maior intervalo aceito no dt da velocidade (varreduras perdidas)
+constexpr uint32_t kMaxScanGapPeriods = 8;
+
+int32_t absOf(int32_t value) { return (value < 0) ? -value : value; }
+
+}  // namespace
+
+SliderTracker::SliderTracker(uint8_t padCount, uint32_t scanPeriodUs)
+    : padCount_((padCount > kSliderMaxPads) ? kSliderMaxPads : padCount),
+      intensityScaleQ16_(0),
+      clock_(scanPeriodUs, kMaxScanGapPeriods * scanPeriodUs) {
+  const uint32_t span =
+      static_cast<uint32_t>((padCount_ > 1) ? (padCount_ - 1) * kSliderPadPitch : kSliderPadPitch);
+  intensityScaleQ16_ = ((static_cast<uint32_t>(kTouchIntensityMax - 1) << 16) + span / 2) / span;
+}
+
+SliderEvent SliderTracker::update(const uint16_t* raw, int64_t timestampUs, SliderReading& out) {
+  const uint32_t dtUs = clock_.sample(timestampUs);
+
+  // -------------------------------------------------------------------------
+  // ETAPA 1: LINHA DE BASE (a primeira varredura calibra; um toque que não
+  // solta em kSliderMaxTouchUs recalibra e conta como soltura)
+  // -------------------------------------------------------------------------
+  SliderEvent event = SliderEvent::None;
+  if (reading_.touched && timestampUs - pressUs_ >= kSliderMaxTouchUs) {
+    primed_ = false;
+    confirmScans_ = 0;
+    reading_.touched = false;
+    event = SliderEvent::Release;
+  }
+  if (!primed_) {
+    for (uint8_t i = 0; i < padCount_; ++i) baselineQ4_[i] = static_cast<int32_t>(raw[i]) << 4;
+    primed_ = true;
+  }
+
+  // -------------------------------------------------------------------------
+  // ETAPA 2: FORÇA POR PAD (queda relativa, Q8) E PAD DE PICO
+  // -------------------------------------------------------------------------
+  uint16_t strength[kSliderMaxPads];
+  uint8_t peak = 0;
+  for (uint8_t i = 0; i < padCount_; ++i) {
+    int32_t base = baselineQ4_[i] >> 4;
+    if ((static_cast<int32_t>(raw[i]) - base) * 256 >= base * kSliderPressStrength) {
+      // Bem acima da base: ela foi tomada com o dedo no pad
+      baselineQ4_[i] = static_cast<int32_t>(raw[i]) << 4;
+      base = raw[i];
+    }
+    const int32_t drop = base - static_cast<int32_t>(raw[i]);
+    int32_t value = (drop > 0 && base > 0) ? (drop << 8) / base : 0;
+    if (value > 256) value = 256;
+    strength[i] = static_cast<uint16_t>(value);
+    if (strength[i] > strength[peak]) peak = i;
+  }
+  const uint16_t peakStrength = strength[peak];
+
+  // -------------------------------------------------------------------------
+  // ETAPA 3: MÁQUINA DE TOQUE (histerese + confirmação)
+  // -------------------------------------------------------------------------
+  if (!reading_.touched) {
+    confirmScans_ = (peakStrength >= kSliderPressStrength) ? confirmScans_ + 1 : 0;
+    if (confirmScans_ >= kSliderPressScans) {
+      confirmScans_ = 0;
+      reading_.touched = true;
+      reading_.position = centroid(strength, peak);
+      reading_.velocity = 0;
+      pressPosition_ = reading_.position;
+      pressUs_ = timestampUs;
+      velocityQ4_ = 0;
+      event = SliderEvent::Press;
+    } else if (peakStrength < kSliderReleaseStrength) {
+      // Solto de fato: a linha de base segue a deriva lenta
+      for (uint8_t i = 0; i < padCount_; ++i) {
+        const int32_t rawQ4 = static_cast<int32_t>(raw[i]) << 4;
+        baselineQ4_[i] += (rawQ4 - baselineQ4_[i]) >> kSliderBaselineShift;
+      }
+    }
+  } else {
+    confirmScans_ = (peakStrength < kSliderReleaseStrength) ? confirmScans_ + 1 : 0;
+    if (confirmScans_ >= kSliderReleaseScans) {
+      // ETAPA 5: gesto — velocidade da última varredura firme, no sentido do percurso
+      confirmScans_ = 0;
+      reading_.touched = false;
+      const int32_t travel = reading_.position - pressPosition_;
+      const bool swipe = absOf(reading_.velocity) >= kSwipeMinVelocity &&
+                         absOf(travel) >= kSwipeMinTravel &&
+                         ((travel > 0) == (reading_.velocity > 0));
+      event = swipe ? SliderEvent::Swipe : SliderEvent::Release;
+    } else if (confirmScans_ == 0) {
+      // ETAPA 4: posição e velocidade só com o dedo firme (durante a
+      // confirmação da soltura o centroide de um dedo saindo é ruído)
+      const int32_t position = centroid(strength, peak);
+      int64_t velocity =
+          static_cast<int64_t>(position - reading_.position) * 1000000 / static_cast<int64_t>(dtUs);
+      if (velocity > kMaxSliderVelocity) velocity = kMaxSliderVelocity;
+      if (velocity < -kMaxSliderVelocity) velocity = -kMaxSliderVelocity;
+      velocityQ4_ += ((static_cast<int32_t>(velocity) << 4) - velocityQ4_) >> kVelocityShift;
+      if (position != reading_.position) event = SliderEvent::Move;
+      reading_.position = position;
+      reading_.velocity = velocityQ4_ / 16;
+    }
+  }
+
+  reading_.strength = peakStrength;
+  out = reading_;
+  if (event == SliderEvent::Swipe || event == SliderEvent::Release) {
+    reading_.velocity = 0;
+    velocityQ4_ = 0;
+  }
+  return event;
+}
+
+int32_t SliderTracker::centroid(const uint16_t* strength, uint8_t peak) const {
+  // Pad de pico e vizinhos: um dedo cobre no máximo dois ou três pads
+  const uint8_t first = (peak > 0) ? peak - 1 : 0;
+  const uint8_t last = (peak + 1 < padCount_) ? peak + 1 : padCount_ - 1;
+  int32_t weightSum = 0;
+  int32_t weightedSum = 0;
+  for (uint8_t i = first; i <= last; ++i) {
+    const int32_t weight =
+        (strength[i] > kSliderNoiseStrength) ? strength[i] - kSliderNoiseStrength : 0;
+    weightSum += weight;
+    weightedSum += weight * i * kSliderPadPitch;
+  }
+  if (weightSum == 0) return peak * kSliderPadPitch;
+  return (weightedSum + weightSum / 2) / weightSum;
+}
+
+uint16_t SliderTracker::positionIntensity(int32_t position) const {
+  if (position <= 0) return 1;
+  const uint32_t scaled =
+      1 + ((static_cast<uint32_t>(position) * intensityScaleQ16_ + (1u << 15)) >> 16);
+  return static_cast<uint16_t>((scaled > kTouchIntensityMax) ? kTouchIntensityMax : scaled);
+}
+
+uint16_t SliderTracker::swipeIntensity(int32_t velocity) {
+  const int32_t speed = absOf(velocity);
+  if (speed < kSwipeMinVelocity) return 0;
+  if (speed >= kSwipeFullVelocity) return kTouchIntensityMax;
+  return static_cast<uint16_t>(1 + (speed - kSwipeMinVelocity) * (kTouchIntensityMax - 1) /
+                                       (kSwipeFullVelocity - kSwipeMinVelocity));
+}
+
+void SliderTracker::reset() {
+  primed_ = false;
+  confirmScans_ = 0;
+  pressPosition_ = 0;
+  pressUs_ = 0;
+  velocityQ4_ = 0;
+  reading_ = SliderReading{0, 0, 0, false};
+  clock_.reset();
+}
+
+}  // namespace control
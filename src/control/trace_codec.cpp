@@ -0,0 +1,185 @@
+#include "control/trace_codec.h"
+
+#include <string.h>
+
+namespace control {
+namespace {
+
+constexpr uint8_t kInputTag = 0x10;
+constexpr uint8_t kOutputTag = 0x20;
+constexpr uint8_t kTagMask = 0xF0;
+
+// Nibble baixo da entrada: zona nos bits 0-1, sentido nos bits 2-3
+constexpr uint8_t kZoneMask = 0x03;
+constexpr uint8_t kDirectionShift = 2;
+
+uint8_t directionBits(int8_t direction) {
+  return static_cast<uint8_t>(((direction > 0) ? 1 : (direction < 0) ? 2 : 0) << kDirectionShift);
+}
+
+int8_t tagDirection(uint8_t tag) {
+  const uint8_t bits = (tag >> kDirectionShift) & 0x03;
+  return (bits == 1) ? 1 : (bits == 2) ? -1 : 0;
+}
+
+size_t putVarint(uint32_t value, uint8_t* out) {
+  size_t n = 0;
+  while (value >= 0x80) {
+    out[n++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  out[n++] = static_cast<uint8_t>(value);
+  return n;
+}
+
+// Zigzag: deltas pequenos com sinal viram varints curtos (0,-1,1,-2 → 0,1,2,3)
+uint32_t zigzag(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t unzigzag(uint32_t value) {
+  return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+uint32_t floatBits(float value) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float bitsToFloat(uint32_t bits) {
+  float value = 0.0f;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+int32_t wrappingDelta(int32_t now, int32_t before) {
+  return static_cast<int32_t>(static_cast<uint32_t>(now) - static_cast<uint32_t>(before));
+}
+
+bool sameRecord(const TraceRecord& a, const TraceRecord& b) {
+  if (a.kind != b.kind) return false;
+  if (a.kind == TraceRecordKind::Input) {
+    return a.input.tick == b.input.tick && a.input.touchValue == b.input.touchValue &&
+           a.input.touchZone == b.input.touchZone && a.input.intensity == b.input.intensity &&
+           a.input.direction == b.input.direction;
+  }
+  return a.output.steps == b.output.steps &&
+         floatBits(a.output.speedInStepsPerSec) == floatBits(b.output.speedInStepsPerSec);
+}
+
+}  // namespace
+
+size_t TraceEncoder::begin(uint8_t* out, uint32_t tickHz) {
+  lastInput_ = TraceInput{};
+  lastOutput_ = TraceOutput{};
+  out[0] = 'T';
+  out[1] = 'R';
+  out[2] = 'C';
+  out[3] = kTraceVersion;
+  for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<uint8_t>(tickHz >> (8 * i));
+  return kTraceHeaderBytes;
+}
+
+size_t TraceEncoder::write(const TraceRecord& record, uint8_t* out) {
+  size_t n = 0;
+  if (record.kind == TraceRecordKind::Input) {
+    const TraceInput& in = record.input;
+    out[n++] = static_cast<uint8_t>(kInputTag | directionBits(in.direction) | (in.touchZone & kZoneMask));
+    n += putVarint(in.tick - lastInput_.tick, out + n);
+    n += putVarint(zigzag(wrappingDelta(in.touchValue, lastInput_.touchValue)), out + n);
+    n += putVarint(zigzag(static_cast<int32_t>(in.intensity) - lastInput_.intensity), out + n);
+    lastInput_ = in;
+  } else {
+    const TraceOutput& o = record.output;
+    out[n++] = kOutputTag;
+    n += putVarint(zigzag(wrappingDelta(o.steps, lastOutput_.steps)), out + n);
+    n += putVarint(floatBits(o.speedInStepsPerSec) ^ floatBits(lastOutput_.speedInStepsPerSec),
+                   out + n);
+    lastOutput_ = o;
+  }
+  return n;
+}
+
+TraceDecoder::TraceDecoder(const uint8_t* data, size_t size) : data_(data), size_(size) {
+  if (size_ < kTraceHeaderBytes) return;
+  if (data_[0] != 'T' || data_[1] != 'R' || data_[2] != 'C' || data_[3] != kTraceVersion) return;
+  for (int i = 0; i < 4; ++i) tickHz_ |= static_cast<uint32_t>(data_[4 + i]) << (8 * i);
+  offset_ = kTraceHeaderBytes;
+  valid_ = true;
+}
+
+bool TraceDecoder::readVarint(uint32_t& value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (offset_ >= size_) return false;
+    const uint8_t byte = data_[offset_++];
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+bool TraceDecoder::next(TraceRecord& record) {
+  if (!valid_ || corrupted_ || offset_ >= size_) return false;
+  const size_t start = offset_;
+  const uint8_t tag = data_[offset_++];
+  uint32_t a = 0;
+  uint32_t b = 0;
+  uint32_t c = 0;
+
+  if ((tag & kTagMask) == kInputTag && readVarint(a) && readVarint(b) && readVarint(c)) {
+    record.kind = TraceRecordKind::Input;
+    record.input.tick = lastInput_.tick + a;
+    record.input.touchValue = static_cast<int32_t>(
+        static_cast<uint32_t>(lastInput_.touchValue) + static_cast<uint32_t>(unzigzag(b)));
+    record.input.touchZone = tag & kZoneMask;
+    record.input.direction = tagDirection(tag);
+    record.input.intensity = static_cast<uint16_t>(lastInput_.intensity + unzigzag(c));
+    lastInput_ = record.input;
+    return true;
+  }
+  if (tag == kOutputTag && readVarint(a) && readVarint(b)) {
+    record.kind = TraceRecordKind::Output;
+    record.output.steps = static_cast<int32_t>(static_cast<uint32_t>(lastOutput_.steps) +
+                                               static_cast<uint32_t>(unzigzag(a)));
+    record.output.speedInStepsPerSec =
+        bitsToFloat(floatBits(lastOutput_.speedInStepsPerSec) ^ b);
+    lastOutput_ = record.output;
+    return true;
+  }
+
+  offset_ = start;
+  corrupted_ = true;
+  return false;
+}
+
+TraceDiff diffTraces(const uint8_t* expected, size_t expectedSize, const uint8_t* actual,
+                     size_t actualSize) {
+  TraceDecoder want(expected, expectedSize);
+  TraceDecoder got(actual, actualSize);
+  TraceDiff diff = {false, 0, 0, 0, 0, 0};
+  if (!want.valid() || !got.valid() || want.tickHz() != got.tickHz()) return diff;
+
+  for (;;) {
+    diff.expectedOffset = want.offset();
+    diff.actualOffset = got.offset();
+    TraceRecord a;
+    TraceRecord b;
+    const bool hasA = want.next(a);
+    const bool hasB = got.next(b);
+    if (!hasA || !hasB) {
+      diff.identical = !hasA && !hasB && !want.corrupted() && !got.corrupted();
+      return diff;
+    }
+    if (!sameRecord(a, b)) return diff;
+    ++diff.records;
+    if (a.kind == TraceRecordKind::Input) {
+      ++diff.inputs;
+    } else {
+      ++diff.outputs;
+    }
+  }
+}
+
+}  // namespace control
@@ -0,0 +1,61 @@
+#include "control/trajectory.h"
+
+#include <math.h>
+
+namespace control {
+namespace {
+
+// Folga da saturação sobre a velocidade planejada (FeedforwardLoop)
+constexpr float kVelocityHeadroom = 1.25f;
+
+float minOf(float a, float b) { return (a < b) ? a : b; }
+
+}  // namespace
+
+void TrajectoryGenerator::reset(float position) {
+  sample_ = TrajectorySample{position, 0.0f, 0.0f};
+}
+
+const TrajectorySample& TrajectoryGenerator::update(int32_t targetSteps, float velocityLimit,
+                                                    float dt) {
+  const float error = static_cast<float>(targetSteps) - sample_.position;
+  const float distance = fabsf(error);
+
+  // Chegou: para exatamente no alvo (sem resíduo de ponto flutuante)
+  if (distance < 0.5f && fabsf(sample_.velocity) <= accelLimit_ * dt) {
+    sample_ = TrajectorySample{static_cast<float>(targetSteps), 0.0f, 0.0f};
+    return sample_;
+  }
+
+  // Velocidade desejada: limite, frenagem até o alvo e não passar dele nesta amostra
+  float desired = minOf(velocityLimit, sqrtf(2.0f * accelLimit_ * distance));
+  desired = minOf(desired, distance / dt);
+  if (error < 0.0f) desired = -desired;
+
+  // Aceleração limitada até a velocidade desejada
+  float accel = (desired - sample_.velocity) / dt;
+  if (accel > accelLimit_) accel = accelLimit_;
+  if (accel < -accelLimit_) accel = -accelLimit_;
+
+  // Integração trapezoidal: posição coerente com a velocidade planejada
+  const float velocity = sample_.velocity + accel * dt;
+  sample_.position += 0.5f * (sample_.velocity + velocity) * dt;
+  sample_.velocity = velocity;
+  sample_.acceleration = accel;
+  return sample_;
+}
+
+float FeedforwardLoop::update(const TrajectorySample& reference, float velocityLimit,
+                              int32_t measuredSteps) const {
+  const float error = reference.position - static_cast<float>(measuredSteps);
+  const float velocity = gains_.kvff * reference.velocity + gains_.kaff * reference.acceleration +
+                         gains_.kp * error;
+
+  const float planned = fabsf(reference.velocity);
+  const float limit = kVelocityHeadroom * ((planned > velocityLimit) ? planned : velocityLimit);
+  if (velocity > limit) return limit;
+  if (velocity < -limit) return -limit;
+  return velocity;
+}
+
+}  // namespace control
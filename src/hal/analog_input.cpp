@@ -0,0 +1,103 @@
+#include <Arduino.h>
+#include <driver/adc.h>
+
+#include "hal/analog_input.h"
+#include "hal/board.h"
+
+namespace hal {
+namespace {
+
+constexpr adc_channel_t kAnalogChannel = ADC_CHANNEL_0;  // GPIO36 (kAnalogInputPin)
+
+// Buffer circular do driver: ~200 ms de amostras a 20 kHz (2 bytes cada),
+// o dobro do período da malha externa que o esvazia
+constexpr uint32_t kStoreBufferBytes = 8192;
+
+// Conversões por quadro de DMA (uma interrupção do driver por quadro)
+constexpr uint32_t kConversionsPerFrame = 256;
+
+// Leitura em blocos pequenos: a pilha de quem chama não cresce com a taxa
+constexpr uint32_t kReadChunkBytes = 256;
+
+bool gAnalogReady = false;
+
+}  // namespace
+
+bool initAnalogInput() {
+  if (gAnalogReady) return true;
+
+  adc_digi_init_config_t init{};
+  init.max_store_buf_size = kStoreBufferBytes;
+  init.conv_num_each_intr = kConversionsPerFrame;
+  init.adc1_chan_mask = BIT(kAnalogChannel);
+  init.adc2_chan_mask = 0;
+  if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+  // Um único canal no padrão de varredura: 12 bits, atenuação de 11 dB (0..~3,1 V)
+  adc_digi_pattern_config_t pattern{};
+  pattern.atten = ADC_ATTEN_DB_11;
+  pattern.channel = kAnalogChannel;
+  pattern.unit = 0;  // ADC1
+  pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+  adc_digi_configuration_t config{};
+  config.conv_limit_en = true;  // Exigido pelo ESP32 (DMA via I2S0)
+  config.conv_limit_num = 250;
+  config.pattern_num = 1;
+  config.adc_pattern = &pattern;
+  config.sample_freq_hz = kAnalogSampleRateHz;
+  config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+  config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+  if (adc_digi_controller_configure(&config) != ESP_OK) {
+    adc_digi_deinitialize();
+    return false;
+  }
+
+  if (adc_digi_start() != ESP_OK) {
+    adc_digi_deinitialize();
+    return false;
+  }
+  gAnalogReady = true;
+  return true;
+}
+
+bool isAnalogInputReady() {
+  return gAnalogReady;
+}
+
+bool drainAnalogInput(AnalogBlock& block) {
+  block.samples = 0;
+  block.sum = 0;
+  block.min = 0xFFFF;
+  block.max = 0;
+  block.overrun = false;
+  block.timestampUs = nowUs();
+  if (!gAnalogReady) return false;
+
+  uint8_t buffer[kReadChunkBytes];
+  for (;;) {
+    uint32_t length = 0;
+    const esp_err_t err = adc_digi_read_bytes(buffer, sizeof(buffer), &length, 0);
+    // ESP_ERR_INVALID_STATE: o buffer do driver transbordou, mas os bytes lidos valem
+    if (err == ESP_ERR_INVALID_STATE) {
+      block.overrun = true;
+    } else if (err != ESP_OK) {
+      break;  // ESP_ERR_TIMEOUT: nada mais pendente
+    }
+
+    for (uint32_t i = 0; i + sizeof(adc_digi_output_data_t) <= length;
+         i += sizeof(adc_digi_output_data_t)) {
+      const adc_digi_output_data_t* out = reinterpret_cast<const adc_digi_output_data_t*>(&buffer[i]);
+      if (out->type1.channel != kAnalogChannel) continue;
+      const uint16_t raw = out->type1.data;
+      block.sum += raw;
+      if (raw < block.min) block.min = raw;
+      if (raw > block.max) block.max = raw;
+      ++block.samples;
+    }
+    if (length < sizeof(buffer)) break;
+  }
+  return block.samples > 0;
+}
+
+}  // namespace hal
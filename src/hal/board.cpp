@@ -18,13 +18,17 @@ void initBoard() {
   pinMode(kLimitBtn1Pin, INPUT_PULLDOWN);
   pinMode(kLimitBtn2Pin, INPUT_PULLDOWN);
 
-  // Inicializa pinos do driver TB6600 do motor de passo
-  pinMode(kStepperPulsePin, OUTPUT);
-  pinMode(kStepperDirectionPin, OUTPUT);
-  pinMode(kStepperEnablePin, OUTPUT);
-  digitalWrite(kStepperPulsePin, LOW);
-  digitalWrite(kStepperDirectionPin, LOW);
-  digitalWrite(kStepperEnablePin, HIGH);  // Motor desabilitado inicialmente (HIGH = disabled)
+  // Inicializa pinos dos drivers TB6600 de todos os eixos
+  for (const StepperAxisPins& axis : kStepperAxes) {
+    pinMode(axis.pulsePin, OUTPUT);
+    pinMode(axis.directionPin, OUTPUT);
+    pinMode(axis.enablePin, OUTPUT);
+    digitalWrite(axis.pulsePin, LOW);
+    digitalWrite(axis.directionPin, LOW);
+    digitalWrite(axis.enablePin, HIGH);  // Motor desabilitado inicialmente (HIGH = disabled)
+    if (axis.limitMinPin != kNoPin) pinMode(axis.limitMinPin, INPUT_PULLDOWN);
+    if (axis.limitMaxPin != kNoPin) pinMode(axis.limitMaxPin, INPUT_PULLDOWN);
+  }
 }
 
 void setBuiltinLed(bool enabled) {
@@ -0,0 +1,132 @@
+#include <Arduino.h>
+#include <driver/pcnt.h>
+
+#include "hal/board.h"
+#include "hal/encoder.h"
+
+namespace hal {
+namespace {
+
+constexpr pcnt_unit_t kEncoderUnit = PCNT_UNIT_0;
+
+// O contador de hardware volta a 0 ao atingir um dos limites; o ISR
+// acumula o limite em 64 bits.
+constexpr int16_t kCounterLimit = 32000;
+
+// Filtro de glitch em ciclos de APB (80 MHz): ignora pulsos < ~1,25 us
+constexpr uint16_t kGlitchFilterCycles = 100;
+
+volatile int64_t gOverflowCount = 0;
+int64_t gLastCount = 0;  // Última leitura devolvida (detecção do salto de estouro)
+portMUX_TYPE gEncoderMux = portMUX_INITIALIZER_UNLOCKED;
+bool gEncoderReady = false;
+
+void IRAM_ATTR onCounterLimit(void* /*arg*/) {
+  uint32_t status = 0;
+  pcnt_get_event_status(kEncoderUnit, &status);
+  portENTER_CRITICAL_ISR(&gEncoderMux);
+  if (status & PCNT_EVT_H_LIM) {
+    gOverflowCount = gOverflowCount + kCounterLimit;
+  } else if (status & PCNT_EVT_L_LIM) {
+    gOverflowCount = gOverflowCount - kCounterLimit;
+  }
+  portEXIT_CRITICAL_ISR(&gEncoderMux);
+}
+
+int64_t readOverflow() {
+  portENTER_CRITICAL(&gEncoderMux);
+  const int64_t value = gOverflowCount;
+  portEXIT_CRITICAL(&gEncoderMux);
+  return value;
+}
+
+// Configura um canal do PCNT para decodificação x4 (A/B em quadratura)
+void configureChannel(pcnt_channel_t channel, uint8_t pulsePin, uint8_t ctrlPin,
+                      pcnt_count_mode_t posMode, pcnt_count_mode_t negMode) {
+  pcnt_config_t cfg{};
+  cfg.pulse_gpio_num = pulsePin;
+  cfg.ctrl_gpio_num = ctrlPin;
+  cfg.lctrl_mode = PCNT_MODE_REVERSE;
+  cfg.hctrl_mode = PCNT_MODE_KEEP;
+  cfg.pos_mode = posMode;
+  cfg.neg_mode = negMode;
+  cfg.counter_h_lim = kCounterLimit;
+  cfg.counter_l_lim = -kCounterLimit;
+  cfg.unit = kEncoderUnit;
+  cfg.channel = channel;
+  pcnt_unit_config(&cfg);
+}
+
+}  // namespace
+
+bool initEncoder() {
+  if (!kHasEncoder) return false;
+  if (gEncoderReady) return true;
+
+  // Canal 0 conta bordas de A (direção por B); canal 1 conta bordas de B (direção por A)
+  configureChannel(PCNT_CHANNEL_0, kEncoderAPin, kEncoderBPin, PCNT_COUNT_DEC, PCNT_COUNT_INC);
+  configureChannel(PCNT_CHANNEL_1, kEncoderBPin, kEncoderAPin, PCNT_COUNT_INC, PCNT_COUNT_DEC);
+
+  pcnt_set_filter_value(kEncoderUnit, kGlitchFilterCycles);
+  pcnt_filter_enable(kEncoderUnit);
+
+  // Interrupção apenas nos limites do contador (extensão para 64 bits)
+  pcnt_event_enable(kEncoderUnit, PCNT_EVT_H_LIM);
+  pcnt_event_enable(kEncoderUnit, PCNT_EVT_L_LIM);
+
+  pcnt_counter_pause(kEncoderUnit);
+  pcnt_counter_clear(kEncoderUnit);
+
+  if (pcnt_isr_service_install(0) != ESP_OK) return false;
+  if (pcnt_isr_handler_add(kEncoderUnit, onCounterLimit, nullptr) != ESP_OK) return false;
+
+  pcnt_intr_enable(kEncoderUnit);
+  pcnt_counter_resume(kEncoderUnit);
+
+  gEncoderReady = true;
+  return true;
+}
+
+bool isEncoderReady() {
+  return gEncoderReady;
+}
+
+int64_t readEncoderCount() {
+  if (!gEncoderReady) return 0;
+
+  // Relê se um estouro foi contabilizado entre as duas leituras
+  int64_t base = 0;
+  int16_t count = 0;
+  do {
+    base = readOverflow();
+    pcnt_get_counter_value(kEncoderUnit, &count);
+  } while (base != readOverflow());
+  int64_t value = base + count;
+
+  // O hardware zera o contador no limite antes de o ISR somar o estouro:
+  // uma leitura nessa janela sai deslocada de ±kCounterLimit. O eixo não
+  // anda meio limite entre duas leituras (a 20 kHz de passo são ~150
+  // contagens a cada 10 ms de supervisão), então um salto desse tamanho é
+  // o estouro pendente e é compensado.
+  portENTER_CRITICAL(&gEncoderMux);
+  const int64_t jump = value - gLastCount;
+  if (jump > kCounterLimit / 2) {
+    value -= kCounterLimit;
+  } else if (jump < -kCounterLimit / 2) {
+    value += kCounterLimit;
+  }
+  gLastCount = value;
+  portEXIT_CRITICAL(&gEncoderMux);
+  return value;
+}
+
+void resetEncoderCount(int64_t value) {
+  if (!gEncoderReady) return;
+  portENTER_CRITICAL(&gEncoderMux);
+  pcnt_counter_clear(kEncoderUnit);
+  gOverflowCount = value;
+  gLastCount = value;
+  portEXIT_CRITICAL(&gEncoderMux);
+}
+
+}  // namespace hal
@@ -0,0 +1,186 @@
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include <atomic>
+
+#include "hal/board.h"
+#include "hal/clock.h"
+#include "hal/input_events.h"
+
+namespace hal {
+namespace {
+
+// Queue de eventos debounced (press/release/long-press)
+constexpr size_t kInputEventQueueLength = 16;
+
+// Timer com prescaler 80 -> 1 tick = 1 us (APB = 80 MHz)
+constexpr uint16_t kTimerDivider = 80;
+
+struct InputChannel {
+  uint8_t pin;
+  bool activeLow;              // true = botão com pull-up (ativo em LOW)
+  bool longPressEnabled;       // Long-press apenas para botões de usuário
+  volatile bool stable;        // Nível debounced (true = ativo)
+  volatile bool pending;       // Borda vista, aguardando janela de debounce
+  volatile bool longPressSent; // Long-press já emitido para o press atual
+  volatile int64_t edgeUs;     // Primeira borda do bounce atual
+  volatile int64_t lastEdgeUs; // Borda mais recente (reinicia a janela)
+  volatile int64_t pressUs;    // Instante do press debounced
+};
+
+InputChannel gInputs[] = {
+    {kUserBtn1Pin, true, true, false, false, false, 0, 0, 0},
+    {kUserBtn2Pin, true, true, false, false, false, 0, 0, 0},
+    {kUserBtn3Pin, true, true, false, false, false, 0, 0, 0},
+    {kLimitBtn1Pin, false, false, false, false, false, 0, 0, 0},
+    {kLimitBtn2Pin, false, false, false, false, false, 0, 0, 0},
+};
+
+static_assert(sizeof(gInputs) / sizeof(gInputs[0]) == static_cast<size_t>(InputId::Count),
+              "gInputs must have one entry per InputId");
+
+QueueHandle_t xInputEventQueue = nullptr;
+std::atomic<uint32_t> gPostedEvents{0};
+std::atomic<uint32_t> gDroppedEvents{0};  // Fila cheia (ninguém consumindo a tempo)
+hw_timer_t* gDebounceTimer = nullptr;
+portMUX_TYPE gInputMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Prazo atualmente programado no timer (0 = timer ocioso)
+volatile int64_t gTimerDeadlineUs = 0;
+
+inline bool IRAM_ATTR readLevel(const InputChannel& in) {
+  return (digitalRead(in.pin) == HIGH) != in.activeLow;
+}
+
+// Programa o alarme one-shot do timer compartilhado para deadlineUs.
+// Só antecipa o prazo: um alarme mais cedo já programado é mantido.
+void IRAM_ATTR armTimerLocked(int64_t nowUs, int64_t deadlineUs) {
+  if (gTimerDeadlineUs != 0 && gTimerDeadlineUs <= deadlineUs) return;
+  int64_t delta = deadlineUs - nowUs;
+  if (delta < 1) delta = 1;
+  gTimerDeadlineUs = deadlineUs;
+  timerWrite(gDebounceTimer, 0);
+  timerAlarmWrite(gDebounceTimer, static_cast<uint64_t>(delta), false);
+  timerAlarmEnable(gDebounceTimer);
+}
+
+void IRAM_ATTR postEvent(InputId id, InputEventType type, int64_t timestampUs,
+                         BaseType_t* woken) {
+  InputEvent evt{id, type, timestampUs};
+  if (xQueueSendFromISR(xInputEventQueue, &evt, woken) == pdTRUE) {
+    gPostedEvents.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    gDroppedEvents.fetch_add(1, std::memory_order_relaxed);  // Fila cheia: evento descartado
+  }
+}
+
+// ISR de borda: apenas registra o instante e agenda a verificação.
+// Cada borda durante o bounce reinicia a janela de estabilidade.
+void IRAM_ATTR onInputEdge(void* arg) {
+  InputChannel& in = *static_cast<InputChannel*>(arg);
+  const int64_t now = nowUs();
+  portENTER_CRITICAL_ISR(&gInputMux);
+  if (!in.pending) {
+    in.pending = true;
+    in.edgeUs = now;
+  }
+  in.lastEdgeUs = now;
+  armTimerLocked(now, now + kInputDebounceUs);
+  portEXIT_CRITICAL_ISR(&gInputMux);
+}
+
+// ISR do timer compartilhado: confirma bordas, detecta long-press e
+// reprograma o próximo prazo (se houver).
+void IRAM_ATTR onDebounceTimer() {
+  const int64_t now = nowUs();
+  BaseType_t woken = pdFALSE;
+  int64_t nextDeadline = 0;
+
+  portENTER_CRITICAL_ISR(&gInputMux);
+  gTimerDeadlineUs = 0;
+
+  for (size_t i = 0; i < static_cast<size_t>(InputId::Count); ++i) {
+    InputChannel& in = gInputs[i];
+    const InputId id = static_cast<InputId>(i);
+
+    if (in.pending) {
+      // Nível estável desde a última borda por uma janela inteira
+      const int64_t due = in.lastEdgeUs + kInputDebounceUs;
+      if (now >= due) {
+        in.pending = false;
+        const bool level = readLevel(in);
+        if (level != in.stable) {
+          in.stable = level;
+          postEvent(id, level ? InputEventType::Press : InputEventType::Release, in.edgeUs,
+                    &woken);
+          if (level) {
+            in.pressUs = in.edgeUs;
+            in.longPressSent = false;
+          }
+        }
+      } else if (nextDeadline == 0 || due < nextDeadline) {
+        nextDeadline = due;
+      }
+    }
+
+    if (in.longPressEnabled && in.stable && !in.longPressSent) {
+      const int64_t due = in.pressUs + kInputLongPressUs;
+      if (now >= due) {
+        in.longPressSent = true;
+        postEvent(id, InputEventType::LongPress, now, &woken);
+      } else if (nextDeadline == 0 || due < nextDeadline) {
+        nextDeadline = due;
+      }
+    }
+  }
+
+  if (nextDeadline != 0) {
+    armTimerLocked(now, nextDeadline);
+  }
+  portEXIT_CRITICAL_ISR(&gInputMux);
+
+  if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+}  // namespace
+
+bool initInputEvents() {
+  if (xInputEventQueue != nullptr) return true;
+
+  xInputEventQueue = xQueueCreate(kInputEventQueueLength, sizeof(InputEvent));
+  if (xInputEventQueue == nullptr) return false;
+
+  gDebounceTimer = timerBegin(kInputDebounceTimer, kTimerDivider, true);
+  if (gDebounceTimer == nullptr) return false;
+  timerAttachInterrupt(gDebounceTimer, onDebounceTimer, true);
+
+  // Nível inicial debounced = nível atual (sem gerar eventos no boot)
+  for (InputChannel& in : gInputs) {
+    in.stable = readLevel(in);
+    in.longPressSent = true;
+    attachInterruptArg(in.pin, onInputEdge, &in, CHANGE);
+  }
+  return true;
+}
+
+bool receiveInputEvent(InputEvent& evt, TickType_t ticksToWait) {
+  if (xInputEventQueue == nullptr) return false;
+  return xQueueReceive(xInputEventQueue, &evt, ticksToWait) == pdTRUE;
+}
+
+bool isInputActive(InputId id) {
+  if (id >= InputId::Count) return false;
+  return gInputs[static_cast<size_t>(id)].stable;
+}
+
+InputEventStats getInputEventStats() {
+  InputEventStats stats;
+  stats.capacity = kInputEventQueueLength;
+  stats.depth = (xInputEventQueue != nullptr) ? uxQueueMessagesWaiting(xInputEventQueue) : 0;
+  stats.posted = gPostedEvents.load(std::memory_order_relaxed);
+  stats.dropped = gDroppedEvents.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace hal
@@ -0,0 +1,100 @@
+#include <Arduino.h>
+#include <driver/touch_pad.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include "hal/touch_slider.h"
+
+namespace hal {
+namespace {
+
+// Tempo de medição por pad: 2048 ciclos de 8 MHz = 256 µs. Intervalo entre
+// varreduras do FSM: 256 ciclos de 150 kHz ≈ 1,7 ms. Cinco pads → uma
+// varredura completa a cada ~3 ms (~330 Hz), mais rápida que a leitura
+constexpr uint16_t kMeasureCycles = 2048;
+constexpr uint16_t kSleepCycles = 256;
+
+// Fila de varreduras: ~250 ms a 250 Hz, mais que o período da malha
+// externa que a esvazia
+constexpr size_t kScanQueueLength = 64;
+
+static_assert(kTouchSliderPadCount >= 2, "Slider precisa de ao menos dois pads");
+static_assert(kTouchSliderScanHz > 0 && kTouchSliderScanHz <= 1000,
+              "Leitura do slider entre 1 e 1000 Hz");
+
+QueueHandle_t gScanQueue = nullptr;
+esp_timer_handle_t gScanTimer = nullptr;
+volatile uint32_t gOverruns = 0;
+bool gSliderReady = false;
+
+// Callback do esp_timer (task do esp_timer): só leituras de registrador,
+// nenhuma espera por medição
+void scanTouchSlider(void* /*arg*/) {
+  TouchSliderScan scan;
+  scan.timestampUs = nowUs();
+  for (uint8_t i = 0; i < kTouchSliderPadCount; ++i) {
+    uint16_t value = 0;
+    touch_pad_read_raw_data(static_cast<touch_pad_t>(kTouchSliderPads[i]), &value);
+    scan.raw[i] = value;
+  }
+  if (xQueueSend(gScanQueue, &scan, 0) != pdTRUE) gOverruns = gOverruns + 1;
+}
+
+}  // namespace
+
+bool initTouchSlider() {
+  if (gSliderReady) return true;
+
+  if (gScanQueue == nullptr) {
+    gScanQueue = xQueueCreate(kScanQueueLength, sizeof(TouchSliderScan));
+    if (gScanQueue == nullptr) return false;
+  }
+
+  // ETAPA 1: periférico e pads (limiar 0: sem interrupção de toque)
+  if (touch_pad_init() != ESP_OK) return false;
+  touch_pad_set_voltage(TOUCH_HVOLT_2V7, TOUCH_LVOLT_0V5, TOUCH_HVOLT_ATTEN_1V);
+  for (uint8_t i = 0; i < kTouchSliderPadCount; ++i) {
+    if (touch_pad_config(static_cast<touch_pad_t>(kTouchSliderPads[i]), 0) != ESP_OK) {
+      touch_pad_deinit();
+      return false;
+    }
+  }
+
+  // ETAPA 2: FSM por timer — o hardware mede todos os pads sozinho
+  touch_pad_set_meas_time(kSleepCycles, kMeasureCycles);
+  touch_pad_set_fsm_mode(TOUCH_FSM_MODE_TIMER);
+
+  // ETAPA 3: leitura periódica dos resultados
+  esp_timer_create_args_t args{};
+  args.callback = scanTouchSlider;
+  args.name = "touch_slider";
+  if (esp_timer_create(&args, &gScanTimer) != ESP_OK) {
+    touch_pad_deinit();
+    return false;
+  }
+  if (esp_timer_start_periodic(gScanTimer, kMicrosPerSecond / kTouchSliderScanHz) != ESP_OK) {
+    esp_timer_delete(gScanTimer);
+    gScanTimer = nullptr;
+    touch_pad_deinit();
+    return false;
+  }
+  gOverruns = 0;
+  gSliderReady = true;
+  return true;
+}
+
+bool isTouchSliderReady() {
+  return gSliderReady;
+}
+
+bool readTouchSliderScan(TouchSliderScan& scan) {
+  if (!gSliderReady) return false;
+  return xQueueReceive(gScanQueue, &scan, 0) == pdTRUE;
+}
+
+uint32_t getTouchSliderOverruns() {
+  return gOverruns;
+}
+
+}  // namespace hal
@@ -0,0 +1,145 @@
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <string.h>
+
+#include "hal/warm_state.h"
+
+namespace hal {
+namespace {
+
+constexpr uint32_t kWarmStateMagic = 0x57524D31;  // "WRM1"
+// 2: marca de movimento; 3: aceleração do modo velocidade e tabela de ganhos
+constexpr uint16_t kWarmStateVersion = 3;
+
+struct WarmRecord {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  WarmState state;
+  uint32_t crc;
+};
+
+// Não inicializada pelo bootloader: mantém o conteúdo em resets "quentes"
+RTC_NOINIT_ATTR WarmRecord gWarmRecord;
+
+portMUX_TYPE gWarmMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Registro como estava no boot (decidido na primeira chamada de restoreWarmState)
+bool gBootChecked = false;
+bool gBootValid = false;
+WarmState gBootState = {};
+
+// CRC-32 (polinômio refletido 0xEDB88320), bit a bit - registro tem ~30 bytes
+uint32_t crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < length; ++i) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+uint32_t recordCrc(const WarmRecord& record) {
+  return crc32(reinterpret_cast<const uint8_t*>(&record), offsetof(WarmRecord, crc));
+}
+
+// Apenas resets em que a RAM RTC e a posição física continuam confiáveis
+bool isWarmReset(esp_reset_reason_t reason) {
+  switch (reason) {
+    case ESP_RST_SW:
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+      return true;
+    default:
+      return false;  // Power-on, brown-out, deep sleep, reset externo
+  }
+}
+
+// Recalcula o CRC após alterar campos (chamar com gWarmMux travado)
+void sealLocked() {
+  gWarmRecord.magic = kWarmStateMagic;
+  gWarmRecord.version = kWarmStateVersion;
+  gWarmRecord.size = sizeof(WarmRecord);
+  gWarmRecord.crc = recordCrc(gWarmRecord);
+}
+
+}  // namespace
+
+bool restoreWarmState(WarmState& state) {
+  portENTER_CRITICAL(&gWarmMux);
+  if (!gBootChecked) {
+    gBootValid = isWarmReset(esp_reset_reason()) && gWarmRecord.magic == kWarmStateMagic &&
+                 gWarmRecord.version == kWarmStateVersion &&
+                 gWarmRecord.size == sizeof(WarmRecord) && gWarmRecord.crc == recordCrc(gWarmRecord);
+    if (!gBootValid) {
+      memset(&gWarmRecord, 0, sizeof(gWarmRecord));  // Partida a frio: registro novo
+      sealLocked();
+    }
+    gBootState = gWarmRecord.state;
+    gBootChecked = true;
+  }
+  state = gBootState;  // Chamadas seguintes não zeram o que já foi gravado
+  const bool valid = gBootValid;
+  portEXIT_CRITICAL(&gWarmMux);
+  return valid;
+}
+
+void storeWarmAxisPositions(const int32_t* positions, uint8_t axisCount) {
+  if (axisCount > kWarmStateMaxAxes) axisCount = kWarmStateMaxAxes;
+  portENTER_CRITICAL(&gWarmMux);
+  memcpy(gWarmRecord.state.axisPositions, positions, axisCount * sizeof(int32_t));
+  gWarmRecord.state.axisCount = axisCount;
+  sealLocked();
+  portEXIT_CRITICAL(&gWarmMux);
+}
+
+void storeWarmMoving() {
+  portENTER_CRITICAL(&gWarmMux);
+  gWarmRecord.state.moving = 1;
+  sealLocked();
+  portEXIT_CRITICAL(&gWarmMux);
+}
+
+void storeWarmAtRest(const int32_t* positions, uint8_t axisCount) {
+  if (axisCount > kWarmStateMaxAxes) axisCount = kWarmStateMaxAxes;
+  portENTER_CRITICAL(&gWarmMux);
+  memcpy(gWarmRecord.state.axisPositions, positions, axisCount * sizeof(int32_t));
+  gWarmRecord.state.axisCount = axisCount;
+  gWarmRecord.state.moving = 0;
+  sealLocked();
+  portEXIT_CRITICAL(&gWarmMux);
+}
+
+void storeWarmFault(uint8_t fault) {
+  portENTER_CRITICAL(&gWarmMux);
+  gWarmRecord.state.fault = fault;
+  sealLocked();
+  portEXIT_CRITICAL(&gWarmMux);
+}
+
+void storeWarmVelocityAccel(float accel) {
+  portENTER_CRITICAL(&gWarmMux);
+  gWarmRecord.state.velocityAccel = accel;
+  sealLocked();
+  portEXIT_CRITICAL(&gWarmMux);
+}
+
+void storeWarmGainSchedule(uint8_t schedule) {
+  portENTER_CRITICAL(&gWarmMux);
+  gWarmRecord.state.gainSchedule = schedule;
+  sealLocked();
+  portEXIT_CRITICAL(&gWarmMux);
+}
+
+void invalidateWarmState() {
+  portENTER_CRITICAL(&gWarmMux);
+  gWarmRecord.magic = 0;
+  portEXIT_CRITICAL(&gWarmMux);
+}
+
+}  // namespace hal
@@ -2,31 +2,38 @@
 #include <freertos/FreeRTOS.h>
 
 #include "hal/board.h"
+#include "hal/input_events.h"
 #include "tasks/blink_task.h"
 #include "tasks/display_task.h"
-#include "tasks/touch_task.h"
-#include "tasks/control_task.h"
+#include "tasks/sensor_pipeline.h"
 #include "tasks/stepper_task.h"
 #include "tasks/stepper_command_task.h"
+#include "tasks/system_events.h"
 
 // Application entry point: configure hardware and spawn the initial tasks.
+// Subsystems initialise in parallel inside their own tasks and report
+// completion through the system event group (tasks/system_events.h).
 void setup() {
+  tasks::initSystemEvents();
   hal::initBoard();
+  hal::initInputEvents();  // Botões e fim de curso via interrupção + debounce por timer
 
   const UBaseType_t blinkPriority = tskIDLE_PRIORITY + 1;    // Low priority task.
   const UBaseType_t displayPriority = tskIDLE_PRIORITY + 1;  // Low priority task.
   const UBaseType_t touchPriority = tskIDLE_PRIORITY + 1;    // Low priority - sensor input.
   const UBaseType_t controlPriority = tskIDLE_PRIORITY + 2;  // Medium priority - control algorithm.
   const UBaseType_t stepperPriority = tskIDLE_PRIORITY + 3;  // High priority - actuator output.
+  const UBaseType_t innerLoopPriority = tskIDLE_PRIORITY + 4;  // Highest - fast inner control loop.
   const UBaseType_t stepperCommandPriority = tskIDLE_PRIORITY + 1;  // Baixa prioridade - envia comandos.
 
-  // Start display first so it initializes the LCD and the message queue.
+  // Start order does not matter: dependants wait on the ready bits.
   // tasks::startDisplayTask(displayPriority);
   tasks::startBlinkTask(blinkPriority);
   
-  // Sistema de controle digital: Sensor → Controlador → Atuador
-  // tasks::startTouchTask(touchPriority);      // ENTRADA: lê sensor capacitivo
-  // tasks::startControlTask(csontrolPriority);  // PROCESSAMENTO: implementa função de transferência
+  // Sistema de controle digital: Sensor → Controlador → Atuador.
+  // Os estágios e a task de cada um são definidos por tipo em
+  // tasks/sensor_pipeline.h; só as tasks usadas são criadas.
+  // tasks::startSensorPipeline(touchPriority, controlPriority, innerLoopPriority);
   tasks::startStepperTask(stepperPriority);  // SAÍDA: controla motor de passo
   tasks::startStepperCommandTask(stepperCommandPriority);  // Gera comandos periódicos
 }
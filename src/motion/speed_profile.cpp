@@ -0,0 +1,91 @@
+#include "motion/speed_profile.h"
+
+namespace motion {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Band skipping, checked at compile time (host and target builds)
+// ---------------------------------------------------------------------------
+constexpr ResonanceBand kCheckBands[] = {{100, 200}, {300, 400}, {400, 500}};
+constexpr size_t kCheckBandCount = sizeof(kCheckBands) / sizeof(kCheckBands[0]);
+
+static_assert(resonanceBandsValid(kCheckBands, kCheckBandCount), "adjacent bands are valid");
+static_assert(resonanceBandsValid(kCheckBands + 1, 1), "single band is valid");
+
+// Outside every band, and on the edges: unchanged
+static_assert(skipResonanceBands(50, kCheckBands, kCheckBandCount, 1, 10000) == 50, "below");
+static_assert(skipResonanceBands(100, kCheckBands, kCheckBandCount, 1, 10000) == 100, "low edge");
+static_assert(skipResonanceBands(200, kCheckBands, kCheckBandCount, 1, 10000) == 200, "high edge");
+static_assert(skipResonanceBands(250, kCheckBands, kCheckBandCount, 1, 10000) == 250, "between");
+static_assert(skipResonanceBands(400, kCheckBands, kCheckBandCount, 1, 10000) == 400,
+              "shared edge of adjacent bands");
+
+// Inside: nearest edge, ties go down
+static_assert(skipResonanceBands(120, kCheckBands, kCheckBandCount, 1, 10000) == 100, "near low");
+static_assert(skipResonanceBands(180, kCheckBands, kCheckBandCount, 1, 10000) == 200, "near high");
+static_assert(skipResonanceBands(150, kCheckBands, kCheckBandCount, 1, 10000) == 100, "tie");
+static_assert(skipResonanceBands(460, kCheckBands, kCheckBandCount, 1, 10000) == 500, "last band");
+
+// Upper edge above the ceiling: always down
+static_assert(skipResonanceBands(480, kCheckBands, kCheckBandCount, 1, 450) == 400, "ceiling");
+
+// Bands are in full steps/s: with 8 microsteps they move up 8x
+static_assert(skipResonanceBands(120, kCheckBands, kCheckBandCount, 8, 100000) == 120,
+              "below the scaled bands");
+static_assert(skipResonanceBands(1000, kCheckBands, kCheckBandCount, 8, 100000) == 800,
+              "scaled band, near low");
+static_assert(skipResonanceBands(1500, kCheckBands, kCheckBandCount, 8, 100000) == 1600,
+              "scaled band, near high");
+
+// Unsorted or overlapping tables are rejected
+constexpr ResonanceBand kOverlapping[] = {{100, 300}, {200, 400}};
+constexpr ResonanceBand kEmpty[] = {{100, 100}};
+static_assert(!resonanceBandsValid(kOverlapping, 2), "overlap");
+static_assert(!resonanceBandsValid(kEmpty, 1), "empty band");
+
+}  // namespace
+
+SpeedPlanner::SpeedPlanner(const SpeedProfileConfig& config) : config_(config) {
+  if (config_.microsteps < 1) config_.microsteps = 1;
+  if (config_.bandCount > kMaxVelocityBands) config_.bandCount = kMaxVelocityBands;
+}
+
+uint32_t SpeedPlanner::skipBands(uint32_t stepsPerSec) const {
+  return skipResonanceBands(stepsPerSec, config_.bands, config_.bandCount, config_.microsteps,
+                            config_.maxStepsPerSec);
+}
+
+float SpeedPlanner::planCruise(float stepsPerSec) const {
+  const bool negative = stepsPerSec < 0.0f;
+  float magnitude = negative ? -stepsPerSec : stepsPerSec;
+  const float ceiling = static_cast<float>(config_.maxStepsPerSec);
+  if (magnitude > ceiling) magnitude = ceiling;
+
+  // Whole steps/s are plenty of resolution for a cruise speed. A fraction
+  // between an edge and the next whole step is still inside the band, so a
+  // clear rounded speed is kept only when the other neighbouring whole step
+  // is clear too (one lookup for whole speeds, two at most).
+  const uint32_t rounded = static_cast<uint32_t>(magnitude + 0.5f);
+  const uint32_t planned = skipBands(rounded);
+  const uint32_t below = static_cast<uint32_t>(magnitude);
+  const uint32_t other = (below != rounded) ? below
+                         : (static_cast<float>(below) < magnitude) ? below + 1
+                                                                   : below;
+  const bool clear = planned == rounded && (other == rounded || skipBands(other) == other);
+  const float result = clear ? magnitude : static_cast<float>(planned);
+  return negative ? -result : result;
+}
+
+void SpeedPlanner::applyTo(StepGenerator& generator, uint32_t tickHz) const {
+  VelocityBand bands[kMaxVelocityBands] = {};
+  const float microsteps = static_cast<float>(config_.microsteps);
+  for (uint8_t i = 0; i < config_.bandCount; ++i) {
+    bands[i].lowQ32 =
+        stepsPerSecToQ32(static_cast<float>(config_.bands[i].lowFullStepsPerSec) * microsteps, tickHz);
+    bands[i].highQ32 = stepsPerSecToQ32(
+        static_cast<float>(config_.bands[i].highFullStepsPerSec) * microsteps, tickHz);
+  }
+  generator.setVelocityBands(bands, config_.bandCount, config_.bandAccelShift);
+}
+
+}  // namespace motion
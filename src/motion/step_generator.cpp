@@ -0,0 +1,143 @@
+#include "motion/step_generator.h"
+
+namespace motion {
+namespace {
+
+constexpr float kQ32 = 4294967296.0f;  // 2^32
+
+uint32_t toQ32(float stepsPerTick, uint32_t ceiling) {
+  if (stepsPerTick <= 0.0f) return 0;
+  const float scaled = stepsPerTick * kQ32;
+  if (scaled >= static_cast<float>(ceiling)) return ceiling;
+  return static_cast<uint32_t>(scaled);
+}
+
+}  // namespace
+
+uint32_t stepsPerSecToQ32(float stepsPerSec, uint32_t tickHz) {
+  return toQ32(stepsPerSec / static_cast<float>(tickHz), kMaxVelocityQ32);
+}
+
+int32_t signedStepsPerSecToQ32(float stepsPerSec, uint32_t tickHz) {
+  const uint32_t magnitude = stepsPerSecToQ32(stepsPerSec < 0.0f ? -stepsPerSec : stepsPerSec, tickHz);
+  return (stepsPerSec < 0.0f) ? -static_cast<int32_t>(magnitude) : static_cast<int32_t>(magnitude);
+}
+
+uint32_t stepsPerSecSecToQ32(float stepsPerSecSec, uint32_t tickHz) {
+  const float hz = static_cast<float>(tickHz);
+  const uint32_t q = toQ32(stepsPerSecSec / (hz * hz), kMaxVelocityQ32);
+  return (q == 0 && stepsPerSecSec > 0.0f) ? 1 : q;  // Keeps tiny ramps moving
+}
+
+void StepGenerator::configure(uint8_t axisCount) {
+  if (axisCount == 0) axisCount = 1;
+  if (axisCount > kMaxAxes) axisCount = kMaxAxes;
+  axisCount_ = axisCount;
+}
+
+void StepGenerator::setVelocityBands(const VelocityBand* bands, uint8_t count, uint8_t accelShift) {
+  if (count > kMaxVelocityBands) count = kMaxVelocityBands;
+  for (uint8_t i = 0; i < count; ++i) {
+    bands_[i] = bands[i];
+  }
+  bandCount_ = count;
+  bandAccelShift_ = (accelShift > 31) ? 31 : accelShift;
+}
+
+bool StepGenerator::start(const LinearMove& move) {
+  if (mode_ != Mode::Idle) return false;
+
+  // Zero cruise (speed 0, or below one Q32 unit): the phase would never carry
+  if (move.cruiseVelocityQ32 == 0) return false;
+
+  uint32_t dominant = 0;
+  uint8_t active = 0;
+  uint8_t negative = 0;
+
+  for (uint8_t i = 0; i < axisCount_; ++i) {
+    const int32_t d = move.deltas[i];
+    const uint32_t mag = (d < 0) ? static_cast<uint32_t>(-static_cast<int64_t>(d))
+                                 : static_cast<uint32_t>(d);
+    absDelta_[i] = mag;
+    if (mag == 0) continue;
+    active |= static_cast<uint8_t>(1u << i);
+    if (d < 0) negative |= static_cast<uint8_t>(1u << i);
+    if (mag > dominant) dominant = mag;
+  }
+  if (dominant == 0) return false;
+
+  for (uint8_t i = 0; i < axisCount_; ++i) {
+    error_[i] = dominant / 2;  // Centres the Bresenham steps along the line
+  }
+
+  activeMask_ = active;
+  negativeMask_ = static_cast<uint8_t>((negativeMask_ & ~active) | negative);
+  totalSteps_ = dominant;
+  stepsDone_ = 0;
+  stepsAccel_ = 0;
+  decelerating_ = false;
+
+  cruise_ = (move.cruiseVelocityQ32 > kMaxVelocityQ32) ? kMaxVelocityQ32 : move.cruiseVelocityQ32;
+  minVelocity_ = (move.minVelocityQ32 > cruise_) ? cruise_ : move.minVelocityQ32;
+  accel_ = (move.accelQ32 == 0) ? 1 : move.accelQ32;
+  bandAccel_ = boosted(accel_);
+  velocity_ = minVelocity_;
+  phase_ = 0;
+
+  mode_ = Mode::Linear;
+  return true;
+}
+
+bool StepGenerator::startVelocity(uint32_t accelQ32, uint32_t watchdogTicks) {
+  if (mode_ != Mode::Idle) return false;
+
+  for (uint8_t i = 0; i < kMaxAxes; ++i) {
+    targetVelocity_[i] = 0;
+    axisVelocity_[i] = 0;
+    axisPhase_[i] = 0;
+  }
+  setVelocityAccel(accelQ32);
+  watchdogTicks_ = watchdogTicks;
+  watchdogLeft_ = watchdogTicks;
+  stopRequested_ = false;
+  activeMask_ = 0;
+  mode_ = Mode::Velocity;
+  return true;
+}
+
+void StepGenerator::setTargetVelocity(uint8_t axis, int32_t velocityQ32) {
+  if (axis >= kMaxAxes) return;
+  const int32_t limit = static_cast<int32_t>(kMaxVelocityQ32);
+  if (velocityQ32 > limit) velocityQ32 = limit;
+  if (velocityQ32 < -limit) velocityQ32 = -limit;
+  targetVelocity_[axis] = velocityQ32;  // Single aligned store: no lock needed
+  watchdogLeft_ = watchdogTicks_;
+}
+
+void StepGenerator::haltAxes(uint8_t mask) {
+  for (uint8_t i = 0; i < kMaxAxes; ++i) {
+    if (!(mask & (1u << i))) continue;
+    axisVelocity_[i] = 0;
+    axisPhase_[i] = 0;
+  }
+  activeMask_ = static_cast<uint8_t>(activeMask_ & ~mask);
+}
+
+void StepGenerator::stop() {
+  mode_ = Mode::Idle;
+  activeMask_ = 0;
+  velocity_ = 0;
+  for (uint8_t i = 0; i < kMaxAxes; ++i) {
+    axisVelocity_[i] = 0;
+  }
+}
+
+int32_t StepGenerator::position(uint8_t axis) const {
+  return (axis < kMaxAxes) ? position_[axis] : 0;
+}
+
+void StepGenerator::setPosition(uint8_t axis, int32_t steps) {
+  if (axis < kMaxAxes) position_[axis] = steps;
+}
+
+}  // namespace motion
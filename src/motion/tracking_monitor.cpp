@@ -0,0 +1,48 @@
+#include "motion/tracking_monitor.h"
+
+namespace motion {
+namespace {
+
+inline int32_t absValue(int32_t v) { return (v < 0) ? -v : v; }
+
+}  // namespace
+
+void TrackingMonitor::reset(int32_t commandedSteps, int64_t encoderCounts) {
+  // Offset in counts so that measuredSteps(encoderCounts) == commandedSteps
+  const int64_t commandedCounts =
+      static_cast<int64_t>(commandedSteps) * config_.countsPerRev / config_.stepsPerRev;
+  countOffset_ = encoderCounts - commandedCounts;
+  lastCommanded_ = commandedSteps;
+  lastMeasured_ = commandedSteps;
+  followingError_ = 0;
+  strikes_ = 0;
+}
+
+int32_t TrackingMonitor::measuredSteps(int64_t encoderCounts) const {
+  const int64_t counts = encoderCounts - countOffset_;
+  return static_cast<int32_t>(counts * config_.stepsPerRev / config_.countsPerRev);
+}
+
+TrackingFault TrackingMonitor::update(int32_t commandedSteps, int64_t encoderCounts) {
+  const int32_t measured = measuredSteps(encoderCounts);
+  const int32_t commandedMotion = commandedSteps - lastCommanded_;
+  const int32_t measuredMotion = measured - lastMeasured_;
+  lastCommanded_ = commandedSteps;
+  lastMeasured_ = measured;
+  followingError_ = commandedSteps - measured;
+
+  if (absValue(followingError_) <= config_.maxFollowingError) {
+    strikes_ = 0;
+    return TrackingFault::None;
+  }
+  if (++strikes_ < config_.confirmSamples) {
+    return TrackingFault::None;
+  }
+  strikes_ = 0;
+
+  const bool commandedMoving = commandedMotion != 0;
+  const bool shaftStill = absValue(measuredMotion) <= config_.stallMotionSteps;
+  return (commandedMoving && shaftStill) ? TrackingFault::Stall : TrackingFault::LostSteps;
+}
+
+}  // namespace motion
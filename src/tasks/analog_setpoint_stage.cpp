@@ -0,0 +1,71 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "control/analog_setpoint.h"
+#include "hal/analog_input.h"
+#include "tasks/display_task.h"
+#include "tasks/sensor_pipeline.h"
+#include "tasks/trace_task.h"
+
+namespace tasks {
+
+// ============================================================================
+// ESTÁGIO DE SETPOINT ANALÓGICO (ADC CONTÍNUO)
+// ============================================================================
+//
+// Mesmo papel da TouchSensorStage (SENSOR no diagrama de blocos), com outra
+// fonte: o DMA do ADC amostra a 20 kHz sem a CPU; aqui só se soma o bloco
+// acumulado desde a chamada anterior (uma por período da malha externa).
+// ============================================================================
+
+bool AnalogSetpointStage::poll(TouchInputMessage& out) {
+  // Replay em curso: as entradas vêm do log
+  if (isTraceReplaying()) return false;
+
+  // -------------------------------------------------------------------------
+  // ETAPA 1: INICIALIZAÇÃO SOB DEMANDA DO ADC
+  // -------------------------------------------------------------------------
+  if (!hal::isAnalogInputReady() && !hal::initAnalogInput()) return false;
+
+  // -------------------------------------------------------------------------
+  // ETAPA 2: ESVAZIAR O BUFFER DO DMA (decimação por média do bloco)
+  // -------------------------------------------------------------------------
+  hal::AnalogBlock block;
+  if (!hal::drainAnalogInput(block)) return false;
+
+  // -------------------------------------------------------------------------
+  // ETAPA 3: FILTRO, ESCALA E HISTERESE
+  // -------------------------------------------------------------------------
+  control::AnalogSetpoint setpoint;
+  const bool changed = filter_.update(block.sum, block.samples, setpoint);
+
+  // -------------------------------------------------------------------------
+  // ETAPA 4: FEEDBACK VISUAL NO DISPLAY (zona equivalente à do toque)
+  // -------------------------------------------------------------------------
+  if (setpoint.zone != lastZone_) {
+    DisplayMessage displayMsg;
+    displayMsg.cmd = DisplayCmd::WriteChar;
+    displayMsg.col = 3;
+    displayMsg.row = 0;
+    displayMsg.c = '0' + setpoint.zone;
+    sendDisplayMessage(displayMsg, 0);
+    lastZone_ = setpoint.zone;
+  }
+
+  // -------------------------------------------------------------------------
+  // ETAPA 5: MENSAGEM AO CONTROLADOR (só com setpoint ativo)
+  // -------------------------------------------------------------------------
+  if (!changed || setpoint.intensity == 0) return false;
+  // Sentido do giro desde a última mensagem: girar sempre para o mesmo lado
+  // move o motor sempre para o mesmo lado (0 deixaria a lei alternar)
+  const int8_t direction = (setpoint.intensity < published_) ? -1 : 1;
+  published_ = setpoint.intensity;
+  out.touchValue = setpoint.raw;       // Média filtrada do ADC (0..4095)
+  out.touchZone = setpoint.zone;
+  out.intensity = setpoint.intensity;  // Variável de escalonamento
+  out.direction = direction;
+  out.timestampUs = block.timestampUs;  // Fim do bloco do DMA
+  return true;
+}
+
+}  // namespace tasks
@@ -9,6 +9,7 @@
 
 #include <freertos/semphr.h>
 #include "tasks/display_task.h"
+#include "tasks/system_events.h"
 
 namespace tasks {
 namespace {
@@ -27,10 +28,8 @@ void blinkTask(void* /*params*/) {
   bool ledOn = false;
   size_t letra_idx = 0;
 
-  // Inicializa LCD
-  // Apenas aguarda a display task inicializar e gerenciar o LCD
-  vTaskDelay(pdMS_TO_TICKS(500)); // Pequena espera para permitir init do display
-  
+  // O LED pisca desde o boot; o LCD só recebe mensagens depois que a
+  // display task sinalizar kDisplayReadyBit (sem espera fixa)
   tasks::DisplayMessage msg;
 
   for (;;) {
@@ -39,11 +38,13 @@ void blinkTask(void* /*params*/) {
     hal::setBuiltinLed(ledOn);
 
     // Envia mensagem para a display task
-    msg.cmd = tasks::DisplayCmd::WriteChar;
-    msg.col = 0;
-    msg.row = 0;
-    msg.c = ledOn ? '1' : '0';
-    tasks::sendDisplayMessage(msg, 0); // não bloqueia, se fila cheia, ignora
+    if (tasks::isSystemReady(tasks::kDisplayReadyBit)) {
+      msg.cmd = tasks::DisplayCmd::WriteChar;
+      msg.col = 0;
+      msg.row = 0;
+      msg.c = ledOn ? '1' : '0';
+      tasks::sendDisplayMessage(msg, 0); // não bloqueia, se fila cheia, ignora
+    }
 
     // letra_idx++;
     // if (letra_idx >= palavra_len) {
@@ -0,0 +1,80 @@
+#include "tasks/channel.h"
+
+#include <stdio.h>
+
+namespace tasks {
+namespace {
+
+struct ChannelEntry {
+  const char* name;
+  ChannelPolicy policy;
+  QueueHandle_t queue;
+  uint32_t capacity;
+  const ChannelCounters* counters;
+  std::atomic<bool> ready{false};  // Entrada preenchida (registro sem trava)
+};
+
+ChannelEntry gChannels[kMaxChannels];
+std::atomic<size_t> gChannelCount{0};
+
+const char* policyName(ChannelPolicy policy) {
+  switch (policy) {
+    case ChannelPolicy::Fifo:
+      return "fifo";
+    case ChannelPolicy::LatestWins:
+      return "latest";
+    case ChannelPolicy::Coalesce:
+      return "coalesce";
+  }
+  return "?";
+}
+
+}  // namespace
+
+void registerChannel(const char* name, ChannelPolicy policy, QueueHandle_t queue,
+                     uint32_t capacity, const ChannelCounters* counters) {
+  const size_t index = gChannelCount.fetch_add(1);
+  if (index >= kMaxChannels) return;  // Canal continua funcionando, só não aparece
+  ChannelEntry& entry = gChannels[index];
+  entry.name = name;
+  entry.policy = policy;
+  entry.queue = queue;
+  entry.capacity = capacity;
+  entry.counters = counters;
+  entry.ready.store(true, std::memory_order_release);
+}
+
+size_t getChannelStats(ChannelStats* out, size_t maxCount) {
+  size_t count = gChannelCount.load();
+  if (count > kMaxChannels) count = kMaxChannels;
+  size_t copied = 0;
+  for (size_t i = 0; i < count && copied < maxCount; ++i) {
+    const ChannelEntry& entry = gChannels[i];
+    if (!entry.ready.load(std::memory_order_acquire)) continue;
+    ChannelStats& stats = out[copied++];
+    stats.name = entry.name;
+    stats.policy = entry.policy;
+    stats.capacity = entry.capacity;
+    stats.depth = uxQueueMessagesWaiting(entry.queue);
+    stats.maxDepth = entry.counters->maxDepth.load(std::memory_order_relaxed);
+    stats.sent = entry.counters->sent.load(std::memory_order_relaxed);
+    stats.dropped = entry.counters->dropped.load(std::memory_order_relaxed);
+    stats.coalesced = entry.counters->coalesced.load(std::memory_order_relaxed);
+  }
+  return copied;
+}
+
+void printChannelStats() {
+  ChannelStats stats[kMaxChannels];
+  const size_t count = getChannelStats(stats, kMaxChannels);
+  printf("channel,name,policy,capacity,depth,max_depth,sent,dropped,coalesced\n");
+  for (size_t i = 0; i < count; ++i) {
+    const ChannelStats& s = stats[i];
+    printf("channel,%s,%s,%u,%u,%u,%u,%u,%u\n", s.name, policyName(s.policy),
+           static_cast<unsigned>(s.capacity), static_cast<unsigned>(s.depth),
+           static_cast<unsigned>(s.maxDepth), static_cast<unsigned>(s.sent),
+           static_cast<unsigned>(s.dropped), static_cast<unsigned>(s.coalesced));
+  }
+}
+
+}  // namespace tasks
@@ -1,11 +1,29 @@
 #include <Arduino.h>
+#include <stdio.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
 
+#include <atomic>
+#include <type_traits>
+
+#include "control/cascade.h"
+#include "control/explicit_mpc.h"
+#include "control/frequency_response.h"
+#include "control/mpc_table.h"
+#include "control/sample_clock.h"
+#include "control/trajectory.h"
+#include "hal/board.h"
+#include "hal/clock.h"
+#include "hal/warm_state.h"
+#include "tasks/channel.h"
 #include "tasks/control_task.h"
 #include "tasks/stepper_task.h"
 #include "tasks/display_task.h"
+#include "tasks/sensor_pipeline.h"
+#include "tasks/system_events.h"
+#include "tasks/task_config.h"
+#include "tasks/trace_task.h"
 
 namespace tasks {
 namespace {
@@ -14,260 +32,323 @@ namespace {
 // CONFIGURAÇÃO DO SISTEMA DE CONTROLE DIGITAL
 // ============================================================================
 
-// Fila de mensagens de entrada (sensor de toque)
-QueueHandle_t xTouchInputQueue = nullptr;
+// Fila de mensagens de entrada (sensor de toque, replay): Fifo limitada.
+// Cada mensagem é um evento de mudança de zona e o termo derivativo da lei
+// depende da sequência, então nenhuma é fundida; excesso é descartado e
+// contado no canal "touch_input"
+Channel<TouchInputMessage> gTouchInputChannel;
 
-// Tamanho da fila de entrada - permite buffer de múltiplas leituras
-constexpr size_t kTouchInputQueueLength = 10;
+bool createTouchInputChannel() {
+  return gTouchInputChannel.create("touch_input", ChannelPolicy::Fifo, kTouchInputQueueLength);
+}
 
 // Período de amostragem do controlador (em ticks de FreeRTOS)
-// Ts = tempo de amostragem = 100ms
+// Ts = período da malha externa, derivado de control::kControlRates (100ms)
 // Este é o período do sistema discreto (digital)
-constexpr TickType_t kControlPeriod = pdMS_TO_TICKS(100);
+constexpr TickType_t kControlPeriod = pdMS_TO_TICKS(control::kControlRates.outerPeriodUs() / 1000);
+
+// Controle em cascata: a malha externa (esta task) gera a referência de
+// posição e uma malha interna rápida (1 kHz) a segue comandando velocidade.
+// false = modo legado (um movimento enfileirado por comando).
+constexpr bool kCascadedControl = true;
+
+// Escalonamento da malha externa:
+//   TimeTriggered  acorda a cada Ts e consome no máximo uma entrada externa
+//                  por período (uma rajada espera até 10 × Ts na fila)
+//   Hybrid         bloqueia na entrada até o próximo Ts: cada entrada nova
+//                  acorda a task na hora, e tudo o que estiver pendente é
+//                  drenado e vira uma única atualização do atuador. A
+//                  amostragem do sensor e as demais atualizações periódicas
+//                  continuam a cada Ts.
+// Híbrido só na cascata: no modo legado cada despertar vira um movimento
+// enfileirado, e a rajada fundida na caixa do stepper acomoda depois
+// (input_burst no sim/: 2,22 s contra 1,54 s; ITAE 645 contra 273).
+enum class ControlScheduling : uint8_t { TimeTriggered, Hybrid };
+constexpr ControlScheduling kControlScheduling =
+    kCascadedControl ? ControlScheduling::Hybrid : ControlScheduling::TimeTriggered;
+constexpr bool kHybridScheduling = kControlScheduling == ControlScheduling::Hybrid;
+
+// Lei da malha interna:
+//   Position     P sobre o degrau com limite de frenagem (control/cascade.h)
+//   Feedforward  trajetória planejada com aceleração kInnerDecelLimit e
+//                Kvff·v_ref + Kaff·a_ref somados ao P (control/trajectory.h)
+//   ExplicitMpc  MPC explícito com limites de velocidade e aceleração no
+//                próprio problema (control/explicit_mpc.h, tabela gerada
+//                por tools/mpc_generate.py)
+// Ganhos, limites e demais constantes compartilhadas com o sim/ estão em
+// tasks/task_config.h (kInnerPositionGain, kInnerDecelLimit, kFeedforwardGains).
+// Position é o padrão: no sim/ acomoda antes nos quatro cenários e custa
+// metade da CPU por amostra. Feedforward segue a trajetória planejada com
+// menos de um passo de erro, mas a aceleração limitada a kInnerDecelLimit
+// atrasa a acomodação (touch_burst: 1,41 s contra 0,97 s); use quando o
+// seguimento importar mais que a chegada.
+enum class InnerLaw : uint8_t { Position, Feedforward, ExplicitMpc };
+constexpr InnerLaw kInnerLaw = InnerLaw::Position;
+
+// A tabela do MPC é gerada para uma aceleração; ela tem de ser a desta malha
+static_assert(control::kMpcTable.accelLimit == kInnerDecelLimit,
+              "Regenerar control/mpc_table.h com --amax = kInnerDecelLimit");
+static_assert(control::kMpcTable.accelLimit < kDefaultStepperVelocityAccel,
+              "MPC deve pedir menos aceleração que o stepper entrega");
+
 
 
 // ============================================================================
-// PARÂMETROS DA FUNÇÃO DE TRANSFERÊNCIA
+// LEI DE CONTROLE
 // ============================================================================
-// 
-// Em sistemas de controle digital, a função de transferência G(z) relaciona
-// a entrada (sensor) com a saída (atuador) no domínio z (transformada Z).
-// 
-// Para um controlador simples proporcional-derivativo (PD):
-//   U(z) = Kp * E(z) + Kd * (E(z) - E(z^-1)) / Ts
-// 
-// Onde:
-//   U(z) = sinal de controle (número de passos do motor)
-//   E(z) = erro atual (diferença entre setpoint e valor medido)
-//   E(z^-1) = erro anterior (um período de amostragem atrás)
-//   Kp = ganho proporcional
-//   Kd = ganho derivativo
-//   Ts = período de amostragem
+//
+// Parâmetros (Kp, Kd, LUT de zonas, zona morta e saturação) e a equação de
+// diferenças estão em control/pd_lut_law.* (sem dependência de FreeRTOS).
+// A lei roda como estágio do pipeline (tasks/sensor_pipeline.h), chamada
+// diretamente pelo estágio do sensor quando os dois estão nesta task.
 // ============================================================================
 
-// Ganho proporcional - Define quanto a saída responde ao erro atual
-// Valores maiores = resposta mais agressiva
-constexpr float kProportionalGain = 8.0f;  // Kp
+static_assert(std::is_same<SensorPipeline::ContextAt<kInputTraceStage>, ControlContext>::value,
+              "entradas externas são injetadas na lei de controle pela control_task");
 
-// Ganho derivativo - Define quanto a saída responde à taxa de variação do erro
-// Ajuda a reduzir overshoot e melhorar estabilidade
-constexpr float kDerivativeGain = 2.0f;    // Kd
+// Sensor na própria control_task: amostrado a cada Ts, nunca por evento
+constexpr bool kSensorFused = !SensorPipeline::runsIn<TouchContext>();
 
-// Valor mínimo de comando para vencer atrito estático do motor
-// Zona morta (deadband) - comandos menores são ignorados
-constexpr uint32_t kMinSteps = 10;
+// Referência de posição mantida pela malha externa e publicada à interna
+control::PositionSetpoint gOuterSetpoint = {0, 0.0f, 0};
+control::LatestValue<control::PositionSetpoint> gSetpointHandoff;
 
-// Valor máximo de passos por comando (saturação)
-// Limita a saída para evitar movimentos bruscos
-constexpr uint32_t kMaxSteps = 1000;
+// Estatísticas de execução das duas malhas. Cada malha acumula numa cópia
+// própria (só ela escreve) e publica pelo seqlock a cada execução:
+// getControlLoopStats() roda em outra task e nunca lê uma cópia pela metade
+struct OuterLoopStats {
+  control::LoopStats loop;
+  uint32_t eventWakes;
+  control::LatencyStats inputLatency;
+};
+control::LatestValue<control::LoopStats> gInnerStats;
+control::LatestValue<OuterLoopStats> gOuterStats;
+OuterLoopStats gOuterStatsLocal = {};  // Só a control_task (pipeline incluso)
 
+TaskHandle_t gControlTask = nullptr;
 
-// ============================================================================
-// MAPEAMENTO ENTRADA → SAÍDA
-// ============================================================================
-//
-// Função de transferência implementada em código:
-// Converte zona de toque (entrada digital) em número de passos (saída digital)
-//
-// Este mapeamento representa a relação estática do sistema:
-//   Zona 0 (sem toque)     → 0 passos      → sem movimento
-//   Zona 1 (toque leve)    → 50 passos     → movimento suave
-//   Zona 2 (toque médio)   → 200 passos    → movimento moderado
-//   Zona 3 (toque forte)   → 500 passos    → movimento rápido
-//
-// Em termos de controle digital, esta é uma LUT (Look-Up Table) que
-// implementa uma função não-linear: y[k] = f(u[k])
-// ============================================================================
+// Tabela de escalonamento ativa (id guardado na partida a quente)
+std::atomic<uint8_t> gGainSchedule{static_cast<uint8_t>(control::GainScheduleId::Touch)};
 
-// Tabela de mapeamento: zona de toque → número de passos base
-constexpr uint32_t kZoneToStepsMap[] = {
-    0,      // Zona 0: sem toque → sem movimento
-    50,     // Zona 1: toque leve → 50 passos
-    200,    // Zona 2: toque médio → 200 passos
-    500     // Zona 3: toque forte → 500 passos
-};
+TaskHandle_t gInnerLoopTask = nullptr;
+hw_timer_t* gInnerLoopTimer = nullptr;
 
-// Velocidades de rotação por zona (intervalo entre pulsos em microsegundos)
-// Intervalos menores = velocidade maior
-constexpr uint32_t kZoneToSpeedMap[] = {
-    2000,   // Zona 0: N/A (não usado)
-    1500,   // Zona 1: lento (1500μs entre pulsos)
-    800,    // Zona 2: médio (800μs entre pulsos)
-    300     // Zona 3: rápido (300μs entre pulsos)
-};
+// Medição de resposta em frequência (Bode) na malha interna
+control::FrequencySweep gSweep;
+control::SweepConfig gSweepConfig = {};
+std::atomic<bool> gSweepStartRequest{false};
+std::atomic<bool> gSweepAbortRequest{false};
+std::atomic<bool> gSweepActive{false};
+float gSweepRestoreAccel = kDefaultStepperVelocityAccel;  // Aceleração de antes da medição
+QueueHandle_t gBodeQueue = nullptr;
+constexpr size_t kBodeQueueLength = 4;
+
+
+}  // namespace
 
 
 // ============================================================================
-// VARIÁVEIS DE ESTADO DO CONTROLADOR
+// ESTÁGIO DO ATUADOR
 // ============================================================================
-// 
-// Em sistemas de controle digital, mantemos um histórico de estados
-// para implementar a equação de diferenças do controlador.
-// 
-// A equação de diferenças é a versão discreta da função de transferência:
-//   y[k] = f(u[k], u[k-1], y[k-1], ...)
-// 
-// Onde:
-//   k = instante de tempo atual
-//   k-1 = instante de tempo anterior
+//
+// A lei de controle (ETAPAS 1 a 8 e 10) está em control/pd_lut_law.cpp,
+// sem dependência de FreeRTOS, para poder ser medida e simulada no host.
+// Aqui fica a ETAPA 9: entregar o comando calculado ao atuador. O estágio
+// da lei só repassa comandos com movimento (command.steps != 0); os
+// comandos de um mesmo despertar chegam somados (ActuatorStage::process).
 // ============================================================================
 
-// Estado anterior do controlador
-struct ControlState {
-  int32_t lastError;           // Erro anterior: e[k-1]
-  uint8_t lastZone;            // Zona anterior: zona[k-1]
-  bool alternateDirection;     // Direção alternada (para demonstração)
-};
+uint32_t ActuatorStage::flush() {
+  const uint32_t commands = pendingCommands_;
+  const control::MotorCommand command = pending_;
+  pending_ = control::MotorCommand{0, 0.0f};
+  pendingCommands_ = 0;
+  if (command.steps == 0) return commands;  // Nada ou comandos que se anulam
 
-ControlState gControlState = {0, 0, false};
+  // -------------------------------------------------------------------------
+  // ETAPA 9: ENVIAR COMANDO AO ATUADOR (saída do sistema)
+  // -------------------------------------------------------------------------
+  if (kCascadedControl) {
+    // Cascata: desloca a referência de posição; a malha interna executa.
+    // O limite é o cruzeiro da trajetória: fora das faixas de ressonância
+    gOuterSetpoint.positionSteps += command.steps;
+    gOuterSetpoint.velocityLimit = planStepperCruise(command.speedInStepsPerSec);
+    gOuterSetpoint.timestampUs = hal::nowUs();
+    gSetpointHandoff.write(gOuterSetpoint);
+  } else {
+    // Monta a mensagem de controle do motor (gerador de passos do stepper_task)
+    StepperMessage motorCmd{};
+    motorCmd.targetPosition = command.steps;                    // Passos com direção
+    motorCmd.speedInStepsPerSec = command.speedInStepsPerSec;  // Velocidade calculada
+    motorCmd.accelInStepsPerSecSec = kQueuedMoveAccel;         // Aceleração padrão
+    motorCmd.isRelative = true;                                // Movimento relativo
 
+    // Envia comando para a fila do motor (sistema de atuação)
+    sendStepperMessage(motorCmd, 0);
+  }
+
+  // Feedback visual no display (opcional)
+  DisplayMessage displayMsg;
+  displayMsg.cmd = DisplayCmd::WriteChar;
+  displayMsg.col = 5;
+  displayMsg.row = 0;
+  displayMsg.c = (command.steps > 0) ? 'R' : 'L';
+  sendDisplayMessage(displayMsg, 0);
+  return commands;
+}
+
+namespace {
 
 // ============================================================================
-// FUNÇÃO DE PROCESSAMENTO DO CONTROLADOR
+// MALHA INTERNA (RÁPIDA) - POSIÇÃO → VELOCIDADE
 // ============================================================================
 //
-// Esta é a implementação da função de transferência discreta (digital).
-// Ela recebe a entrada (mensagem de toque) e calcula a saída (comando do motor).
-//
-// Fluxo do processamento:
-// 1. Lê entrada do sensor (via fila de mensagens)
-// 2. Calcula erro: e[k] = setpoint - medição
-// 3. Aplica lei de controle: u[k] = f(e[k], e[k-1], ...)
-// 4. Satura/limita a saída
-// 5. Envia comando ao atuador (motor de passo)
-// 6. Atualiza estados para próxima iteração
+// Um timer de hardware notifica a task de alta prioridade a cada período
+// interno. Várias notificações acumuladas = amostras perdidas (overrun).
 // ============================================================================
 
-void processControlLaw(const TouchInputMessage& input) {
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 1: EXTRAÇÃO DA ZONA DE TOQUE (entrada do sistema)
-  // -------------------------------------------------------------------------
-  // A zona representa a intensidade do toque (0 a 3)
-  // Esta é nossa entrada discreta: u[k]
-  uint8_t zone = input.touchZone;
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 2: MAPEAMENTO ENTRADA → PASSOS BASE (função de transferência)
-  // -------------------------------------------------------------------------
-  // Aqui aplicamos a tabela de conversão (LUT)
-  // Esta é a relação estática: passos_base = G_static(zona)
-  // 
-  // Matematicamente: y_base[k] = f(u[k])
-  uint32_t baseSteps = 0;
-  uint32_t speedInterval = 1000;
-  
-  if (zone < sizeof(kZoneToStepsMap) / sizeof(kZoneToStepsMap[0])) {
-    baseSteps = kZoneToStepsMap[zone];      // Número de passos pela zona
-    speedInterval = kZoneToSpeedMap[zone];  // Velocidade pela zona
+void IRAM_ATTR onInnerLoopTick() {
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(gInnerLoopTask, &woken);
+  if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+// Uma amostra da varredura de Bode: soma a excitação à saída do controlador,
+// registra entrada/saída da planta e publica cada ponto concluído
+float runSweepSample(float controllerOutput, int32_t measured) {
+  if (gSweepStartRequest.exchange(false)) {
+    gSweep.start(gSweepConfig);
   }
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 3: CÁLCULO DO ERRO (componente proporcional)
-  // -------------------------------------------------------------------------
-  // O erro é a diferença entre a zona desejada e a zona anterior
-  // Isso permite um comportamento mais suave e controlado
-  // 
-  // Erro atual: e[k] = referência[k] - medição[k]
-  // Para este sistema simplificado: e[k] = zona[k] - zona[k-1]
-  int32_t currentError = static_cast<int32_t>(zone) - static_cast<int32_t>(gControlState.lastZone);
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 4: COMPONENTE DERIVATIVA (taxa de variação)
-  // -------------------------------------------------------------------------
-  // A derivada discreta aproxima: d/dt ≈ (e[k] - e[k-1]) / Ts
-  // Isso nos dá informação sobre a tendência do erro
-  // 
-  // Derivada do erro: de[k] = e[k] - e[k-1]
-  int32_t errorDerivative = currentError - gControlState.lastError;
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 5: LEI DE CONTROLE PD (Proporcional-Derivativo)
-  // -------------------------------------------------------------------------
-  // Combinamos os componentes proporcional e derivativo
-  // 
-  // Sinal de controle: u[k] = Kp * e[k] + Kd * de[k]
-  // 
-  // O componente proporcional (Kp * e[k]) corrige o erro atual
-  // O componente derivativo (Kd * de[k]) antecipa mudanças futuras
-  float controlSignal = (kProportionalGain * currentError) + 
-                        (kDerivativeGain * errorDerivative);
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 6: COMBINAÇÃO COM O MAPEAMENTO BASE
-  // -------------------------------------------------------------------------
-  // Somamos o sinal de controle aos passos base da zona
-  // Isso permite ajuste fino além do mapeamento estático
-  // 
-  // Saída total: y[k] = y_base[k] + u[k]
-  int32_t totalSteps = baseSteps + static_cast<int32_t>(controlSignal);
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 7: SATURAÇÃO E ZONA MORTA
-  // -------------------------------------------------------------------------
-  // Limitamos a saída para valores fisicamente realizáveis
-  // 
-  // Zona morta: se |y[k]| < threshold, então y[k] = 0
-  // Saturação superior: se y[k] > max, então y[k] = max
-  // Saturação inferior: se y[k] < 0, então y[k] = 0
-  uint32_t commandSteps = 0;
-  
-  if (totalSteps < static_cast<int32_t>(kMinSteps)) {
-    // Zona morta - movimento muito pequeno é ignorado
-    commandSteps = 0;
-  } else if (totalSteps > static_cast<int32_t>(kMaxSteps)) {
-    // Saturação superior - limita movimento máximo
-    commandSteps = kMaxSteps;
-  } else {
-    // Faixa válida - usa o valor calculado
-    commandSteps = static_cast<uint32_t>(totalSteps);
+  if (gSweepAbortRequest.exchange(false)) {
+    gSweep.abort();
   }
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 8: DETERMINAR DIREÇÃO DO MOVIMENTO
-  // -------------------------------------------------------------------------
-  // Alternamos a direção para demonstrar controle bidirecional
-  // Em um sistema real, isso seria determinado pelo sinal do erro
-  int32_t directionMultiplier = gControlState.alternateDirection ? -1 : 1;
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 9: ENVIAR COMANDO AO ATUADOR (saída do sistema)
-  // -------------------------------------------------------------------------
-  // Se há movimento a ser realizado, enviamos o comando ao motor
-  if (commandSteps > 0) {
-    // Converte velocidade de intervalo (μs) para steps/segundo
-    // Fórmula: steps/sec = 1.000.000 / intervalUs
-    float speedInStepsPerSec = (speedInterval > 0) ? (1000000.0f / speedInterval) : 500.0f;
-    
-    // Monta a mensagem de controle do motor (usando FlexyStepper)
-    StepperMessage motorCmd{};
-    motorCmd.targetPosition = commandSteps * directionMultiplier;  // Passos com direção
-    motorCmd.speedInStepsPerSec = speedInStepsPerSec;              // Velocidade calculada
-    motorCmd.accelInStepsPerSecSec = 200.0f;                       // Aceleração padrão
-    motorCmd.isRelative = true;                                    // Movimento relativo
-    
-    // Envia comando para a fila do motor (sistema de atuação)
-    sendStepperMessage(motorCmd, 0);
-    
-    // Feedback visual no display (opcional)
-    DisplayMessage displayMsg;
-    displayMsg.cmd = DisplayCmd::WriteChar;
-    displayMsg.col = 5;
-    displayMsg.row = 0;
-    displayMsg.c = (directionMultiplier > 0) ? 'R' : 'L';
-    sendDisplayMessage(displayMsg, 0);
+
+  const float velocity = controllerOutput + gSweep.excitation();
+  if (gSweep.record(velocity, static_cast<float>(measured))) {
+    control::FrequencyPoint point = gSweep.lastPoint();
+    point.timestampUs = hal::nowUs();
+    xQueueSend(gBodeQueue, &point, 0);
+  }
+  if (!gSweep.running()) {
+    setStepperVelocityAccel(gSweepRestoreAccel);  // Fim ou abort: a do usuário volta
+    gSweepActive.store(false);
+  }
+  return velocity;
+}
+
+// Transmite a tabela pela serial, fora da malha (prioridade baixa)
+void bodeReportTask(void* /*params*/) {
+  control::FrequencyPoint point;
+  for (;;) {
+    if (xQueueReceive(gBodeQueue, &point, portMAX_DELAY) == pdTRUE) {
+      printf("bode,%u,%.3f,%.2f,%.1f,%.2f,%.1f\n", point.index, point.hz, point.plantGainDb,
+             point.plantPhaseDeg, point.loopGainDb, point.loopPhaseDeg);
+    }
   }
-  
-  // -------------------------------------------------------------------------
-  // ETAPA 10: ATUALIZAR ESTADOS PARA PRÓXIMA ITERAÇÃO
-  // -------------------------------------------------------------------------
-  // Armazenamos os valores atuais para uso no próximo ciclo
-  // Isso implementa o "atraso" (z^-1) da função de transferência discreta
-  // 
-  // Estado[k] → Estado[k-1] para o próximo ciclo
-  gControlState.lastError = currentError;
-  gControlState.lastZone = zone;
-  gControlState.alternateDirection = !gControlState.alternateDirection;
+}
+
+void innerLoopTask(void* /*params*/) {
+  const control::PositionLoop positionLoop(kInnerPositionGain, kInnerDecelLimit);
+  const control::FeedforwardLoop feedforwardLoop(kFeedforwardGains);
+  constexpr uint32_t kPeriodUs = control::kControlRates.innerPeriodUs();
+  control::TrajectoryGenerator trajectory(kInnerDecelLimit,
+                                          1.0f / control::kControlRates.innerHz);
+  bool trajectoryPrimed = false;
+  control::ExplicitMpcLoop mpcLoop(control::kMpcTable, 1.0f / control::kControlRates.innerHz);
+  control::StreamGate streamGate(kInnerIdleSamples);
+  control::LoopStats stats = {};
+
+  // Intervalo real entre amostras: jitter e amostras perdidas entram na
+  // integração da trajetória e do MPC, em vez de um Ts suposto
+  control::SampleClock sampleClock(kPeriodUs, kInnerMaxSampleGapUs);
+
+  for (;;) {
+    const uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    const hal::TimestampUs startUs = hal::nowUs();
+    const float dtS = static_cast<float>(sampleClock.sample(startUs)) * 1e-6f;
+
+    // Lê a referência mais recente (nunca bloqueia a malha externa)
+    const control::PositionSetpoint setpoint = gSetpointHandoff.read();
+    const int32_t measured = getMeasuredStepperPosition();
+
+    float velocity = 0.0f;
+    if (kInnerLaw == InnerLaw::Feedforward) {
+      // Trajetória parte da referência inicial (posição restaurada), sem salto
+      if (!trajectoryPrimed) {
+        trajectory.reset(static_cast<float>(setpoint.positionSteps));
+        trajectoryPrimed = true;
+      }
+      // u[k] = sat(Kvff·v_ref + Kaff·a_ref + Kp·(p_ref - y)) → velocidade do motor
+      const control::TrajectorySample& reference =
+          trajectory.update(setpoint.positionSteps, setpoint.velocityLimit, dtS);
+      velocity = feedforwardLoop.update(reference, setpoint.velocityLimit, measured);
+    } else if (kInnerLaw == InnerLaw::ExplicitMpc) {
+      // Busca da região em ponto fixo (pior caso limitado) → v[k] + a·dt
+      velocity = mpcLoop.update(setpoint, measured, dtS);
+    } else {
+      // u[k] = sat(Kp * (r[k] - y[k])) → velocidade do motor
+      velocity = positionLoop.update(setpoint, measured);
+    }
+    if (gSweepActive.load(std::memory_order_relaxed)) {
+      velocity = runSweepSample(velocity, measured);
+    }
+
+    // Parada no alvo: encerra o streaming uma vez e deixa o gerador livre
+    switch (streamGate.update(setpoint.positionSteps - measured, velocity)) {
+      case control::StreamAction::Write:
+        setStepperVelocity(velocity);
+        break;
+      case control::StreamAction::Stop:
+        stopStepperVelocity();
+        break;
+      case control::StreamAction::Hold:
+        break;
+    }
+
+    const uint32_t elapsedUs = static_cast<uint32_t>(hal::nowUs() - startUs);
+    stats.record(elapsedUs, kPeriodUs, pending > 1 ? pending - 1 : 0);
+    gInnerStats.write(stats);
+  }
+}
+
+void startInnerLoop(UBaseType_t priority) {
+  constexpr uint32_t kStackDepthWords = 2048;
+  constexpr uint16_t kTimerDivider = 80;  // 1 tick = 1 us
+
+  // Timer armado pela control_task, depois que o atuador estiver pronto
+  gInnerLoopTimer = timerBegin(hal::kControlTimer, kTimerDivider, true);
+  timerAttachInterrupt(gInnerLoopTimer, onInnerLoopTick, true);
+  timerAlarmWrite(gInnerLoopTimer, control::kControlRates.innerPeriodUs(), true);
+
+  xTaskCreate(innerLoopTask, "control_inner", kStackDepthWords, nullptr, priority,
+              &gInnerLoopTask);
+}
+
+
+// Períodos inteiros vencidos além do próximo (a task atrasou mais de um Ts):
+// são pulados e contados como amostras perdidas, em vez de rodados em rajada
+uint32_t skipMissedPeriods(TickType_t& lastWakeTime) {
+  const TickType_t late = xTaskGetTickCount() - lastWakeTime;
+  if (late < 2 * kControlPeriod) return 0;
+  const uint32_t missed = late / kControlPeriod - 1;
+  lastWakeTime += missed * kControlPeriod;
+  return missed;
+}
+
+// Espera o próximo período ou, no modo híbrido, o que vier primeiro entre
+// o período e uma entrada nova. true = período vencido (lastWakeTime avança).
+bool waitForWork(TickType_t& lastWakeTime) {
+  if (!kHybridScheduling) {
+    vTaskDelayUntil(&lastWakeTime, kControlPeriod);
+    return true;
+  }
+  const TickType_t due = lastWakeTime + kControlPeriod;
+  const int32_t remaining = static_cast<int32_t>(due - xTaskGetTickCount());
+  if (remaining > 0 && ulTaskNotifyTake(pdTRUE, static_cast<TickType_t>(remaining)) > 0) {
+    return false;  // Entrada nova antes do período
+  }
+  lastWakeTime = due;
+  return true;
 }
 
 
@@ -288,42 +369,80 @@ void processControlLaw(const TouchInputMessage& input) {
 
 void controlTask(void* /*params*/) {
   // Cria a fila de entrada se ainda não existir
-  if (xTouchInputQueue == nullptr) {
-    xTouchInputQueue = xQueueCreate(kTouchInputQueueLength, sizeof(TouchInputMessage));
-  }
+  createTouchInputChannel();
   
+  // Aguarda o atuador (posição restaurada em partida a quente)
+  waitSystemReady(kStepperReadyBit);
+
+  // Partida a quente: volta a tabela de escalonamento que estava ativa
+  hal::WarmState warm{};
+  if (hal::restoreWarmState(warm)) {
+    setControlGainSchedule(static_cast<control::GainScheduleId>(warm.gainSchedule));
+  }
+
+  if (kCascadedControl) {
+    // Referência inicial = posição atual, sem salto na partida
+    gOuterSetpoint.positionSteps = getMeasuredStepperPosition();
+    gOuterSetpoint.velocityLimit = 0.0f;
+    gOuterSetpoint.timestampUs = hal::nowUs();
+    gSetpointHandoff.write(gOuterSetpoint);
+    timerAlarmEnable(gInnerLoopTimer);
+  }
+  // Sensor fundido nesta task: a amostragem começa junto com o controle
+  signalSystemReady(SensorPipeline::runsIn<TouchContext>() ? kControlReadyBit
+                                                           : kControlReadyBit | kTouchReadyBit);
+
   // Variável para armazenar a última vez que o controle foi executado
   TickType_t lastWakeTime = xTaskGetTickCount();
   
-  // Loop infinito do controlador (execução periódica)
+  // Loop infinito do controlador (execução periódica + eventos)
   for (;;) {
     // -----------------------------------------------------------------------
     // SINCRONIZAÇÃO TEMPORAL (período de amostragem)
     // -----------------------------------------------------------------------
-    // Aguarda até o próximo período de controle (Ts)
-    // Isso garante execução determinística e periódica
-    vTaskDelayUntil(&lastWakeTime, kControlPeriod);
+    // Aguarda até o próximo período de controle (Ts), ou até uma entrada
+    // nova no modo híbrido; os períodos continuam alinhados a lastWakeTime
+    const uint32_t missedSamples = skipMissedPeriods(lastWakeTime);
+    const bool periodic = waitForWork(lastWakeTime);
+    const int64_t startUs = hal::nowUs();
+
+    // Início de gravação/replay: a lei parte do estado inicial
+    if (traceSessionPending()) {
+      sensorPipeline().stage<kControlLawStage>().reset();
+      traceSessionBegin();
+    }
     
     // -----------------------------------------------------------------------
-    // LEITURA DA ENTRADA (sensor → controlador)
+    // LEITURA → LEI DE CONTROLE → ATUADOR (segmento do pipeline desta task)
     // -----------------------------------------------------------------------
+    // Com o sensor nesta task: amostra o toque a cada Ts e chama a lei
+    // diretamente. Com o sensor na touch_task: consome os eventos da fila
+    // (um por período, ou todos os pendentes no modo híbrido).
+    // O estágio da lei implementa a função de transferência G(z)
+    if (kSensorFused) {
+      if (periodic) sensorPipeline().run<ControlContext>(0);
+    } else {
+      while (sensorPipeline().run<ControlContext>(0) > 0 && kHybridScheduling) {
+      }
+    }
+
+    // Entradas externas (sendTouchInputMessage, replay), sem bloqueio
     TouchInputMessage inputMsg;
-    
-    // Tenta ler mensagem da fila (sem bloqueio)
-    // Se houver mensagem disponível, processa; senão, aguarda próximo ciclo
-    if (xTouchInputQueue != nullptr && 
-        xQueueReceive(xTouchInputQueue, &inputMsg, 0) == pdTRUE) {
-      
-      // ---------------------------------------------------------------------
-      // EXECUÇÃO DA LEI DE CONTROLE
-      // ---------------------------------------------------------------------
-      // Processa a mensagem de entrada e calcula a saída
-      // Esta função implementa a função de transferência G(z)
-      processControlLaw(inputMsg);
+    bool drained = false;
+    while (!drained && gTouchInputChannel.receive(inputMsg, 0)) {
+      sensorPipeline().inject<kInputTraceStage>(inputMsg);
+      drained = !kHybridScheduling;
     }
-    
+
+    // Uma atualização do atuador com a soma dos comandos deste despertar.
     // Se não houver mensagem, o controlador permanece em estado de espera
     // mantendo os últimos valores de estado (e[k-1], y[k-1], etc.)
+    sensorPipeline().stage<kActuatorStage>().flush();
+
+    const uint32_t elapsedUs = static_cast<uint32_t>(hal::nowUs() - startUs);
+    gOuterStatsLocal.loop.record(elapsedUs, control::kControlRates.outerPeriodUs(), missedSamples);
+    if (!periodic) ++gOuterStatsLocal.eventWakes;
+    gOuterStats.write(gOuterStatsLocal);
   }
 }
 
@@ -334,7 +453,11 @@ void controlTask(void* /*params*/) {
 // INTERFACE PÚBLICA
 // ============================================================================
 
-void startControlTask(UBaseType_t priority) {
+void startControlTask(UBaseType_t priority, UBaseType_t innerLoopPriority) {
+  if (kCascadedControl) {
+    startInnerLoop(innerLoopPriority);
+  }
+
   constexpr uint32_t kStackDepthWords = 3072;  // Stack maior para cálculos
   xTaskCreate(
       controlTask,
@@ -342,18 +465,81 @@ void startControlTask(UBaseType_t priority) {
       kStackDepthWords,
       nullptr,
       priority,          // Prioridade intermediária (entre sensor e atuador)
-      nullptr);
+      &gControlTask);
+}
+
+void notifyControlInput() {
+  if (kHybridScheduling && gControlTask != nullptr) xTaskNotifyGive(gControlTask);
+}
+
+void recordInputLatency(hal::TimestampUs timestampUs) {
+  // No replay o carimbo é o do log original
+  if (isTraceReplaying()) return;
+  const int64_t ageUs = hal::nowUs() - timestampUs;
+  gOuterStatsLocal.inputLatency.record(ageUs > 0 ? static_cast<uint32_t>(ageUs) : 0u);
+}
+
+bool setControlGainSchedule(control::GainScheduleId id) {
+  const control::GainSchedule* table = control::gainScheduleFor(static_cast<uint8_t>(id));
+  if (table == nullptr) return false;
+  sensorPipeline().stage<kControlLawStage>().setSchedule(*table);  // Troca atômica
+  gGainSchedule.store(static_cast<uint8_t>(id));
+  hal::storeWarmGainSchedule(static_cast<uint8_t>(id));
+  return true;
+}
+
+control::GainScheduleId getControlGainSchedule() {
+  return static_cast<control::GainScheduleId>(gGainSchedule.load());
+}
+
+bool startFrequencyResponse(const control::SweepConfig& config, float velocityAccel) {
+  if (!kCascadedControl || gInnerLoopTask == nullptr) return false;
+  if (gSweepActive.load()) return false;
+
+  // Valida antes de entregar à malha interna
+  control::FrequencySweep probe;
+  if (!probe.start(config)) return false;
+
+  if (gBodeQueue == nullptr) {
+    gBodeQueue = xQueueCreate(kBodeQueueLength, sizeof(control::FrequencyPoint));
+    xTaskCreate(bodeReportTask, "bode_report", 2048, nullptr, tskIDLE_PRIORITY + 1, nullptr);
+  }
+  printf("bode,index,hz,plant_gain_db,plant_phase_deg,loop_gain_db,loop_phase_deg\n");
+
+  gSweepConfig = config;
+  gSweepRestoreAccel = getStepperVelocityAccel();
+  setStepperVelocityAccel(velocityAccel, false);  // Só durante a medição
+  gSweepStartRequest.store(true);
+  gSweepActive.store(true);  // Publica a configuração para a malha interna
+  return true;
+}
+
+void abortFrequencyResponse() {
+  if (gSweepActive.load()) gSweepAbortRequest.store(true);
+}
+
+bool isFrequencyResponseRunning() {
+  return gSweepActive.load();
+}
+
+ControlLoopStats getControlLoopStats() {
+  const OuterLoopStats outer = gOuterStats.read();
+  ControlLoopStats stats;
+  stats.inner = gInnerStats.read();
+  stats.outer = outer.loop;
+  stats.eventWakes = outer.eventWakes;
+  stats.inputLatency = outer.inputLatency;
+  return stats;
 }
 
 bool sendTouchInputMessage(const TouchInputMessage& msg, TickType_t ticksToWait) {
   // Cria a fila se necessário (inicialização lazy)
-  if (xTouchInputQueue == nullptr) {
-    xTouchInputQueue = xQueueCreate(kTouchInputQueueLength, sizeof(TouchInputMessage));
-    if (xTouchInputQueue == nullptr) return false;
-  }
-  
-  // Envia mensagem para a fila do controlador
-  return xQueueSend(xTouchInputQueue, &msg, ticksToWait) == pdTRUE;
+  if (!createTouchInputChannel()) return false;
+
+  // Envia mensagem para a fila do controlador e acorda a malha externa
+  if (!gTouchInputChannel.send(msg, ticksToWait)) return false;
+  notifyControlInput();
+  return true;
 }
 
 }  // namespace tasks
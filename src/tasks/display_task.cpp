@@ -5,7 +5,9 @@
 #include <freertos/queue.h>
 #include <Wire.h>
 
+#include "tasks/channel.h"
 #include "tasks/display_task.h"
+#include "tasks/system_events.h"
 
 namespace tasks {
 namespace {
@@ -20,12 +22,18 @@ constexpr uint8_t kSclPin = 22;        // ESP32 default SCL pin
 // Global LCD object
 LiquidCrystal_I2C lcd(kLcdAddress, kLcdColumns, kLcdRows);
 
-// Queue for display messages
-QueueHandle_t xDisplayQueue = nullptr;
+// Fila de mensagens do display: Fifo limitada (cada escrita vai para uma
+// célula diferente, nenhuma pode ser fundida); com a fila cheia a
+// mensagem é descartada e contada no canal "display"
+Channel<DisplayMessage> gDisplayChannel;
 
 // Maximum number of queued messages
 constexpr size_t kDisplayQueueLength = 16;
 
+bool createDisplayChannel() {
+  return gDisplayChannel.create("display", ChannelPolicy::Fifo, kDisplayQueueLength);
+}
+
 // Display task implementation - shows "Hello World" and a counter
 void displayTask(void* /*params*/) {
   // Inicializa I2C e LCD
@@ -35,14 +43,13 @@ void displayTask(void* /*params*/) {
   lcd.clear();
 
   // Cria a fila se ainda nao criada
-  if (xDisplayQueue == nullptr) {
-    xDisplayQueue = xQueueCreate(kDisplayQueueLength, sizeof(DisplayMessage));
-  }
+  createDisplayChannel();
+  signalSystemReady(kDisplayReadyBit);
 
   DisplayMessage msg;
   for (;;) {
     // Espera por mensagens e processa
-    if (xDisplayQueue != nullptr && xQueueReceive(xDisplayQueue, &msg, portMAX_DELAY) == pdTRUE) {
+    if (gDisplayChannel.receive(msg, portMAX_DELAY)) {
       switch (msg.cmd) {
         case DisplayCmd::WriteChar:
           if (msg.col < kLcdColumns && msg.row < kLcdRows) {
@@ -74,12 +81,11 @@ void startDisplayTask(UBaseType_t priority) {
 }
 
 bool sendDisplayMessage(const DisplayMessage& msg, TickType_t ticksToWait) {
-  if (xDisplayQueue == nullptr) {
-    // Try to create queue lazily if task hasn't initialized it yet
-    xDisplayQueue = xQueueCreate(kDisplayQueueLength, sizeof(DisplayMessage));
-    if (xDisplayQueue == nullptr) return false;
-  }
-  return xQueueSend(xDisplayQueue, &msg, ticksToWait) == pdTRUE;
+  // Try to create queue lazily if task hasn't initialized it yet
+  if (!createDisplayChannel()) return false;
+  DisplayMessage stamped = msg;
+  stamped.timestampUs = hal::nowUs();
+  return gDisplayChannel.send(stamped, ticksToWait);
 }
 
 }  // namespace tasks
\ No newline at end of file
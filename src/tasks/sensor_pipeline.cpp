@@ -0,0 +1,33 @@
+#include "tasks/sensor_pipeline.h"
+
+#include "tasks/control_task.h"
+#include "tasks/touch_task.h"
+#include "tasks/trace_task.h"
+
+namespace tasks {
+namespace {
+
+static_assert(SensorPipeline::runsIn<ControlContext>(),
+              "a control_task precisa executar ao menos o atuador");
+
+// Tasks diferentes executam segmentos disjuntos: cada estágio é acessado
+// por uma única task e os canais são filas FreeRTOS
+SensorPipeline gSensorPipeline;
+
+}  // namespace
+
+SensorPipeline& sensorPipeline() {
+  return gSensorPipeline;
+}
+
+void startSensorPipeline(UBaseType_t touchPriority, UBaseType_t controlPriority,
+                         UBaseType_t innerLoopPriority) {
+  gSensorPipeline.init();
+  if (SensorPipeline::runsIn<TouchContext>()) {
+    startTouchTask(touchPriority);
+  }
+  startControlTask(controlPriority, innerLoopPriority);
+  startTraceTask(touchPriority);
+}
+
+}  // namespace tasks
@@ -4,6 +4,7 @@
 
 #include "tasks/stepper_command_task.h"
 #include "tasks/stepper_task.h"
+#include "tasks/system_events.h"
 
 namespace tasks {
 namespace {
@@ -17,6 +18,9 @@ constexpr TickType_t kDirectionSwapDelay = pdMS_TO_TICKS(5000);  // 5 segundos e
 void stepperCommandTask(void* /*params*/) {
   bool moveForward = true;
   StepperMessage msg{};
+
+  // Aguarda o atuador ficar pronto (fila criada, posição restaurada)
+  waitSystemReady(kStepperReadyBit);
   
   for (;;) {
     // Configura mensagem para movimento relativo
@@ -25,8 +29,9 @@ void stepperCommandTask(void* /*params*/) {
     msg.accelInStepsPerSecSec = kAccelStepsPerSecSec;
     msg.isRelative = true;  // Movimento relativo à posição atual
     
-    // Envia comando para o stepper task
-    sendStepperMessage(msg, portMAX_DELAY);
+    // Envia comando para o stepper task (caixa com fusão: não bloqueia e,
+    // se o movimento anterior ainda não começou, os dois são somados)
+    sendStepperMessage(msg, 0);
 
     // Aguarda antes de inverter direção
     vTaskDelay(kDirectionSwapDelay);
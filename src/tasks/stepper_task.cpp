@@ -1,82 +1,427 @@
 #include <Arduino.h>
+#include <stdio.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
-#include <ESP_FlexyStepper.h>
+#include <soc/gpio_struct.h>
 
 #include "tasks/stepper_task.h"
 #include "hal/board.h"
+#include "hal/clock.h"
+#include "hal/encoder.h"
+#include "hal/warm_state.h"
+#include "motion/speed_profile.h"
+#include "motion/step_generator.h"
+#include "motion/tracking_monitor.h"
+#include "tasks/channel.h"
+#include "tasks/system_events.h"
 
 namespace tasks {
 namespace {
 
-// Queue for stepper motor commands
-QueueHandle_t xStepperQueue = nullptr;
+static_assert(kMaxStepperAxes == motion::kMaxAxes, "Message and generator axis limits differ");
+static_assert(hal::kStepperAxisCount >= 1 && hal::kStepperAxisCount <= kMaxStepperAxes,
+              "hal::kStepperAxes must list 1..kMaxStepperAxes axes");
 
-// Maximum number of queued commands
-constexpr size_t kStepperQueueLength = 8;
+// Every step/dir/limit pin must live in the low GPIO bank (GPIO.out / GPIO.in).
+constexpr bool axisPinsInLowBank(size_t i = 0) {
+  return i >= hal::kStepperAxisCount ||
+         (hal::kStepperAxes[i].pulsePin < 32 && hal::kStepperAxes[i].directionPin < 32 &&
+          (hal::kStepperAxes[i].limitMinPin < 32 || hal::kStepperAxes[i].limitMinPin == hal::kNoPin) &&
+          (hal::kStepperAxes[i].limitMaxPin < 32 || hal::kStepperAxes[i].limitMaxPin == hal::kNoPin) &&
+          axisPinsInLowBank(i + 1));
+}
+static_assert(axisPinsInLowBank(), "Stepper step/dir/limit pins must be below GPIO32");
+
+// Move commands: a one-slot coalescing mailbox. A move that arrives while
+// another is still pending is folded into it (relative deltas add up, an
+// absolute target replaces), so a stale command never waits behind a fresh
+// one and senders never block.
+Channel<MultiAxisStepperMessage> gStepperChannel;
+constexpr const char* kStepperChannelName = "stepper";
+
+// Step tick: timer clocked at 1 MHz (kStepperTickHz and the minimum ramp
+// speed live in tasks/task_config.h, shared with sim/)
+constexpr uint16_t kTimerDivider = 80;
+
+// Speed planning (tasks/task_config.h, shared with sim/). Cruise speeds never
+// sit inside a band: queued moves and the cascade's velocity limit both go
+// through planStepperCruise(). Velocity-mode targets only get the ramp boost
+// (they are a closed-loop output, and snapping them to a band edge would
+// make the loop chatter).
+const motion::SpeedPlanner gSpeedPlanner(kStepperSpeedProfile);
+
+// Velocity-mode slew limit (Q32 per tick). Survives mode changes: only
+// setStepperVelocityAccel() changes it, and every startVelocity() reuses it.
+volatile uint32_t gVelocityAccelQ32 =
+    motion::stepsPerSecSecToQ32(kDefaultStepperVelocityAccel, kStepperTickHz);
+volatile float gVelocityAccel = kDefaultStepperVelocityAccel;  // Same value, steps/s²
+
+// Encoder supervision (axis 0): period, limits and what to do on a fault.
+//   Report  - latch the fault only
+//   Stop    - emergency stop
+//   Resync  - stop and adopt the measured position as the commanded one
+//   Disable - stop and de-energise the drivers
+// Report by default: stopping or resyncing is opt-in once the encoder is trusted.
+enum class FaultRecovery : uint8_t { Report, Stop, Resync, Disable };
+constexpr FaultRecovery kFaultRecovery = FaultRecovery::Report;
+constexpr TickType_t kSupervisionPeriod = pdMS_TO_TICKS(10);
+constexpr uint8_t kEncoderAxis = 0;
+
+// Lost steps come in whole electrical cycles (4 full steps); allow 2 full steps of slack
+constexpr motion::TrackingConfig kTrackingConfig = {
+    hal::kStepperStepsPerRev,
+    hal::kEncoderCountsPerRev,
+    2 * hal::kStepperMicrosteps,  // maxFollowingError
+    0,                            // stallMotionSteps
+    1,                            // confirmSamples: fault within one period
+};
+
+motion::TrackingMonitor gTracking(kTrackingConfig);
+volatile StepperFault gFault = StepperFault::None;
+volatile int32_t gFollowingError = 0;
+
+// Coordinated step generator shared by all axes
+motion::StepGenerator gGenerator;
+
+hw_timer_t* gStepTimer = nullptr;
+TaskHandle_t gStepperTaskHandle = nullptr;
+portMUX_TYPE gStepperMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Per-axis GPIO masks, precomputed from hal::kStepperAxes
+uint32_t gPulseBits[kMaxStepperAxes] = {};
+uint32_t gDirBits[kMaxStepperAxes] = {};
+uint32_t gLimitMinBits[kMaxStepperAxes] = {};
+uint32_t gLimitMaxBits[kMaxStepperAxes] = {};
+
+// Pulses raised on the previous tick (lowered on the next one)
+uint32_t gRaisedPulses = 0;
+
+// Axes whose DIR pin is currently LOW (negative direction); initBoard() drives all LOW
+uint8_t gAppliedNegativeMask = (1u << hal::kStepperAxisCount) - 1;
+
+// Axes whose last move was cut short by a limit switch
+volatile uint8_t gLimitHitMask = 0;
+
+// Boot instrumentation: hal::nowUs() time of the first pulse (0 = none yet)
+volatile int64_t gFirstStepUs = 0;
+
+// Message timestamp to move start (written by the stepper task only)
+control::LatencyStats gCommandLatency = {};
+
+// Axis state restored from RTC memory after a warm reset
+bool gWarmStart = false;
+
+// The RTC record is marked as moving (accessed under gStepperMux only)
+bool gWarmMoving = false;
+
+// A queued move is waiting for velocity mode to end: setStepperVelocity()
+// must not re-enter it in between (the move would starve behind the stream)
+volatile bool gMoveHandover = false;
+
+constexpr uint32_t pinBit(uint8_t pin) { return (pin == hal::kNoPin) ? 0 : (1u << pin); }
+
+void initAxisMasks() {
+  for (uint8_t i = 0; i < hal::kStepperAxisCount; ++i) {
+    gPulseBits[i] = pinBit(hal::kStepperAxes[i].pulsePin);
+    gDirBits[i] = pinBit(hal::kStepperAxes[i].directionPin);
+    gLimitMinBits[i] = pinBit(hal::kStepperAxes[i].limitMinPin);
+    gLimitMaxBits[i] = pinBit(hal::kStepperAxes[i].limitMaxPin);
+  }
+}
+
+// Collects the GPIO bits for the axes in mask.
+inline uint32_t IRAM_ATTR bitsFor(const uint32_t* table, uint8_t mask) {
+  uint32_t bits = 0;
+  for (uint8_t i = 0; i < hal::kStepperAxisCount; ++i) {
+    if (mask & (1u << i)) bits |= table[i];
+  }
+  return bits;
+}
+
+// Step timer ISR - one tick for every axis
+void IRAM_ATTR onStepTick() {
+  // Finish the pulses started on the previous tick
+  if (gRaisedPulses != 0) {
+    GPIO.out_w1tc = gRaisedPulses;
+    gRaisedPulses = 0;
+  }
+
+  portENTER_CRITICAL_ISR(&gStepperMux);
+
+  // Stop the whole coordinated move if an axis runs into its limit switch
+  const uint32_t inputs = GPIO.in;
+  const uint8_t active = gGenerator.busy() ? gGenerator.activeMask() : 0;
+  const uint8_t negative = gGenerator.negativeMask();
+  uint8_t blocked = 0;
+  for (uint8_t i = 0; i < hal::kStepperAxisCount; ++i) {
+    const uint8_t bit = static_cast<uint8_t>(1u << i);
+    if (!(active & bit)) continue;
+    const uint32_t limitBits = (negative & bit) ? gLimitMinBits[i] : gLimitMaxBits[i];
+    if (inputs & limitBits) blocked |= bit;
+  }
+  if (blocked != 0) {
+    gLimitHitMask = gLimitHitMask | blocked;
+    if (gGenerator.mode() == motion::StepGenerator::Mode::Velocity) {
+      gGenerator.haltAxes(blocked);  // Other axes keep streaming
+    } else {
+      gGenerator.stop();
+    }
+  }
+
+  const uint32_t bits = bitsFor(gPulseBits, gGenerator.tick());
+  const bool idle = !gGenerator.busy();
+
+  // DIR follows the generator (HIGH = positive); it changes at least one
+  // tick before the next pulse of that axis
+  const uint8_t negativeNow = gGenerator.negativeMask();
+  const uint8_t dirChanged = negativeNow ^ gAppliedNegativeMask;
+  gAppliedNegativeMask = negativeNow;
+
+  portEXIT_CRITICAL_ISR(&gStepperMux);
+
+  if (dirChanged != 0) {
+    GPIO.out_w1ts = bitsFor(gDirBits, dirChanged & ~negativeNow);
+    GPIO.out_w1tc = bitsFor(gDirBits, dirChanged & negativeNow);
+  }
+
+  if (bits != 0) {
+    GPIO.out_w1ts = bits;
+    gRaisedPulses = bits;
+    if (gFirstStepUs == 0) gFirstStepUs = hal::nowUs();
+  } else if (idle) {
+    // Move finished and last pulse lowered: park the timer, wake the task
+    timerAlarmDisable(gStepTimer);
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(gStepperTaskHandle, &woken);
+    if (woken == pdTRUE) portYIELD_FROM_ISR();
+  }
+}
+
+// Compares commanded and measured position and applies kFaultRecovery.
+void superviseTracking() {
+  if (!hal::isEncoderReady()) return;
+
+  const int64_t counts = hal::readEncoderCount();
+  const motion::TrackingFault fault = gTracking.update(gGenerator.position(kEncoderAxis), counts);
+  gFollowingError = gTracking.followingError();
+  if (fault == motion::TrackingFault::None) return;
+
+  gFault = (fault == motion::TrackingFault::Stall) ? StepperFault::Stall : StepperFault::LostSteps;
+  hal::storeWarmFault(static_cast<uint8_t>(gFault));
+
+  switch (kFaultRecovery) {
+    case FaultRecovery::Report:
+      break;
+    case FaultRecovery::Stop:
+      emergencyStopStepper();
+      break;
+    case FaultRecovery::Resync: {
+      emergencyStopStepper();
+      const int32_t measured = gTracking.measuredSteps(counts);
+      portENTER_CRITICAL(&gStepperMux);
+      gGenerator.setPosition(kEncoderAxis, measured);
+      portEXIT_CRITICAL(&gStepperMux);
+      gTracking.reset(measured, counts);
+      break;
+    }
+    case FaultRecovery::Disable:
+      emergencyStopStepper();
+      setStepperEnabled(false);
+      break;
+  }
+}
+
+// Marks the RTC record as moving before the first pulse of a move
+// (call with gStepperMux held, right where the generator is started).
+void markMovingLocked() {
+  if (gWarmMoving) return;
+  gWarmMoving = true;
+  hal::storeWarmMoving();
+}
+
+// Mirrors the axis positions into RTC memory for a warm restart. Once the
+// axes are at rest, the final positions and the cleared moving mark go
+// into one write, so the record never claims rest with a stale position.
+void persistAxisState() {
+  int32_t positions[kMaxStepperAxes] = {};
+  portENTER_CRITICAL(&gStepperMux);
+  for (uint8_t i = 0; i < hal::kStepperAxisCount; ++i) {
+    positions[i] = gGenerator.position(i);
+  }
+  const bool settled = gWarmMoving && !gGenerator.busy() && !gMoveHandover;
+  if (settled) {
+    gWarmMoving = false;
+    hal::storeWarmAtRest(positions, hal::kStepperAxisCount);
+  }
+  portEXIT_CRITICAL(&gStepperMux);
+
+  if (!settled) hal::storeWarmAxisPositions(positions, hal::kStepperAxisCount);
+}
+
+// Restores positions and fault after a warm reset (no re-homing needed).
+// A reset in the middle of a move leaves the position unknown: cold start.
+void restoreAxisState() {
+  hal::WarmState warm{};
+  if (!hal::restoreWarmState(warm) || warm.axisCount != hal::kStepperAxisCount) return;
+
+  gFault = static_cast<StepperFault>(warm.fault);
+  if (warm.velocityAccel > 0.0f) setStepperVelocityAccel(warm.velocityAccel);
+  if (warm.moving != 0) {
+    gWarmMoving = true;  // Cleared with the fresh positions by the first persistAxisState()
+    return;
+  }
+  for (uint8_t i = 0; i < hal::kStepperAxisCount; ++i) {
+    gGenerator.setPosition(i, warm.axisPositions[i]);
+  }
+  gWarmStart = true;
+}
+
+// Waits for the ISR completion notification, supervising while waiting.
+void waitForGenerator() {
+  while (ulTaskNotifyTake(pdTRUE, kSupervisionPeriod) == 0) {
+    superviseTracking();
+    persistAxisState();
+  }
+}
+
+// Folds newer into a still-pending move. Relative moves add per axis;
+// an absolute move replaces one it fully covers. An absolute move followed
+// by a relative one is offset only when the relative axes are all in it.
+// The merged move keeps the older timestamp: its latency counts from the
+// first command that has been waiting.
+bool mergeStepperMoves(MultiAxisStepperMessage& pending, const MultiAxisStepperMessage& newer) {
+  if (!newer.isRelative) {
+    if ((pending.axisMask & ~newer.axisMask) != 0) return false;
+    const hal::TimestampUs oldestUs = pending.timestampUs;
+    pending = newer;
+    pending.timestampUs = oldestUs;
+    return true;
+  }
+  if (!pending.isRelative && (newer.axisMask & ~pending.axisMask) != 0) return false;
+  for (uint8_t i = 0; i < kMaxStepperAxes; ++i) {
+    if (!(newer.axisMask & (1u << i))) continue;
+    const int32_t base = (pending.axisMask & (1u << i)) ? pending.targetPositions[i] : 0;
+    pending.targetPositions[i] = base + newer.targetPositions[i];
+  }
+  pending.axisMask |= newer.axisMask;
+  pending.speedInStepsPerSec = newer.speedInStepsPerSec;
+  pending.accelInStepsPerSecSec = newer.accelInStepsPerSecSec;
+  return true;
+}
 
-// ESP-FlexyStepper instance
-ESP_FlexyStepper stepper;
+bool createStepperChannel() {
+  return gStepperChannel.create(kStepperChannelName, ChannelPolicy::Coalesce, 1,
+                                mergeStepperMoves);
+}
+
+// Converts a message into a generator move and runs it to completion.
+void executeMove(const MultiAxisStepperMessage& msg) {
+  motion::LinearMove move{};
+  for (uint8_t i = 0; i < hal::kStepperAxisCount; ++i) {
+    if (!(msg.axisMask & (1u << i))) continue;
+    move.deltas[i] = msg.isRelative ? msg.targetPositions[i]
+                                    : msg.targetPositions[i] - gGenerator.position(i);
+  }
+  move.cruiseVelocityQ32 =
+      motion::stepsPerSecToQ32(planStepperCruise(msg.speedInStepsPerSec), kStepperTickHz);
+  move.accelQ32 = motion::stepsPerSecSecToQ32(msg.accelInStepsPerSecSec, kStepperTickHz);
+  move.minVelocityQ32 = motion::stepsPerSecToQ32(kStepperMinStepRate, kStepperTickHz);
+
+  // Queued moves pre-empt velocity mode: ramp the stream down first. The
+  // hand-over flag keeps setStepperVelocity() from restarting the stream
+  // between the ramp-down and the start of the move.
+  gMoveHandover = true;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, 0);  // Discard a stale completion
+
+    portENTER_CRITICAL(&gStepperMux);
+    const bool streaming = gGenerator.mode() == motion::StepGenerator::Mode::Velocity;
+    const bool started = !streaming && gGenerator.start(move);
+    if (started) markMovingLocked();  // Timer not armed yet: before the first pulse
+    if (streaming) {
+      gGenerator.requestVelocityStop();
+    } else {
+      gMoveHandover = false;  // Started (Linear owns the axes) or dropped
+      if (started) gLimitHitMask = gLimitHitMask & static_cast<uint8_t>(~gGenerator.activeMask());
+    }
+    portEXIT_CRITICAL(&gStepperMux);
+
+    if (started) break;
+    if (!streaming) return;  // Empty or zero-speed move: nothing to wait for
+    waitForGenerator();
+  }
+
+  // Enable only once the generator accepted the move, so a rejected move
+  // leaves the drivers as they were. The timer is still disarmed: DIR is
+  // set by the ISR on the first tick, and the first pulse comes many ticks
+  // later (well beyond the TB6600 setup time)
+  for (uint8_t i = 0; i < hal::kStepperAxisCount; ++i) {
+    if (move.deltas[i] != 0) digitalWrite(hal::kStepperAxes[i].enablePin, LOW);
+  }
+
+  timerWrite(gStepTimer, 0);
+  timerAlarmEnable(gStepTimer);
+
+  // Block until the ISR reports completion (or an emergency stop / limit)
+  waitForGenerator();
+}
 
 // Stepper task implementation - processes movement commands from queue
 void stepperTask(void* /*params*/) {
-  // Create the queue if not already created
-  if (xStepperQueue == nullptr) {
-    xStepperQueue = xQueueCreate(kStepperQueueLength, sizeof(StepperMessage));
-  }
-
-  // Configure stepper motor using ESP-FlexyStepper
-  stepper.connectToPins(hal::kStepperPulsePin, hal::kStepperDirectionPin);
-  
-  // Configure enable pin (TB6600: LOW = enabled, HIGH = disabled)
-  pinMode(hal::kStepperEnablePin, OUTPUT);
-  digitalWrite(hal::kStepperEnablePin, HIGH);  // Start disabled
-  
-  // Set default speed and acceleration (can be overridden by messages)
-  stepper.setSpeedInStepsPerSecond(500);
-  stepper.setAccelerationInStepsPerSecondPerSecond(200);
-  
-  StepperMessage msg;
+  // Create the mailbox if not already created
+  createStepperChannel();
+
+  gStepperTaskHandle = xTaskGetCurrentTaskHandle();
+  initAxisMasks();
+  gGenerator.configure(hal::kStepperAxisCount);
+  gSpeedPlanner.applyTo(gGenerator, kStepperTickHz);
+  restoreAxisState();
+
+  // Start with every driver disabled (TB6600: LOW = enabled, HIGH = disabled)
+  setStepperEnabled(false);
+
+  // Periodic step tick, armed only while a move is running
+  gStepTimer = timerBegin(hal::kStepperTimer, kTimerDivider, true);
+  timerAttachInterrupt(gStepTimer, onStepTick, true);
+  timerAlarmWrite(gStepTimer, kStepperTickPeriodUs, true);
+
+  // Optional closed-loop position feedback
+  if (hal::initEncoder()) {
+    gTracking.reset(gGenerator.position(kEncoderAxis), hal::readEncoderCount());
+  }
+
+  persistAxisState();
+  signalSystemReady(kStepperReadyBit);
+
+  MultiAxisStepperMessage msg;
+  bool bootTimeReported = false;
   for (;;) {
-    // Process stepper service (handles movement timing)
-    stepper.processMovement();
-    
-    // Check for new commands (non-blocking)
-    if (xStepperQueue != nullptr && xQueueReceive(xStepperQueue, &msg, 0) == pdTRUE) {
-      // Enable motor before movement
-      digitalWrite(hal::kStepperEnablePin, LOW);
-      
-      // Configure speed and acceleration
-      stepper.setSpeedInStepsPerSecond(msg.speedInStepsPerSec);
-      stepper.setAccelerationInStepsPerSecondPerSecond(msg.accelInStepsPerSecSec);
-      
-      // Execute movement (relative or absolute)
-      if (msg.isRelative) {
-        stepper.setTargetPositionRelativeInSteps(msg.targetPosition);
-      } else {
-        stepper.setTargetPositionInSteps(msg.targetPosition);
-      }
-      
-      // Wait for movement to complete
-      while (!stepper.motionComplete()) {
-        stepper.processMovement();
-        taskYIELD();  // Allow other tasks to run
-      }
-      
+    // Timeout keeps supervision running while idle or streaming velocity
+    if (gStepperChannel.receive(msg, kSupervisionPeriod)) {
+      const int64_t waitedUs = hal::nowUs() - msg.timestampUs;
+      gCommandLatency.record(waitedUs > 0 ? static_cast<uint32_t>(waitedUs) : 0u);
+      executeMove(msg);
+
       // Optional: disable motor after movement to save power
-      // digitalWrite(hal::kStepperEnablePin, HIGH);
+      // setStepperEnabled(false);
+    }
+    superviseTracking();
+    persistAxisState();
+
+    // One serial line per boot for the cold/warm boot-to-first-step figure
+    if (!bootTimeReported && gFirstStepUs != 0) {
+      printf("boot_to_first_step_us,%lld,%s\n", static_cast<long long>(gFirstStepUs),
+             gWarmStart ? "warm" : "cold");
+      bootTimeReported = true;
     }
-    
-    // Small delay to prevent tight loop and allow other tasks
-    vTaskDelay(pdMS_TO_TICKS(1));
   }
 }
 
 }  // namespace
 
 void startStepperTask(UBaseType_t priority) {
-  constexpr uint32_t kStackDepthWords = 4096;  // Increased for FlexyStepper
+  constexpr uint32_t kStackDepthWords = 4096;
   xTaskCreate(
       stepperTask,
       "stepper_motor",
@@ -86,26 +431,157 @@ void startStepperTask(UBaseType_t priority) {
       nullptr);
 }
 
+bool sendMultiAxisStepperMessage(const MultiAxisStepperMessage& msg, TickType_t ticksToWait) {
+  // Try to create the mailbox lazily if the task hasn't initialized it yet
+  if (!createStepperChannel()) return false;
+  if (msg.timestampUs != 0) return gStepperChannel.send(msg, ticksToWait);
+  MultiAxisStepperMessage stamped = msg;
+  stamped.timestampUs = hal::nowUs();
+  return gStepperChannel.send(stamped, ticksToWait);
+}
+
 bool sendStepperMessage(const StepperMessage& msg, TickType_t ticksToWait) {
-  if (xStepperQueue == nullptr) {
-    // Try to create queue lazily if task hasn't initialized it yet
-    xStepperQueue = xQueueCreate(kStepperQueueLength, sizeof(StepperMessage));
-    if (xStepperQueue == nullptr) return false;
-  }
-  return xQueueSend(xStepperQueue, &msg, ticksToWait) == pdTRUE;
+  MultiAxisStepperMessage multi{};
+  multi.targetPositions[0] = msg.targetPosition;
+  multi.axisMask = 0x01;
+  multi.speedInStepsPerSec = msg.speedInStepsPerSec;
+  multi.accelInStepsPerSecSec = msg.accelInStepsPerSecSec;
+  multi.isRelative = msg.isRelative;
+  multi.timestampUs = msg.timestampUs;
+  return sendMultiAxisStepperMessage(multi, ticksToWait);
+}
+
+control::LatencyStats getStepperCommandLatency() {
+  return gCommandLatency;
+}
+
+float planStepperCruise(float stepsPerSec) {
+  return gSpeedPlanner.planCruise(stepsPerSec);
 }
 
 int32_t getStepperPosition() {
-  return stepper.getCurrentPositionInSteps();
+  return gGenerator.position(0);
+}
+
+int32_t getStepperPosition(uint8_t axis) {
+  return gGenerator.position(axis);
+}
+
+int32_t getMeasuredStepperPosition() {
+  if (!hal::isEncoderReady()) return gGenerator.position(kEncoderAxis);
+  return gTracking.measuredSteps(hal::readEncoderCount());
+}
+
+int32_t getStepperFollowingError() {
+  return gFollowingError;
+}
+
+StepperFault getStepperFault() {
+  return gFault;
+}
+
+void clearStepperFault() {
+  gFault = StepperFault::None;
+  hal::storeWarmFault(static_cast<uint8_t>(StepperFault::None));
+}
+
+bool isStepperWarmStart() {
+  return gWarmStart;
+}
+
+int64_t getBootToFirstStepUs() {
+  return gFirstStepUs;
+}
+
+bool isStepperLimitHit(uint8_t axis) {
+  return axis < kMaxStepperAxes && (gLimitHitMask & (1u << axis)) != 0;
 }
 
 void emergencyStopStepper() {
-  stepper.emergencyStop();
+  portENTER_CRITICAL(&gStepperMux);
+  gGenerator.stop();  // The ISR parks the timer and releases the task on the next tick
+  portEXIT_CRITICAL(&gStepperMux);
+}
+
+bool setStepperVelocity(float stepsPerSec, uint8_t axis) {
+  if (axis >= hal::kStepperAxisCount || gStepTimer == nullptr) return false;
+  const int32_t target = motion::signedStepsPerSecToQ32(stepsPerSec, kStepperTickHz);
+
+  portENTER_CRITICAL(&gStepperMux);
+  bool entered = false;
+  bool accepted = true;
+  if (gMoveHandover || gGenerator.mode() == motion::StepGenerator::Mode::Linear) {
+    accepted = false;  // A queued position move owns (or is taking over) the axes
+  } else if (gGenerator.mode() == motion::StepGenerator::Mode::Idle) {
+    entered = gGenerator.startVelocity(gVelocityAccelQ32, kVelocityWatchdogTicks);
+    if (entered) markMovingLocked();
+  }
+  if (accepted) gGenerator.setTargetVelocity(axis, target);
+  portEXIT_CRITICAL(&gStepperMux);
+
+  if (entered) {
+    setStepperEnabled(true);
+    timerWrite(gStepTimer, 0);
+    timerAlarmEnable(gStepTimer);
+  }
+  return accepted;
+}
+
+void setStepperVelocityAccel(float accelStepsPerSecSec, bool persist) {
+  const uint32_t accel = motion::stepsPerSecSecToQ32(accelStepsPerSecSec, kStepperTickHz);
+  portENTER_CRITICAL(&gStepperMux);
+  gVelocityAccelQ32 = accel;
+  gVelocityAccel = accelStepsPerSecSec;
+  gGenerator.setVelocityAccel(accel);  // Applies now if already streaming
+  portEXIT_CRITICAL(&gStepperMux);
+  if (persist) hal::storeWarmVelocityAccel(accelStepsPerSecSec);
+}
+
+float getStepperVelocityAccel() {
+  return gVelocityAccel;
+}
+
+void stopStepperVelocity() {
+  gGenerator.requestVelocityStop();
 }
 
 void setStepperEnabled(bool enabled) {
   // TB6600: LOW = enabled, HIGH = disabled
-  digitalWrite(hal::kStepperEnablePin, enabled ? LOW : HIGH);
+  for (const hal::StepperAxisPins& axis : hal::kStepperAxes) {
+    digitalWrite(axis.enablePin, enabled ? LOW : HIGH);
+  }
+}
+
+StepRateReport measureAggregateStepRate(uint8_t axisCount, uint32_t ticks) {
+  if (axisCount == 0) axisCount = 1;
+  if (axisCount > kMaxStepperAxes) axisCount = kMaxStepperAxes;
+
+  // Diagonal move at the velocity ceiling: every axis steps on every carry
+  motion::StepGenerator scratch;
+  scratch.configure(axisCount);
+  motion::LinearMove move{};
+  for (uint8_t i = 0; i < axisCount; ++i) move.deltas[i] = INT32_MAX;
+  move.cruiseVelocityQ32 = motion::kMaxVelocityQ32;
+  move.accelQ32 = motion::kMaxVelocityQ32;
+  move.minVelocityQ32 = motion::kMaxVelocityQ32;
+  scratch.start(move);
+
+  volatile uint32_t sink = 0;  // Keeps the loop from being optimised away
+  const int64_t startUs = hal::nowUs();
+  for (uint32_t t = 0; t < ticks; ++t) {
+    const uint8_t mask = scratch.tick();
+    for (uint8_t i = 0; i < axisCount; ++i) {
+      if (mask & (1u << i)) sink = sink | gPulseBits[i] | (1u << i);
+    }
+  }
+  const int64_t elapsedUs = hal::nowUs() - startUs;
+
+  StepRateReport report{};
+  report.axisCount = axisCount;
+  report.nsPerTick = (ticks > 0) ? (elapsedUs * 1000.0f) / ticks : 0.0f;
+  report.maxTickHz = (report.nsPerTick > 0.0f) ? 1e9f / report.nsPerTick : 0.0f;
+  report.aggregateStepsPerSec = report.maxTickHz * 0.5f * axisCount;
+  return report;
 }
 
 }  // namespace tasks
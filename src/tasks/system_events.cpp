@@ -0,0 +1,36 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#include "tasks/system_events.h"
+
+namespace tasks {
+namespace {
+
+EventGroupHandle_t xSystemEvents = nullptr;
+
+}  // namespace
+
+void initSystemEvents() {
+  if (xSystemEvents == nullptr) {
+    xSystemEvents = xEventGroupCreate();
+  }
+}
+
+void signalSystemReady(EventBits_t bits) {
+  if (xSystemEvents != nullptr) {
+    xEventGroupSetBits(xSystemEvents, bits);
+  }
+}
+
+bool waitSystemReady(EventBits_t bits, TickType_t ticksToWait) {
+  if (xSystemEvents == nullptr) return false;
+  const EventBits_t set = xEventGroupWaitBits(xSystemEvents, bits, pdFALSE, pdTRUE, ticksToWait);
+  return (set & bits) == bits;
+}
+
+bool isSystemReady(EventBits_t bits) {
+  if (xSystemEvents == nullptr) return false;
+  return (xEventGroupGetBits(xSystemEvents) & bits) == bits;
+}
+
+}  // namespace tasks
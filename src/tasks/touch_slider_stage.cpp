@@ -0,0 +1,116 @@
+#include <freertos/FreeRTOS.h>
+
+#include "control/analog_setpoint.h"
+#include "control/touch_slider.h"
+#include "hal/touch_slider.h"
+#include "tasks/display_task.h"
+#include "tasks/sensor_pipeline.h"
+#include "tasks/trace_task.h"
+
+namespace tasks {
+
+// ============================================================================
+// ESTÁGIO DO SLIDER CAPACITIVO (FSM DE TOQUE + CENTROIDE)
+// ============================================================================
+//
+// Mesmo papel da TouchSensorStage (SENSOR no diagrama de blocos), com vários
+// pads: o hardware mede os pads sozinho e um timer guarda ~250 varreduras
+// por segundo com carimbo. Aqui, uma vez por período da malha externa, todas
+// passam pelo SliderTracker na ordem em que chegaram; o dt de cada uma é o
+// medido, então a velocidade do dedo não depende de quando o poll roda.
+//
+// Mensagem ao controlador (a mesma TouchInputMessage):
+//   - Toque/arrasto: intensity = posição (1..256), touchValue = posição em
+//     unidades do slider (256 por pad). Publicada no toque e quando muda
+//     mais que kSliderHysteresis; no arrasto, direction = sentido do dedo
+//     (no toque a lei escolhe, como nas outras fontes).
+//   - Swipe (soltar em movimento): intensity = velocidade do gesto (1..256),
+//     touchValue = velocidade com sinal (unidades/s), direction = sinal dela.
+//     É o jog: quanto mais rápido o gesto, maior o movimento que a lei
+//     comanda, no sentido do gesto.
+//   - Soltar parado não gera mensagem (como nas outras fontes).
+// ============================================================================
+
+bool TouchSliderStage::poll(TouchInputMessage& out) {
+  // Replay em curso: as entradas vêm do log
+  if (isTraceReplaying()) return false;
+
+  // -------------------------------------------------------------------------
+  // ETAPA 1: INICIALIZAÇÃO SOB DEMANDA DO FSM DE TOQUE
+  // -------------------------------------------------------------------------
+  if (!hal::isTouchSliderReady() && !hal::initTouchSlider()) return false;
+
+  // -------------------------------------------------------------------------
+  // ETAPA 2: PROCESSAR AS VARREDURAS ACUMULADAS (cada uma com seu carimbo)
+  // -------------------------------------------------------------------------
+  // Guarda o último gesto e a última posição; um gesto tem prioridade
+  hal::TouchSliderScan scan;
+  control::SliderReading reading;
+  control::SliderReading gesture = {0, 0, 0, false};
+  control::SliderReading latest = {0, 0, 0, false};
+  hal::TimestampUs gestureUs = 0;
+  hal::TimestampUs latestUs = 0;
+  bool swiped = false;
+  bool moved = false;
+  bool pressed = false;
+  while (hal::readTouchSliderScan(scan)) {
+    const control::SliderEvent event = tracker_.update(scan.raw, scan.timestampUs, reading);
+    if (event == control::SliderEvent::Swipe) {
+      gesture = reading;
+      gestureUs = scan.timestampUs;
+      swiped = true;
+    } else if (event == control::SliderEvent::Press || event == control::SliderEvent::Move) {
+      latest = reading;
+      latestUs = scan.timestampUs;
+      moved = true;
+      pressed = pressed || event == control::SliderEvent::Press;
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // ETAPA 3: FEEDBACK VISUAL NO DISPLAY (zona equivalente à do toque)
+  // -------------------------------------------------------------------------
+  const control::SliderReading& now = tracker_.reading();
+  const uint8_t zone =
+      now.touched ? control::intensityZone(tracker_.positionIntensity(now.position)) : 0;
+  if (zone != lastZone_) {
+    DisplayMessage displayMsg;
+    displayMsg.cmd = DisplayCmd::WriteChar;
+    displayMsg.col = 3;
+    displayMsg.row = 0;
+    displayMsg.c = '0' + zone;
+    sendDisplayMessage(displayMsg, 0);
+    lastZone_ = zone;
+  }
+
+  // -------------------------------------------------------------------------
+  // ETAPA 4: MENSAGEM AO CONTROLADOR
+  // -------------------------------------------------------------------------
+  if (swiped) {
+    // Jog: a intensidade vem da velocidade do gesto; o próximo toque publica
+    out.touchValue = gesture.velocity;
+    out.intensity = control::SliderTracker::swipeIntensity(gesture.velocity);
+    out.direction = (gesture.velocity < 0) ? -1 : 1;
+    out.touchZone = control::intensityZone(out.intensity);
+    out.timestampUs = gestureUs;
+    published_ = 0;
+    return true;
+  }
+  if (!moved) return false;
+
+  const uint16_t intensity = tracker_.positionIntensity(latest.position);
+  const int32_t delta = static_cast<int32_t>(intensity) - static_cast<int32_t>(published_);
+  if (!pressed && delta <= control::kSliderHysteresis &&
+      delta >= -static_cast<int32_t>(control::kSliderHysteresis)) {
+    return false;
+  }
+  published_ = intensity;
+  out.touchValue = latest.position;  // Unidades do slider (256 por pad)
+  out.intensity = intensity;         // Variável de escalonamento
+  out.direction = pressed ? 0 : (delta < 0) ? -1 : 1;
+  out.touchZone = control::intensityZone(intensity);
+  out.timestampUs = latestUs;        // Varredura que trouxe a posição
+  return true;
+}
+
+}  // namespace tasks
@@ -0,0 +1,397 @@
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#include <atomic>
+
+#include "control/cascade.h"
+#include "control/trace_codec.h"
+#include "hal/clock.h"
+#include "tasks/trace_task.h"
+
+namespace tasks {
+namespace {
+
+// ============================================================================
+// CONFIGURAÇÃO
+// ============================================================================
+
+// Registros enfileirados pela control_task até a gravação na flash
+constexpr size_t kRecordQueueLength = 32;
+
+// Escrita na LittleFS em blocos (uma escrita por ~50 registros)
+constexpr size_t kWriteChunkBytes = 256;
+
+// Maior log aceito para replay (carregado inteiro na RAM)
+constexpr size_t kMaxReplayBytes = 32 * 1024;
+
+constexpr size_t kPathLength = 32;
+constexpr TickType_t kPumpTimeout = pdMS_TO_TICKS(50);
+constexpr TickType_t kSessionStartTimeout = pdMS_TO_TICKS(1000);
+constexpr TickType_t kReplayDrainTimeout = pdMS_TO_TICKS(5000);
+constexpr TickType_t kControlPeriodTicks =
+    pdMS_TO_TICKS(control::kControlRates.outerPeriodUs() / 1000);
+
+enum class CommandKind : uint8_t { Record, Replay };
+
+struct TraceCommand {
+  CommandKind kind;
+  uint16_t speed;
+  char path[kPathLength];
+};
+
+QueueHandle_t gCommandQueue = nullptr;
+QueueHandle_t gRecordQueue = nullptr;
+
+std::atomic<uint8_t> gMode{static_cast<uint8_t>(TraceMode::Idle)};
+std::atomic<bool> gSessionPending{false};
+std::atomic<bool> gSessionActive{false};
+std::atomic<bool> gStopRequest{false};
+std::atomic<uint32_t> gSessionInputs{0};
+std::atomic<uint32_t> gDropped{0};
+std::atomic<uint32_t> gRecords{0};
+std::atomic<uint32_t> gBytes{0};
+std::atomic<bool> gLastReplayIdentical{false};
+std::atomic<uint32_t> gLastReplayMatched{0};
+
+// Unidade do carimbo no log da sessão (Hz). Gravação nova: 1 MHz (µs de
+// hal/clock.h); replay: a do log, para que as entradas regravadas saiam
+// idênticas mesmo de logs antigos em ticks do RTOS
+std::atomic<uint32_t> gSessionTickHz{1000000};
+
+
+// ============================================================================
+// ESCRITA DO LOG
+// ============================================================================
+
+class TraceWriter {
+ public:
+  bool open(const char* path, uint32_t tickHz) {
+    file_ = LittleFS.open(path, FILE_WRITE);
+    if (!file_) return false;
+    used_ = encoder_.begin(chunk_, tickHz);
+    records_ = 0;
+    bytes_ = 0;
+    return true;
+  }
+
+  void add(const control::TraceRecord& record) {
+    if (used_ + control::kTraceMaxRecordBytes > kWriteChunkBytes) flush();
+    used_ += encoder_.write(record, chunk_ + used_);
+    ++records_;
+    gRecords.store(records_, std::memory_order_relaxed);
+  }
+
+  void close() {
+    flush();
+    file_.close();
+  }
+
+  uint32_t records() const { return records_; }
+  uint32_t bytes() const { return bytes_; }
+
+ private:
+  void flush() {
+    if (used_ == 0) return;
+    bytes_ += file_.write(chunk_, used_);
+    used_ = 0;
+    gBytes.store(bytes_, std::memory_order_relaxed);
+  }
+
+  fs::File file_;
+  control::TraceEncoder encoder_;
+  uint8_t chunk_[kWriteChunkBytes];
+  size_t used_ = 0;
+  uint32_t records_ = 0;
+  uint32_t bytes_ = 0;
+};
+
+// Retira os registros pendentes e grava; espera até wait pelo primeiro
+void pumpRecords(TraceWriter& writer, TickType_t wait) {
+  control::TraceRecord record;
+  while (xQueueReceive(gRecordQueue, &record, wait) == pdTRUE) {
+    writer.add(record);
+    wait = 0;
+  }
+}
+
+// Lê o arquivo inteiro para a RAM (liberar com free)
+uint8_t* loadFile(const char* path, size_t& size) {
+  fs::File file = LittleFS.open(path, FILE_READ);
+  if (!file) return nullptr;
+  size = file.size();
+  uint8_t* data = (size > 0 && size <= kMaxReplayBytes) ? static_cast<uint8_t*>(malloc(size)) : nullptr;
+  if (data != nullptr && file.read(data, size) != size) {
+    free(data);
+    data = nullptr;
+  }
+  file.close();
+  return data;
+}
+
+
+// ============================================================================
+// SESSÕES
+// ============================================================================
+
+// Pede à control_task que reinicie a lei e comece a entregar registros
+bool beginSession(TraceMode mode) {
+  xQueueReset(gRecordQueue);
+  gSessionInputs.store(0);
+  gDropped.store(0);
+  gRecords.store(0);
+  gBytes.store(0);
+  gMode.store(static_cast<uint8_t>(mode));
+  gSessionPending.store(true);
+
+  const TickType_t start = xTaskGetTickCount();
+  while (gSessionPending.load() && xTaskGetTickCount() - start < kSessionStartTimeout) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  if (!gSessionPending.exchange(false)) return true;
+
+  // control_task não está rodando
+  gMode.store(static_cast<uint8_t>(TraceMode::Idle));
+  return false;
+}
+
+void endSession(TraceWriter& writer) {
+  gSessionActive.store(false);
+  pumpRecords(writer, 0);
+  writer.close();
+  gMode.store(static_cast<uint8_t>(TraceMode::Idle));
+}
+
+void recordSession(const char* path) {
+  TraceWriter writer;
+  gSessionTickHz.store(static_cast<uint32_t>(hal::kMicrosPerSecond));
+  if (!writer.open(path, gSessionTickHz.load())) {
+    printf("trace,record,%s,open failed\n", path);
+    return;
+  }
+  if (!beginSession(TraceMode::Recording)) {
+    writer.close();
+    printf("trace,record,%s,control task not running\n", path);
+    return;
+  }
+
+  while (!gStopRequest.load()) {
+    pumpRecords(writer, kPumpTimeout);
+  }
+  endSession(writer);
+  printf("trace,record,%s,%u records,%u bytes,%u dropped\n", path,
+         static_cast<unsigned>(writer.records()), static_cast<unsigned>(writer.bytes()),
+         static_cast<unsigned>(gDropped.load()));
+}
+
+void replaySession(const char* path, uint16_t speed) {
+  size_t recordedSize = 0;
+  uint8_t* recorded = loadFile(path, recordedSize);
+  if (recorded == nullptr) {
+    printf("trace,replay,%s,unreadable or larger than %u bytes\n", path,
+           static_cast<unsigned>(kMaxReplayBytes));
+    return;
+  }
+  control::TraceDecoder decoder(recorded, recordedSize);
+  TraceWriter writer;
+  if (!decoder.valid() || decoder.tickHz() == 0 ||
+      !writer.open(kReplayOutputPath, decoder.tickHz())) {
+    free(recorded);
+    printf("trace,replay,%s,invalid trace\n", path);
+    return;
+  }
+  gSessionTickHz.store(decoder.tickHz());
+  if (!beginSession(TraceMode::Replaying)) {
+    writer.close();
+    free(recorded);
+    printf("trace,replay,%s,control task not running\n", path);
+    return;
+  }
+
+  // Entradas no instante gravado, escalado por speed, pela mesma fila que
+  // qualquer produtor externo usa
+  const TickType_t start = xTaskGetTickCount();
+  uint32_t firstTick = 0;
+  uint32_t lastTick = 0;
+  uint64_t elapsedTicks = 0;
+  uint32_t sent = 0;
+  control::TraceRecord record;
+  while (!gStopRequest.load() && decoder.next(record)) {
+    if (record.kind != control::TraceRecordKind::Input) continue;  // Saídas são recalculadas
+    if (sent == 0) firstTick = record.input.tick;
+
+    if (speed > 0) {
+      const uint64_t offset = static_cast<uint64_t>(record.input.tick - firstTick) *
+                              configTICK_RATE_HZ / (static_cast<uint64_t>(decoder.tickHz()) * speed);
+      const TickType_t due = start + static_cast<TickType_t>(offset);
+      for (;;) {
+        const int32_t remaining = static_cast<int32_t>(due - xTaskGetTickCount());
+        if (remaining <= 0 || gStopRequest.load()) break;
+        pumpRecords(writer, (remaining < static_cast<int32_t>(kPumpTimeout)) ? remaining : kPumpTimeout);
+      }
+    }
+
+    TouchInputMessage msg;
+    msg.touchValue = record.input.touchValue;
+    msg.touchZone = record.input.touchZone;
+    msg.intensity = record.input.intensity;
+    msg.direction = record.input.direction;
+    // Carimbo gravado em µs: o tick de 32 bits dá a volta, então acumula as
+    // diferenças; arredondado para cima, traceInput volta ao mesmo tick
+    elapsedTicks += record.input.tick - lastTick;
+    lastTick = record.input.tick;
+    msg.timestampUs = static_cast<hal::TimestampUs>(
+        (elapsedTicks * hal::kMicrosPerSecond + decoder.tickHz() - 1) / decoder.tickHz());
+    // Fila cheia: espera um período do controlador por vez, gravando o
+    // que ele produz entretanto (cada tentativa vencida conta como descarte
+    // no canal "touch_input")
+    while (!gStopRequest.load() && !sendTouchInputMessage(msg, kControlPeriodTicks)) {
+      pumpRecords(writer, 0);
+    }
+    ++sent;
+    pumpRecords(writer, 0);
+  }
+
+  // Aguarda a control_task processar o que ainda está na fila; as saídas
+  // de uma entrada são geradas no mesmo período
+  const TickType_t drainStart = xTaskGetTickCount();
+  while (!gStopRequest.load() && gSessionInputs.load() < sent &&
+         xTaskGetTickCount() - drainStart < kReplayDrainTimeout) {
+    pumpRecords(writer, kPumpTimeout);
+  }
+  vTaskDelay(kControlPeriodTicks);
+  endSession(writer);
+  free(recorded);
+
+  // Comparação registro a registro com o log original
+  size_t replayedSize = 0;
+  uint8_t* replayed = loadFile(kReplayOutputPath, replayedSize);
+  recorded = loadFile(path, recordedSize);
+  control::TraceDiff diff = {false, 0, 0, 0, 0, 0};
+  if (recorded != nullptr && replayed != nullptr) {
+    diff = control::diffTraces(recorded, recordedSize, replayed, replayedSize);
+  }
+  free(recorded);
+  free(replayed);
+
+  gLastReplayIdentical.store(diff.identical);
+  gLastReplayMatched.store(diff.records);
+  printf("trace,replay,%s,%s,%u records,%u inputs,%u outputs,offset %u/%u\n", path,
+         diff.identical ? "identical" : "MISMATCH", static_cast<unsigned>(diff.records),
+         static_cast<unsigned>(diff.inputs), static_cast<unsigned>(diff.outputs),
+         static_cast<unsigned>(diff.expectedOffset), static_cast<unsigned>(diff.actualOffset));
+}
+
+void traceTask(void* /*params*/) {
+  // Formata a partição na primeira vez
+  const bool mounted = LittleFS.begin(true);
+  if (!mounted) printf("trace,littlefs mount failed\n");
+
+  TraceCommand command;
+  for (;;) {
+    if (xQueueReceive(gCommandQueue, &command, portMAX_DELAY) != pdTRUE) continue;
+    if (!mounted) continue;
+    gStopRequest.store(false);
+    if (command.kind == CommandKind::Record) {
+      recordSession(command.path);
+    } else {
+      replaySession(command.path, command.speed);
+    }
+  }
+}
+
+bool sendCommand(CommandKind kind, const char* path, uint16_t speed) {
+  if (gCommandQueue == nullptr || path == nullptr || strlen(path) >= kPathLength) return false;
+  if (gMode.load() != static_cast<uint8_t>(TraceMode::Idle)) return false;
+  TraceCommand command;
+  command.kind = kind;
+  command.speed = speed;
+  strncpy(command.path, path, kPathLength);
+  return xQueueSend(gCommandQueue, &command, 0) == pdTRUE;
+}
+
+}  // namespace
+
+
+// ============================================================================
+// INTERFACE PÚBLICA
+// ============================================================================
+
+void startTraceTask(UBaseType_t priority) {
+  if (gCommandQueue != nullptr) return;
+  gCommandQueue = xQueueCreate(1, sizeof(TraceCommand));
+  gRecordQueue = xQueueCreate(kRecordQueueLength, sizeof(control::TraceRecord));
+
+  constexpr uint32_t kStackDepthWords = 4096;  // LittleFS + printf
+  xTaskCreate(traceTask, "trace_task", kStackDepthWords, nullptr, priority, nullptr);
+}
+
+bool startTraceRecording(const char* path) {
+  return sendCommand(CommandKind::Record, path, 0);
+}
+
+bool startTraceReplay(const char* path, uint16_t speed) {
+  return sendCommand(CommandKind::Replay, path, speed);
+}
+
+void stopTrace() {
+  gStopRequest.store(true);
+}
+
+TraceStatus getTraceStatus() {
+  TraceStatus status;
+  status.mode = static_cast<TraceMode>(gMode.load());
+  status.records = gRecords.load();
+  status.bytes = gBytes.load();
+  status.dropped = gDropped.load();
+  status.lastReplayIdentical = gLastReplayIdentical.load();
+  status.lastReplayMatched = gLastReplayMatched.load();
+  return status;
+}
+
+bool traceSessionPending() {
+  return gSessionPending.load(std::memory_order_acquire);
+}
+
+void traceSessionBegin() {
+  // Ordem: ativa antes de liberar quem espera o início
+  gSessionActive.store(true);
+  gSessionPending.store(false);
+}
+
+void traceInput(const TouchInputMessage& msg) {
+  if (!gSessionActive.load(std::memory_order_relaxed)) return;
+  control::TraceRecord record = {};
+  record.kind = control::TraceRecordKind::Input;
+  // Carimbo na unidade da sessão; só os 32 bits baixos (o codec grava diferenças)
+  record.input.tick = static_cast<uint32_t>(
+      static_cast<uint64_t>(msg.timestampUs) * gSessionTickHz.load(std::memory_order_relaxed) /
+      hal::kMicrosPerSecond);
+  record.input.touchValue = msg.touchValue;
+  record.input.touchZone = msg.touchZone;
+  record.input.intensity = msg.intensity;
+  record.input.direction = msg.direction;
+  if (xQueueSend(gRecordQueue, &record, 0) != pdTRUE) gDropped.fetch_add(1);
+  gSessionInputs.fetch_add(1);
+}
+
+void traceOutput(const control::MotorCommand& command) {
+  if (!gSessionActive.load(std::memory_order_relaxed)) return;
+  control::TraceRecord record = {};
+  record.kind = control::TraceRecordKind::Output;
+  record.output.steps = command.steps;
+  record.output.speedInStepsPerSec = command.speedInStepsPerSec;
+  if (xQueueSend(gRecordQueue, &record, 0) != pdTRUE) gDropped.fetch_add(1);
+}
+
+bool isTraceReplaying() {
+  return gMode.load(std::memory_order_relaxed) == static_cast<uint8_t>(TraceMode::Replaying);
+}
+
+}  // namespace tasks
@@ -0,0 +1,424 @@
+#!/usr/bin/env python3
+"""Gera a tabela do MPC explícito da malha interna (include/control/mpc_table.h).
+
+Sem dependências além da biblioteca padrão: o QP é pequeno (uma aceleração
+por bloco do horizonte) e o estado tem duas dimensões, então tudo cabe em
+eliminação de Gauss e geometria de polígonos.
+
+Modelo (unidades normalizadas: e/E, v/V, a/A):
+    estado  x = (erro de posição, velocidade comandada)
+    entrada a_k constante durante o bloco k (duração T_k)
+    v_{k+1} = v_k + a_k T_k
+    e_{k+1} = e_k + v_k T_k + a_k T_k^2 / 2
+    |a_k| <= A,  |v_{k+1}| <= V
+
+Custo: soma de (qe e^2 + qv v^2) T_k sobre o horizonte, mais r a_k^2 T_k e
+um peso terminal. Para cada ponto de uma grade do estado o QP é resolvido
+por conjunto ativo; cada conjunto ativo distinto define uma região
+poliédrica com lei afim a_0 = F x + g (mp-QP). Depois cada faceta das
+regiões encontradas é atravessada para achar as que a grade não pegou. As
+regiões são recortadas na caixa |x| <= 1, as restrições redundantes
+descartadas e o resultado gravado em ponto fixo.
+
+Uso: python3 tools/mpc_generate.py [--out include/control/mpc_table.h]
+"""
+
+import argparse
+import sys
+
+
+# ----------------------------------------------------------------------------
+# Álgebra linear mínima
+# ----------------------------------------------------------------------------
+
+def solve(matrix, rhs_columns):
+    """Resolve M X = B (B com várias colunas) por Gauss com pivotamento."""
+    n = len(matrix)
+    cols = len(rhs_columns)
+    a = [list(matrix[i]) + [rhs_columns[c][i] for c in range(cols)] for i in range(n)]
+    for col in range(n):
+        pivot = max(range(col, n), key=lambda r: abs(a[r][col]))
+        if abs(a[pivot][col]) < 1e-12:
+            return None
+        a[col], a[pivot] = a[pivot], a[col]
+        for r in range(n):
+            if r != col and a[r][col] != 0.0:
+                factor = a[r][col] / a[col][col]
+                for c in range(col, n + cols):
+                    a[r][c] -= factor * a[col][c]
+    return [[a[i][n + c] / a[i][i] for i in range(n)] for c in range(cols)]
+
+
+def dot(u, v):
+    return sum(x * y for x, y in zip(u, v))
+
+
+# ----------------------------------------------------------------------------
+# Formulação do QP: J = 1/2 z'Hz + (Fx x)'z,  G z <= w + S x
+# ----------------------------------------------------------------------------
+
+class Problem:
+    def __init__(self, blocks, vmax, amax, erange, qe, qv, r, terminal):
+        self.blocks = blocks
+        n = len(blocks)
+        self.n = n
+        # Coeficientes lineares de cada grandeza prevista sobre [e0, v0, a0..a_{n-1}]
+        size = 2 + n
+        e = [1.0, 0.0] + [0.0] * n
+        v = [0.0, 1.0] + [0.0] * n
+        ka = amax / vmax   # a normalizada -> v normalizada por segundo
+        kv = vmax / erange  # v normalizada -> e normalizada por segundo
+        ke = amax / erange
+        hess = [[0.0] * n for _ in range(n)]
+        cross = [[0.0] * 2 for _ in range(n)]
+        vrows = []
+
+        def add_cost(coeffs, weight):
+            xs = coeffs[:2]
+            zs = coeffs[2:]
+            for i in range(n):
+                for j in range(n):
+                    hess[i][j] += 2.0 * weight * zs[i] * zs[j]
+                for j in range(2):
+                    cross[i][j] += 2.0 * weight * zs[i] * xs[j]
+
+        for k, t in enumerate(blocks):
+            new_e = [e[i] + kv * t * v[i] for i in range(size)]
+            new_e[2 + k] += 0.5 * ke * t * t
+            new_v = list(v)
+            new_v[2 + k] += ka * t
+            e, v = new_e, new_v
+            add_cost(e, qe * t)
+            add_cost(v, qv * t)
+            effort = [0.0] * size
+            effort[2 + k] = 1.0
+            add_cost(effort, r * t)
+            vrows.append(list(v))
+        add_cost(e, terminal)
+        add_cost(v, terminal)
+
+        self.H = hess
+        self.Fx = cross  # gradiente linear = Fx x
+        # Restrições: |a_k| <= 1 e |v_{k+1}| <= 1
+        G, w, S = [], [], []
+        for k in range(n):
+            row = [0.0] * n
+            row[k] = 1.0
+            G.append(row)
+            w.append(1.0)
+            S.append([0.0, 0.0])
+            G.append([-c for c in row])
+            w.append(1.0)
+            S.append([0.0, 0.0])
+        for coeffs in vrows:
+            zs = coeffs[2:]
+            G.append(list(zs))
+            w.append(1.0)
+            S.append([-coeffs[0], -coeffs[1]])
+            G.append([-c for c in zs])
+            w.append(1.0)
+            S.append([coeffs[0], coeffs[1]])
+        self.G, self.w, self.S = G, w, S
+
+    def gradient_offset(self, x):
+        return [dot(self.Fx[i], x) for i in range(self.n)]
+
+    def bounds(self, x):
+        return [self.w[i] + dot(self.S[i], x) for i in range(len(self.G))]
+
+    def solve_qp(self, x):
+        """Conjunto ativo primal a partir de z = 0 (sempre viável com |v0| <= 1)."""
+        n = self.n
+        f = self.gradient_offset(x)
+        w = self.bounds(x)
+        z = [0.0] * n
+        active = []
+        for _ in range(200):
+            g = [dot(self.H[i], z) + f[i] for i in range(n)]
+            m = len(active)
+            kkt = [self.H[i] + [self.G[j][i] for j in active] for i in range(n)]
+            kkt += [self.G[j] + [0.0] * m for j in active]
+            sol = solve(kkt, [[-gi for gi in g] + [0.0] * m])
+            if sol is None:
+                raise RuntimeError("KKT singular")
+            p = sol[0][:n]
+            lam = sol[0][n:]
+            if max(abs(pi) for pi in p) < 1e-10:
+                if not lam or min(lam) >= -1e-10:
+                    return z, sorted(active)
+                active.pop(lam.index(min(lam)))
+                continue
+            alpha, blocking = 1.0, None
+            for i in range(len(self.G)):
+                if i in active:
+                    continue
+                gp = dot(self.G[i], p)
+                if gp > 1e-12:
+                    step = (w[i] - dot(self.G[i], z)) / gp
+                    if step < alpha:
+                        alpha, blocking = max(step, 0.0), i
+            z = [z[i] + alpha * p[i] for i in range(n)]
+            if blocking is not None:
+                active.append(blocking)
+        raise RuntimeError("QP não convergiu")
+
+    def explicit_law(self, active):
+        """z(x) = Z0 + Zx x, lambda(x) = L0 + Lx x para um conjunto ativo."""
+        n = self.n
+        m = len(active)
+        kkt = [self.H[i] + [self.G[j][i] for j in active] for i in range(n)]
+        kkt += [self.G[j] + [0.0] * m for j in active]
+        rhs_const = [0.0] * n + [self.w[j] for j in active]
+        rhs_x = []
+        for c in range(2):
+            rhs_x.append([-self.Fx[i][c] for i in range(n)] + [self.S[j][c] for j in active])
+        sol = solve(kkt, [rhs_const] + rhs_x)
+        if sol is None:
+            return None
+        const, col0, col1 = sol
+        z0 = const[:n]
+        zx = [[col0[i], col1[i]] for i in range(n)]
+        l0 = const[n:]
+        lx = [[col0[n + j], col1[n + j]] for j in range(m)]
+        return z0, zx, l0, lx
+
+    def region(self, active):
+        law = self.explicit_law(active)
+        if law is None:
+            return None
+        z0, zx, l0, lx = law
+        halfspaces = []
+        for i in range(len(self.G)):
+            if i in active:
+                continue
+            gi = self.G[i]
+            h = [sum(gi[k] * zx[k][c] for k in range(self.n)) - self.S[i][c] for c in range(2)]
+            halfspaces.append((h, self.w[i] - dot(gi, z0)))
+        for j in range(len(active)):
+            halfspaces.append(([-lx[j][0], -lx[j][1]], l0[j]))
+        return z0, zx, halfspaces
+
+
+# ----------------------------------------------------------------------------
+# Geometria 2D: recorte da caixa e remoção de restrições redundantes
+# ----------------------------------------------------------------------------
+
+BOX = [(-1.0, -1.0), (1.0, -1.0), (1.0, 1.0), (-1.0, 1.0)]
+
+
+def clip(polygon, h, k):
+    out = []
+    for i, p in enumerate(polygon):
+        q = polygon[(i + 1) % len(polygon)]
+        dp = h[0] * p[0] + h[1] * p[1] - k
+        dq = h[0] * q[0] + h[1] * q[1] - k
+        if dp <= 0.0:
+            out.append(p)
+        if (dp < 0.0 < dq) or (dq < 0.0 < dp):
+            t = dp / (dp - dq)
+            out.append((p[0] + t * (q[0] - p[0]), p[1] + t * (q[1] - p[1])))
+    return out
+
+
+def area(polygon):
+    s = 0.0
+    for i, p in enumerate(polygon):
+        q = polygon[(i + 1) % len(polygon)]
+        s += p[0] * q[1] - q[0] * p[1]
+    return 0.5 * abs(s)
+
+
+def normalize(h, k):
+    scale = max(abs(h[0]), abs(h[1]))
+    if scale < 1e-12:
+        return None
+    return [h[0] / scale, h[1] / scale], k / scale
+
+
+def polygon_and_facets(halfspaces):
+    polygon = list(BOX)
+    cleaned = []
+    for h, k in halfspaces:
+        normalized = normalize(h, k)
+        if normalized is None:
+            if k < -1e-9:
+                return [], []  # 0 <= k falso: região vazia
+            continue
+        cleaned.append(normalized)
+        polygon = clip(polygon, *normalized)
+        if not polygon:
+            return [], []
+    # Só as restrições que contêm uma aresta do polígono
+    facets = []
+    for h, k in cleaned:
+        on = [abs(h[0] * p[0] + h[1] * p[1] - k) < 1e-7 for p in polygon]
+        edge = any(on[i] and on[(i + 1) % len(on)] for i in range(len(on)))
+        if edge and all(abs(h[0] - f[0][0]) + abs(h[1] - f[0][1]) + abs(k - f[1]) > 1e-9
+                        for f in facets):
+            facets.append((h, k))
+    return polygon, facets
+
+
+# ----------------------------------------------------------------------------
+# Ponto fixo e emissão do cabeçalho
+# ----------------------------------------------------------------------------
+
+Q_STATE = 15   # x normalizado em Q15
+Q_PLANE = 14   # h em Q14 -> h.x em Q29
+Q_GAIN = 16    # ganhos da lei em Q16
+
+
+def fixed(value, q, limit):
+    scaled = int(round(value * (1 << q)))
+    return max(-limit, min(limit, scaled))
+
+
+def evaluate_table(regions, x):
+    """Mesma busca do dispositivo, em ponto flutuante (verificação)."""
+    best, best_violation = None, None
+    for region in regions:
+        violation = max((h[0] * x[0] + h[1] * x[1] - k for h, k in region["facets"]),
+                        default=-1.0)
+        if violation <= 1e-9:
+            return region
+        if best_violation is None or violation < best_violation:
+            best, best_violation = region, violation
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--out", default="include/control/mpc_table.h")
+    parser.add_argument("--vmax", type=float, default=2000.0, help="passos/s")
+    parser.add_argument("--amax", type=float, default=1600.0, help="passos/s^2")
+    parser.add_argument("--range", type=float, default=4000.0, dest="erange",
+                        help="erro de posição coberto (passos); além disso satura")
+    parser.add_argument("--blocks", default="0.04,0.08,0.16,0.32,0.65",
+                        help="durações dos blocos do horizonte (s)")
+    parser.add_argument("--qe", type=float, default=1.0)
+    parser.add_argument("--qv", type=float, default=0.002,
+                        help="peso da velocidade: amortece a chegada (ajustado no sim/)")
+    parser.add_argument("--r", type=float, default=3e-6,
+                        help="peso do esforço; maior deixa a resposta lenta")
+    parser.add_argument("--terminal", type=float, default=2.0)
+    parser.add_argument("--grid", type=int, default=81, help="pontos por eixo da amostragem")
+    args = parser.parse_args()
+
+    blocks = [float(b) for b in args.blocks.split(",")]
+    problem = Problem(blocks, args.vmax, args.amax, args.erange, args.qe, args.qv, args.r,
+                      args.terminal)
+
+    # Amostragem do espaço de estados: um QP por ponto, um conjunto ativo por região
+    grid = [-1.0 + 2.0 * i / (args.grid - 1) for i in range(args.grid)]
+    samples = []
+    active_sets = {}
+    for e in grid:
+        for v in grid:
+            z, active = problem.solve_qp([e, v])
+            key = tuple(active)
+            active_sets[key] = active_sets.get(key, 0) + 1
+            samples.append(([e, v], z[0]))
+
+    # Exploração: atravessa cada faceta das regiões conhecidas; um ponto logo do
+    # lado de fora que não caia em região nenhuma revela uma região que a grade
+    # não amostrou (regiões finas perto dos cantos).
+    known = {}
+    pending = list(active_sets)
+    while pending:
+        active = pending.pop()
+        if active in known:
+            continue
+        known[active] = None
+        region = problem.region(list(active))
+        if region is None:
+            continue
+        z0, zx, halfspaces = region
+        polygon, facets = polygon_and_facets(halfspaces)
+        if area(polygon) < 1e-8:
+            continue
+        known[active] = {"area": area(polygon), "facets": facets, "gain": zx[0], "offset": z0[0]}
+        for h, k in facets:
+            for i, p in enumerate(polygon):
+                q = polygon[(i + 1) % len(polygon)]
+                if abs(dot(h, p) - k) > 1e-7 or abs(dot(h, q) - k) > 1e-7:
+                    continue
+                for t in (0.05, 0.25, 0.5, 0.75, 0.95):
+                    x = [p[c] + t * (q[c] - p[c]) + 1e-6 * h[c] for c in range(2)]
+                    if max(abs(x[0]), abs(x[1])) > 1.0:
+                        continue
+                    if any(r is not None and all(dot(hh, x) <= kk + 1e-12 for hh, kk in r["facets"])
+                           for r in known.values()):
+                        continue
+                    _, found = problem.solve_qp(x)
+                    pending.append(tuple(found))
+    regions = [r for r in known.values() if r is not None]
+    # Regiões maiores primeiro: o caso médio termina antes
+    regions.sort(key=lambda r: -r["area"])
+
+    # Verificação: a tabela reproduz o QP em toda a grade
+    worst = 0.0
+    for x, u in samples:
+        region = evaluate_table(regions, x)
+        law = region["offset"] + region["gain"][0] * x[0] + region["gain"][1] * x[1]
+        worst = max(worst, abs(law - u))
+    checks = sum(len(r["facets"]) for r in regions)
+    coverage = sum(r["area"] for r in regions) / area(BOX)
+    print("mpc: %d regiões, %d semiplanos, cobertura %.6f, erro máx. da lei na grade %.2e" %
+          (len(regions), checks, coverage, worst), file=sys.stderr)
+    if worst > 1e-6 or coverage < 1.0 - 1e-6:
+        print("mpc: tabela não cobre o QP; aumente --grid", file=sys.stderr)
+        return 1
+
+    limit16 = (1 << 15) - 1
+    limit32 = (1 << 31) - 1
+    # |h.x| < 2^30 dentro da caixa: k além disso seria redundante (ou vazio), e
+    # o limite mantém h.x - k dentro de int32 no dispositivo
+    limit_k = 1 << 30
+    largest = max(max(abs(r["gain"][0]), abs(r["gain"][1])) for r in regions)
+    if largest * (1 << Q_GAIN) > limit32:
+        print("mpc: ganho %.1f não cabe em Q%d" % (largest, Q_GAIN), file=sys.stderr)
+        return 1
+    planes = []
+    entries = []
+    for region in regions:
+        first = len(planes)
+        for h, k in region["facets"]:
+            planes.append((fixed(h[0], Q_PLANE, limit16), fixed(h[1], Q_PLANE, limit16),
+                           fixed(k, Q_STATE + Q_PLANE, limit_k)))
+        entries.append((first, len(planes) - first, fixed(region["gain"][0], Q_GAIN, limit32),
+                        fixed(region["gain"][1], Q_GAIN, limit32),
+                        fixed(region["offset"], Q_STATE, limit32)))
+
+    with open(args.out, "w", encoding="utf-8") as out:
+        out.write("#pragma once\n\n")
+        out.write("// Gerado por tools/mpc_generate.py -- não editar.\n")
+        out.write("// %s\n" % " ".join(["python3", "tools/mpc_generate.py"] + sys.argv[1:]))
+        out.write("//\n")
+        out.write("// Horizonte %s s; pesos qe=%g qv=%g r=%g terminal=%g; grade %dx%d.\n" %
+                  (args.blocks, args.qe, args.qv, args.r, args.terminal, args.grid, args.grid))
+        out.write("// %d regiões, %d semiplanos.\n\n" % (len(regions), checks))
+        out.write('#include "control/explicit_mpc.h"\n\n')
+        out.write("namespace control {\n\n")
+        out.write("constexpr MpcHalfspace kMpcHalfspaces[] = {\n")
+        for h1, h2, k in planes:
+            out.write("    {%d, %d, %d},\n" % (h1, h2, k))
+        out.write("};\n\n")
+        out.write("constexpr MpcRegion kMpcRegions[] = {\n")
+        for first, count, ge, gv, off in entries:
+            out.write("    {%d, %d, %d, %d, %d},\n" % (first, count, ge, gv, off))
+        out.write("};\n\n")
+        out.write("constexpr MpcTable kMpcTable = {\n")
+        out.write("    kMpcHalfspaces,\n")
+        out.write("    sizeof(kMpcHalfspaces) / sizeof(kMpcHalfspaces[0]),\n")
+        out.write("    kMpcRegions,\n")
+        out.write("    sizeof(kMpcRegions) / sizeof(kMpcRegions[0]),\n")
+        out.write("    %.1ff,  // positionRange (passos)\n" % args.erange)
+        out.write("    %.1ff,  // velocityLimit (passos/s)\n" % args.vmax)
+        out.write("    %.1ff,  // accelLimit (passos/s²)\n" % args.amax)
+        out.write("};\n\n")
+        out.write("}  // namespace control\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())